@@ -102,71 +102,114 @@
 
 /*-----------------------------------------------------------*/
 
-    BaseType_t xCoRoutineCreate( crCOROUTINE_CODE pxCoRoutineCode,
-                                 UBaseType_t uxPriority,
-                                 UBaseType_t uxIndex )
+    static void prvInitialiseNewCoRoutine( CRCB_t * pxCoRoutine,
+                                           crCOROUTINE_CODE pxCoRoutineCode,
+                                           UBaseType_t uxPriority,
+                                           UBaseType_t uxIndex )
     {
-        BaseType_t xReturn;
-        CRCB_t * pxCoRoutine;
+        /* If pxCurrentCoRoutine is NULL then this is the first co-routine to
+        * be created and the co-routine data structures need initialising. */
+        if( pxCurrentCoRoutine == NULL )
+        {
+            pxCurrentCoRoutine = pxCoRoutine;
+            prvInitialiseCoRoutineLists();
+        }
 
-        traceENTER_xCoRoutineCreate( pxCoRoutineCode, uxPriority, uxIndex );
+        /* Check the priority is within limits. */
+        if( uxPriority >= configMAX_CO_ROUTINE_PRIORITIES )
+        {
+            uxPriority = configMAX_CO_ROUTINE_PRIORITIES - 1;
+        }
 
-        /* Allocate the memory that will store the co-routine control block. */
-        /* MISRA Ref 11.5.1 [Malloc memory assignment] */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-        /* coverity[misra_c_2012_rule_11_5_violation] */
-        pxCoRoutine = ( CRCB_t * ) pvPortMalloc( sizeof( CRCB_t ) );
+        /* Fill out the co-routine control block from the function parameters. */
+        pxCoRoutine->uxState = corINITIAL_STATE;
+        pxCoRoutine->uxPriority = uxPriority;
+        pxCoRoutine->uxIndex = uxIndex;
+        pxCoRoutine->pxCoRoutineFunction = pxCoRoutineCode;
 
-        if( pxCoRoutine )
+        /* Initialise all the other co-routine control block parameters. */
+        vListInitialiseItem( &( pxCoRoutine->xGenericListItem ) );
+        vListInitialiseItem( &( pxCoRoutine->xEventListItem ) );
+
+        /* Set the co-routine control block as a link back from the ListItem_t.
+         * This is so we can get back to the containing CRCB from a generic item
+         * in a list. */
+        listSET_LIST_ITEM_OWNER( &( pxCoRoutine->xGenericListItem ), pxCoRoutine );
+        listSET_LIST_ITEM_OWNER( &( pxCoRoutine->xEventListItem ), pxCoRoutine );
+
+        /* Event lists are always in priority order. */
+        listSET_LIST_ITEM_VALUE( &( pxCoRoutine->xEventListItem ), ( ( TickType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( TickType_t ) uxPriority ) );
+
+        /* Now the co-routine has been initialised it can be added to the ready
+         * list at the correct priority. */
+        prvAddCoRoutineToReadyQueue( pxCoRoutine );
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        BaseType_t xCoRoutineCreate( crCOROUTINE_CODE pxCoRoutineCode,
+                                     UBaseType_t uxPriority,
+                                     UBaseType_t uxIndex )
         {
-            /* If pxCurrentCoRoutine is NULL then this is the first co-routine to
-            * be created and the co-routine data structures need initialising. */
-            if( pxCurrentCoRoutine == NULL )
+            BaseType_t xReturn;
+            CRCB_t * pxCoRoutine;
+
+            traceENTER_xCoRoutineCreate( pxCoRoutineCode, uxPriority, uxIndex );
+
+            /* Allocate the memory that will store the co-routine control block. */
+            /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pxCoRoutine = ( CRCB_t * ) pvPortMalloc( sizeof( CRCB_t ) );
+
+            if( pxCoRoutine )
             {
-                pxCurrentCoRoutine = pxCoRoutine;
-                prvInitialiseCoRoutineLists();
+                prvInitialiseNewCoRoutine( pxCoRoutine, pxCoRoutineCode, uxPriority, uxIndex );
+                xReturn = pdPASS;
             }
-
-            /* Check the priority is within limits. */
-            if( uxPriority >= configMAX_CO_ROUTINE_PRIORITIES )
+            else
             {
-                uxPriority = configMAX_CO_ROUTINE_PRIORITIES - 1;
+                xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
             }
 
-            /* Fill out the co-routine control block from the function parameters. */
-            pxCoRoutine->uxState = corINITIAL_STATE;
-            pxCoRoutine->uxPriority = uxPriority;
-            pxCoRoutine->uxIndex = uxIndex;
-            pxCoRoutine->pxCoRoutineFunction = pxCoRoutineCode;
-
-            /* Initialise all the other co-routine control block parameters. */
-            vListInitialiseItem( &( pxCoRoutine->xGenericListItem ) );
-            vListInitialiseItem( &( pxCoRoutine->xEventListItem ) );
+            traceRETURN_xCoRoutineCreate( xReturn );
 
-            /* Set the co-routine control block as a link back from the ListItem_t.
-             * This is so we can get back to the containing CRCB from a generic item
-             * in a list. */
-            listSET_LIST_ITEM_OWNER( &( pxCoRoutine->xGenericListItem ), pxCoRoutine );
-            listSET_LIST_ITEM_OWNER( &( pxCoRoutine->xEventListItem ), pxCoRoutine );
+            return xReturn;
+        }
 
-            /* Event lists are always in priority order. */
-            listSET_LIST_ITEM_VALUE( &( pxCoRoutine->xEventListItem ), ( ( TickType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( TickType_t ) uxPriority ) );
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
 
-            /* Now the co-routine has been initialised it can be added to the ready
-             * list at the correct priority. */
-            prvAddCoRoutineToReadyQueue( pxCoRoutine );
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
 
-            xReturn = pdPASS;
-        }
-        else
+        BaseType_t xCoRoutineCreateStatic( crCOROUTINE_CODE pxCoRoutineCode,
+                                           UBaseType_t uxPriority,
+                                           UBaseType_t uxIndex,
+                                           CRCB_t * pxCoRoutineBuffer )
         {
-            xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
-        }
+            BaseType_t xReturn;
 
-        traceRETURN_xCoRoutineCreate( xReturn );
+            traceENTER_xCoRoutineCreateStatic( pxCoRoutineCode, uxPriority, uxIndex, pxCoRoutineBuffer );
 
-        return xReturn;
-    }
+            configASSERT( pxCoRoutineBuffer != NULL );
+
+            if( pxCoRoutineBuffer != NULL )
+            {
+                prvInitialiseNewCoRoutine( pxCoRoutineBuffer, pxCoRoutineCode, uxPriority, uxIndex );
+                xReturn = pdPASS;
+            }
+            else
+            {
+                xReturn = pdFAIL;
+            }
+
+            traceRETURN_xCoRoutineCreateStatic( xReturn );
+
+            return xReturn;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
     void vCoRoutineAddToDelayedList( TickType_t xTicksToDelay,
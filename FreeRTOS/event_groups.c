@@ -63,6 +63,11 @@
         #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
             uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
         #endif
+
+        #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+            EventBits_t uxBitsSetWhileLocked; /**< Bits set by interrupts while a task had the event group locked, set by that task when it unlocks it. */
+            volatile uint8_t ucLocked;        /**< Nonzero while a task works on the event group with the scheduler suspended, so interrupts leave the bits and the list alone. */
+        #endif
     } EventGroup_t;
 
 /*-----------------------------------------------------------*/
@@ -79,6 +84,32 @@
                                             const EventBits_t uxBitsToWaitFor,
                                             const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Set uxBitsToSet and unblock every waiting task whose wait condition is then
+ * met, clearing the bits of those that asked for it.  With xFromISR pdFALSE it
+ * must be called with the scheduler suspended, with xFromISR pdTRUE from a
+ * critical section, from a task or an interrupt.  Returns pdTRUE if a task of
+ * higher priority than the running one was unblocked from a critical section.
+ */
+    static BaseType_t prvSetBitsAndUnblock( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsToSet,
+                                            const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * While a task works on an event group with the scheduler suspended it keeps
+ * the event group locked, so xEventGroupSetBitsFromISRDirect() only notes the
+ * bits it sets instead of changing the bits and the list under the task.
+ * Unlocking sets the bits noted.  Both are called with the scheduler
+ * suspended, and may nest.
+ */
+    #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+        #define prvLockEventGroup( pxEventBits )    ( ( pxEventBits )->ucLocked++ )
+        static void prvUnlockEventGroup( EventGroup_t * pxEventBits ) PRIVILEGED_FUNCTION;
+    #else
+        #define prvLockEventGroup( pxEventBits )
+        #define prvUnlockEventGroup( pxEventBits )
+    #endif
+
 /*-----------------------------------------------------------*/
 
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -113,6 +144,13 @@
                 pxEventBits->uxEventBits = 0;
                 vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+                #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+                {
+                    pxEventBits->uxBitsSetWhileLocked = 0;
+                    pxEventBits->ucLocked = 0U;
+                }
+                #endif
+
                 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
                 {
                     /* Both static and dynamic allocation can be used, so note that
@@ -158,6 +196,13 @@
                 pxEventBits->uxEventBits = 0;
                 vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+                #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+                {
+                    pxEventBits->uxBitsSetWhileLocked = 0;
+                    pxEventBits->ucLocked = 0U;
+                }
+                #endif
+
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
                     /* Both static and dynamic allocation can be used, so note this
@@ -203,6 +248,7 @@
         #endif
 
         vTaskSuspendAll();
+        prvLockEventGroup( pxEventBits );
         {
             uxOriginalBitValue = pxEventBits->uxEventBits;
 
@@ -245,6 +291,7 @@
                 }
             }
         }
+        prvUnlockEventGroup( pxEventBits );
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -334,6 +381,7 @@
         #endif
 
         vTaskSuspendAll();
+        prvLockEventGroup( pxEventBits );
         {
             const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -401,6 +449,7 @@
                 traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
             }
         }
+        prvUnlockEventGroup( pxEventBits );
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -547,13 +596,8 @@
     EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
                                     const EventBits_t uxBitsToSet )
     {
-        ListItem_t * pxListItem;
-        ListItem_t * pxNext;
-        ListItem_t const * pxListEnd;
-        List_t const * pxList;
-        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits, uxReturnBits;
+        EventBits_t uxReturnBits;
         EventGroup_t * pxEventBits = xEventGroup;
-        BaseType_t xMatchFound = pdFALSE;
 
         traceENTER_xEventGroupSetBits( xEventGroup, uxBitsToSet );
 
@@ -562,83 +606,17 @@
         configASSERT( xEventGroup );
         configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-        pxList = &( pxEventBits->xTasksWaitingForBits );
-        pxListEnd = listGET_END_MARKER( pxList );
         vTaskSuspendAll();
+        prvLockEventGroup( pxEventBits );
         {
             traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-            pxListItem = listGET_HEAD_ENTRY( pxList );
-
-            /* Set the bits. */
-            pxEventBits->uxEventBits |= uxBitsToSet;
-
-            /* See if the new bit value should unblock any tasks. */
-            while( pxListItem != pxListEnd )
-            {
-                pxNext = listGET_NEXT( pxListItem );
-                uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-                xMatchFound = pdFALSE;
-
-                /* Split the bits waited for from the control bits. */
-                uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-                uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-                if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-                {
-                    /* Just looking for single bit being set. */
-                    if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-                    {
-                        xMatchFound = pdTRUE;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-                {
-                    /* All bits are set. */
-                    xMatchFound = pdTRUE;
-                }
-                else
-                {
-                    /* Need all bits to be set, but not all the bits were set. */
-                }
-
-                if( xMatchFound != pdFALSE )
-                {
-                    /* The bits match.  Should the bits be cleared on exit? */
-                    if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
-                    {
-                        uxBitsToClear |= uxBitsWaitedFor;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* Store the actual event flag value in the task's event list
-                     * item before removing the task from the event list.  The
-                     * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-                     * that is was unblocked due to its required bits matching, rather
-                     * than because it timed out. */
-                    vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
-                }
-
-                /* Move onto the next list item.  Note pxListItem->pxNext is not
-                 * used here as the list item may have been removed from the event list
-                 * and inserted into the ready/pending reading list. */
-                pxListItem = pxNext;
-            }
-
-            /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
-             * bit was set in the control word. */
-            pxEventBits->uxEventBits &= ~uxBitsToClear;
-
-            /* Snapshot resulting bits. */
-            uxReturnBits = pxEventBits->uxEventBits;
+            ( void ) prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, pdFALSE );
         }
+        prvUnlockEventGroup( pxEventBits );
+
+        /* Snapshot resulting bits. */
+        uxReturnBits = pxEventBits->uxEventBits;
         ( void ) xTaskResumeAll();
 
         traceRETURN_xEventGroupSetBits( uxReturnBits );
@@ -659,6 +637,11 @@
         pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 
         vTaskSuspendAll();
+
+        /* Locked and never unlocked, on purpose: an interrupt that still sets
+         * bits in the deleted event group only records them, and never walks
+         * the list of a group that may be freed or reused. */
+        prvLockEventGroup( pxEventBits );
         {
             traceEVENT_GROUP_DELETE( xEventGroup );
 
@@ -812,6 +795,157 @@
     }
 /*-----------------------------------------------------------*/
 
+    static BaseType_t prvSetBitsAndUnblock( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsToSet,
+                                            const BaseType_t xFromISR )
+    {
+        ListItem_t * pxListItem;
+        ListItem_t * pxNext;
+        ListItem_t const * pxListEnd;
+        List_t const * pxList;
+        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+        BaseType_t xMatchFound = pdFALSE;
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        /* Unused when configEVENT_GROUP_ISR_MAX_WAITERS is 0. */
+        ( void ) xFromISR;
+
+        pxList = &( pxEventBits->xTasksWaitingForBits );
+        pxListEnd = listGET_END_MARKER( pxList );
+        pxListItem = listGET_HEAD_ENTRY( pxList );
+
+        /* Set the bits. */
+        pxEventBits->uxEventBits |= uxBitsToSet;
+
+        /* See if the new bit value should unblock any tasks. */
+        while( pxListItem != pxListEnd )
+        {
+            pxNext = listGET_NEXT( pxListItem );
+            uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+            xMatchFound = pdFALSE;
+
+            /* Split the bits waited for from the control bits. */
+            uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+            uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+            if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+            {
+                /* Just looking for single bit being set. */
+                if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+                {
+                    xMatchFound = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+            {
+                /* All bits are set. */
+                xMatchFound = pdTRUE;
+            }
+            else
+            {
+                /* Need all bits to be set, but not all the bits were set. */
+            }
+
+            if( xMatchFound != pdFALSE )
+            {
+                /* The bits match.  Should the bits be cleared on exit? */
+                if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                {
+                    uxBitsToClear |= uxBitsWaitedFor;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Store the actual event flag value in the task's event list
+                 * item before removing the task from the event list.  The
+                 * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+                 * that is was unblocked due to its required bits matching, rather
+                 * than because it timed out. */
+                #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+                {
+                    if( xFromISR != pdFALSE )
+                    {
+                        if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+                        {
+                            xHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+                    }
+                }
+                #else
+                {
+                    vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+                }
+                #endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+            }
+
+            /* Move onto the next list item.  Note pxListItem->pxNext is not
+             * used here as the list item may have been removed from the event list
+             * and inserted into the ready/pending reading list. */
+            pxListItem = pxNext;
+        }
+
+        /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+         * bit was set in the control word. */
+        pxEventBits->uxEventBits &= ~uxBitsToClear;
+
+        return xHigherPriorityTaskWoken;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+        static void prvUnlockEventGroup( EventGroup_t * pxEventBits )
+        {
+            EventBits_t uxBitsToSet;
+
+            /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
+            for( ; ; )
+            {
+                taskENTER_CRITICAL();
+                {
+                    uxBitsToSet = pxEventBits->uxBitsSetWhileLocked;
+                    pxEventBits->uxBitsSetWhileLocked = 0;
+
+                    /* Only unlocked once nothing is left to set, in the same
+                     * critical section, so no bits are missed. */
+                    if( uxBitsToSet == ( EventBits_t ) 0 )
+                    {
+                        pxEventBits->ucLocked--;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                if( uxBitsToSet == ( EventBits_t ) 0 )
+                {
+                    break;
+                }
+
+                /* Still locked, so this walk has the list to itself. */
+                ( void ) prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, pdFALSE );
+            }
+        }
+
+    #endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
     #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
@@ -833,6 +967,75 @@
     #endif /* if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+    #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+        BaseType_t xEventGroupSetBitsFromISRDirect( EventGroupHandle_t xEventGroup,
+                                                    const EventBits_t uxBitsToSet,
+                                                    BaseType_t * pxHigherPriorityTaskWoken )
+        {
+            EventGroup_t * pxEventBits = xEventGroup;
+            UBaseType_t uxSavedInterruptStatus;
+            BaseType_t xReturn = pdPASS;
+
+            traceENTER_xEventGroupSetBitsFromISRDirect( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken );
+
+            configASSERT( xEventGroup );
+            configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+            /* See xQueueGenericSendFromISR() for why this is here. */
+            portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+            /* MISRA Ref 4.7.1 [Return value shall be checked] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+            /* coverity[misra_c_2012_directive_4_7_violation] */
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                if( pxEventBits->ucLocked != 0U )
+                {
+                    /* A task is working on the event group, leave the bits
+                     * for it to set when it unlocks the group. */
+                    traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+                    pxEventBits->uxBitsSetWhileLocked |= uxBitsToSet;
+                }
+                else if( listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) ) <= ( UBaseType_t ) configEVENT_GROUP_ISR_MAX_WAITERS )
+                {
+                    /* Few enough waiting tasks to go through all of them in
+                     * this critical section. */
+                    traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+                    if( prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, pdTRUE ) != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* Too many waiting tasks to go through with interrupts
+                     * masked.  Nothing is set. */
+                    xReturn = pdFAIL;
+                }
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+            traceRETURN_xEventGroupSetBitsFromISRDirect( xReturn );
+
+            return xReturn;
+        }
+
+    #endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
     #if ( configUSE_TRACE_FACILITY == 1 )
 
         UBaseType_t uxEventGroupGetNumber( void * xEventGroup )
@@ -0,0 +1,462 @@
+/*
+ * File:   fast_mutex.c
+ *
+ * Fast mutexes, see fast_mutex.h.  The whole state is one word, the holding
+ * task's handle, with its lowest bit set while tasks are waiting.  A task
+ * handle is word aligned so that bit is otherwise always clear.  Taking a free
+ * mutex no other task waits for is a compare and swap of that word from NULL
+ * to the calling task, giving it back is the reverse, and only a take that
+ * finds the mutex held or a give that finds the waiting bit set goes near the
+ * wait list.
+ *
+ * Priority inheritance is the kernel's own, xTaskPriorityInherit() and
+ * xTaskPriorityDisinherit() as used by queue.c for mutexes, so fast mutexes
+ * and mutex type semaphores can be held together.
+ */
+
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "atomic.h"
+#include "queue.h"
+#include "fast_mutex.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+ * to include fast mutexes.  This #if is closed at the very bottom of this
+ * file. */
+#if ( configUSE_FAST_MUTEXES == 1 )
+
+/* Set in pvOwner while the wait list is not empty. */
+    #define fmWAITERS_BIT    ( ( portPOINTER_SIZE_TYPE ) 1U )
+
+/* The task holding the mutex, without the waiting bit. */
+    #define fmHOLDER( pvOwner )    ( ( TaskHandle_t ) ( ( portPOINTER_SIZE_TYPE ) ( pvOwner ) & ~fmWAITERS_BIT ) )
+
+    typedef struct FastMutexDef_t
+    {
+        void * volatile pvOwner; /**< The holding task, or NULL, with fmWAITERS_BIT set while xTasksWaiting is not empty. */
+        List_t xTasksWaiting;    /**< Tasks waiting to take the mutex, highest priority first. */
+
+        #if ( configUSE_MUTEX_STATS == 1 )
+            MutexStats_t xStats; /**< Contention figures, kept by the vQueueMutexStats functions of queue.c. */
+        #endif
+
+        #if ( configUSE_TRACE_FACILITY == 1 )
+            UBaseType_t uxMutexNumber; /**< Set by the application for trace tools, as uxQueueNumber. */
+        #endif
+    } FastMutex_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The priority the holder of a mutex that a task stopped waiting for should
+ * keep on its account: that of the highest priority task still waiting.
+ * Called from a critical section.
+ */
+    static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const FastMutex_t * const pxMutex ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    FastMutexHandle_t xFastMutexCreateStatic( StaticFastMutex_t * pxMutexBuffer )
+    {
+        FastMutex_t * pxMutex;
+
+        traceENTER_xFastMutexCreateStatic( pxMutexBuffer );
+
+        configASSERT( pxMutexBuffer );
+
+        #if ( configASSERT_DEFINED == 1 )
+        {
+            /* Sanity check that the size of the structure used to declare a
+             * variable of type StaticFastMutex_t equals the size of the real
+             * fast mutex structure. */
+            volatile size_t xSize = sizeof( StaticFastMutex_t );
+            configASSERT( xSize == sizeof( FastMutex_t ) );
+        }
+        #endif /* configASSERT_DEFINED */
+
+        /* The user has provided a statically allocated fast mutex - use it. */
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        pxMutex = ( FastMutex_t * ) pxMutexBuffer;
+
+        pxMutex->pvOwner = NULL;
+        vListInitialise( &( pxMutex->xTasksWaiting ) );
+
+        #if ( configUSE_MUTEX_STATS == 1 )
+        {
+            ( void ) memset( &( pxMutex->xStats ), 0x00, sizeof( pxMutex->xStats ) );
+        }
+        #endif
+
+        #if ( configUSE_TRACE_FACILITY == 1 )
+        {
+            pxMutex->uxMutexNumber = 0U;
+        }
+        #endif
+
+        traceRETURN_xFastMutexCreateStatic( pxMutex );
+
+        return pxMutex;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xFastMutexTake( FastMutexHandle_t xMutex,
+                               TickType_t xTicksToWait )
+    {
+        FastMutex_t * const pxMutex = xMutex;
+        TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+        TaskHandle_t xHolder;
+        TimeOut_t xTimeOut;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xInheritanceOccurred = pdFALSE;
+        BaseType_t xReturn;
+
+        #if ( configUSE_MUTEX_STATS == 1 )
+            uint32_t ulWaitStart = 0U;
+            TaskHandle_t xHolderAtWait = NULL;
+        #endif
+
+        traceENTER_xFastMutexTake( xMutex, xTicksToWait );
+
+        configASSERT( pxMutex );
+        configASSERT( ( ( portPOINTER_SIZE_TYPE ) xCurrentTask & fmWAITERS_BIT ) == 0U );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0U ) ) );
+        }
+        #endif
+
+        /* Free and nobody waiting, the common case. */
+        if( Atomic_CompareAndSwapPointers_p32( &( pxMutex->pvOwner ), xCurrentTask, NULL ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+        {
+            ( void ) pvTaskIncrementMutexHeldCount();
+
+            #if ( configUSE_MUTEX_STATS == 1 )
+            {
+                taskENTER_CRITICAL();
+                {
+                    vQueueMutexStatsTaken( &( pxMutex->xStats ) );
+                }
+                taskEXIT_CRITICAL();
+            }
+            #endif
+
+            traceFAST_MUTEX_TAKE( pxMutex );
+            traceRETURN_xFastMutexTake( pdPASS );
+
+            return pdPASS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                xHolder = fmHOLDER( pxMutex->pvOwner );
+
+                if( xHolder == NULL )
+                {
+                    /* Free, but with tasks still waiting, as the task just
+                     * unblocked by a give may be beaten to it by one that was
+                     * already running.  Keep the waiting bit. */
+                    pxMutex->pvOwner = ( void * ) ( ( portPOINTER_SIZE_TYPE ) xCurrentTask | ( ( portPOINTER_SIZE_TYPE ) pxMutex->pvOwner & fmWAITERS_BIT ) );
+                    ( void ) pvTaskIncrementMutexHeldCount();
+
+                    #if ( configUSE_MUTEX_STATS == 1 )
+                    {
+                        if( xEntryTimeSet != pdFALSE )
+                        {
+                            vQueueMutexStatsWaited( &( pxMutex->xStats ), ulWaitStart, xHolderAtWait, xInheritanceOccurred );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        vQueueMutexStatsTaken( &( pxMutex->xStats ) );
+                    }
+                    #endif
+
+                    traceFAST_MUTEX_TAKE( pxMutex );
+                    taskEXIT_CRITICAL();
+
+                    xReturn = pdPASS;
+                    break;
+                }
+
+                /* Fast mutexes are not recursive. */
+                configASSERT( xHolder != xCurrentTask );
+
+                if( xTicksToWait != ( TickType_t ) 0 )
+                {
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+
+                        #if ( configUSE_MUTEX_STATS == 1 )
+                        {
+                            ulWaitStart = configMUTEX_STATS_TIME();
+                            xHolderAtWait = xHolder;
+                        }
+                        #endif
+                    }
+                    else
+                    {
+                        /* Sets xTicksToWait to what is left, 0 if none. */
+                        ( void ) xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait );
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* Timed out.  The holder no longer needs the priority it
+                     * inherited from this task, but may still need that of
+                     * another task waiting. */
+                    if( xInheritanceOccurred != pdFALSE )
+                    {
+                        vTaskPriorityDisinheritAfterTimeout( xHolder, prvGetDisinheritPriorityAfterTimeout( pxMutex ) );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    #if ( configUSE_MUTEX_STATS == 1 )
+                    {
+                        if( xEntryTimeSet != pdFALSE )
+                        {
+                            vQueueMutexStatsWaited( &( pxMutex->xStats ), ulWaitStart, xHolderAtWait, xInheritanceOccurred );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif
+
+                    traceFAST_MUTEX_TAKE_FAILED( pxMutex );
+                    taskEXIT_CRITICAL();
+
+                    xReturn = pdFAIL;
+                    break;
+                }
+
+                traceBLOCKING_ON_FAST_MUTEX( pxMutex );
+                pxMutex->pvOwner = ( void * ) ( ( portPOINTER_SIZE_TYPE ) pxMutex->pvOwner | fmWAITERS_BIT );
+                xInheritanceOccurred |= xTaskPriorityInherit( xHolder );
+                vTaskPlaceOnEventList( &( pxMutex->xTasksWaiting ), xTicksToWait );
+            }
+            taskEXIT_CRITICAL();
+
+            /* Unblocked by a give, or the time ran out.  Either way try
+             * again. */
+            portYIELD_WITHIN_API();
+        }
+
+        traceRETURN_xFastMutexTake( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xFastMutexGive( FastMutexHandle_t xMutex )
+    {
+        FastMutex_t * const pxMutex = xMutex;
+        TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+        BaseType_t xYieldRequired = pdFALSE;
+        BaseType_t xReturn = pdPASS;
+
+        traceENTER_xFastMutexGive( xMutex );
+
+        configASSERT( pxMutex );
+
+        /* Taken from pxMutex->pvOwner and given back to NULL in the same
+         * critical section as the disinherit, which has to be in one. */
+        taskENTER_CRITICAL();
+        {
+            if( pxMutex->pvOwner == ( void * ) xCurrentTask )
+            {
+                /* Nobody waiting. */
+                pxMutex->pvOwner = NULL;
+            }
+            else if( fmHOLDER( pxMutex->pvOwner ) == xCurrentTask )
+            {
+                /* Unblock the highest priority waiting task to take it.  The
+                 * waiting bit stays set for any others. */
+                if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaiting ) ) == pdFALSE )
+                {
+                    xYieldRequired = xTaskRemoveFromEventList( &( pxMutex->xTasksWaiting ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaiting ) ) == pdFALSE )
+                {
+                    pxMutex->pvOwner = ( void * ) fmWAITERS_BIT;
+                }
+                else
+                {
+                    pxMutex->pvOwner = NULL;
+                }
+            }
+            else
+            {
+                /* Only the holder may give the mutex. */
+                xReturn = pdFAIL;
+            }
+
+            if( xReturn == pdPASS )
+            {
+                traceFAST_MUTEX_GIVE( pxMutex );
+
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    vQueueMutexStatsGiven( &( pxMutex->xStats ) );
+                }
+                #endif
+
+                /* Back to the task's own priority if it inherited one and
+                 * holds no other mutex. */
+                if( xTaskPriorityDisinherit( xCurrentTask ) != pdFALSE )
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xYieldRequired != pdFALSE )
+        {
+            portYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_xFastMutexGive( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    TaskHandle_t xFastMutexGetHolder( FastMutexHandle_t xMutex )
+    {
+        const FastMutex_t * const pxMutex = xMutex;
+        TaskHandle_t xReturn;
+
+        traceENTER_xFastMutexGetHolder( xMutex );
+
+        configASSERT( pxMutex );
+
+        /* One word, read in one go. */
+        xReturn = fmHOLDER( pxMutex->pvOwner );
+
+        traceRETURN_xFastMutexGetHolder( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_MUTEX_STATS == 1 )
+
+        void vFastMutexGetStats( FastMutexHandle_t xMutex,
+                                 MutexStats_t * pxStats )
+        {
+            const FastMutex_t * const pxMutex = xMutex;
+
+            traceENTER_vFastMutexGetStats( xMutex, pxStats );
+
+            configASSERT( pxMutex );
+            configASSERT( pxStats );
+
+            taskENTER_CRITICAL();
+            {
+                *pxStats = pxMutex->xStats;
+            }
+            taskEXIT_CRITICAL();
+
+            traceRETURN_vFastMutexGetStats();
+        }
+
+    #endif /* configUSE_MUTEX_STATS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TRACE_FACILITY == 1 )
+
+        UBaseType_t uxFastMutexGetMutexNumber( FastMutexHandle_t xMutex )
+        {
+            traceENTER_uxFastMutexGetMutexNumber( xMutex );
+
+            traceRETURN_uxFastMutexGetMutexNumber( ( ( FastMutex_t * ) xMutex )->uxMutexNumber );
+
+            return ( ( FastMutex_t * ) xMutex )->uxMutexNumber;
+        }
+
+    #endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TRACE_FACILITY == 1 )
+
+        void vFastMutexSetMutexNumber( FastMutexHandle_t xMutex,
+                                       UBaseType_t uxMutexNumber )
+        {
+            traceENTER_vFastMutexSetMutexNumber( xMutex, uxMutexNumber );
+
+            ( ( FastMutex_t * ) xMutex )->uxMutexNumber = uxMutexNumber;
+
+            traceRETURN_vFastMutexSetMutexNumber();
+        }
+
+    #endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const FastMutex_t * const pxMutex )
+    {
+        UBaseType_t uxHighestPriorityOfWaitingTasks;
+
+        if( listCURRENT_LIST_LENGTH( &( pxMutex->xTasksWaiting ) ) > 0U )
+        {
+            uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) ( ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxMutex->xTasksWaiting ) ) );
+        }
+        else
+        {
+            uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+        }
+
+        return uxHighestPriorityOfWaitingTasks;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_FAST_MUTEXES */
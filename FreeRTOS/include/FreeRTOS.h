@@ -699,6 +699,27 @@
     #define traceBLOCKING_ON_QUEUE_PEEK( pxQueue )
 #endif
 
+#ifndef traceFAST_MUTEX_TAKE
+    /* A fast mutex was taken, at once or after waiting.  pxMutex is the
+     * FastMutex_t, pxCurrentTCB the task that took it. */
+    #define traceFAST_MUTEX_TAKE( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_TAKE_FAILED
+    /* A take of a fast mutex ran out of time. */
+    #define traceFAST_MUTEX_TAKE_FAILED( pxMutex )
+#endif
+
+#ifndef traceBLOCKING_ON_FAST_MUTEX
+    /* The calling task is about to block because the fast mutex is held. */
+    #define traceBLOCKING_ON_FAST_MUTEX( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_GIVE
+    /* A fast mutex was given back by the task holding it. */
+    #define traceFAST_MUTEX_GIVE( pxMutex )
+#endif
+
 #ifndef traceBLOCKING_ON_QUEUE_SEND
 
 /* Task is about to block because it cannot write to a
@@ -1158,6 +1179,14 @@
     #define traceRETURN_xEventGroupSetBitsFromISR( xReturn )
 #endif
 
+#ifndef traceENTER_xEventGroupSetBitsFromISRDirect
+    #define traceENTER_xEventGroupSetBitsFromISRDirect( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xEventGroupSetBitsFromISRDirect
+    #define traceRETURN_xEventGroupSetBitsFromISRDirect( xReturn )
+#endif
+
 #ifndef traceENTER_uxEventGroupGetNumber
     #define traceENTER_uxEventGroupGetNumber( xEventGroup )
 #endif
@@ -1334,6 +1363,38 @@
     #define traceRETURN_xQueuePeekFromISR( xReturn )
 #endif
 
+#ifndef traceENTER_xQueueSendMultiple
+    #define traceENTER_xQueueSendMultiple( xQueue, pvItems, uxCount, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueSendMultiple
+    #define traceRETURN_xQueueSendMultiple( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueReceiveMultiple
+    #define traceENTER_xQueueReceiveMultiple( xQueue, pvBuffer, uxCount, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueReceiveMultiple
+    #define traceRETURN_xQueueReceiveMultiple( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueSendMultipleFromISR
+    #define traceENTER_xQueueSendMultipleFromISR( xQueue, pvItems, uxCount, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xQueueSendMultipleFromISR
+    #define traceRETURN_xQueueSendMultipleFromISR( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueReceiveMultipleFromISR
+    #define traceENTER_xQueueReceiveMultipleFromISR( xQueue, pvBuffer, uxCount, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xQueueReceiveMultipleFromISR
+    #define traceRETURN_xQueueReceiveMultipleFromISR( xReturn )
+#endif
+
 #ifndef traceENTER_uxQueueMessagesWaiting
     #define traceENTER_uxQueueMessagesWaiting( xQueue )
 #endif
@@ -1782,6 +1843,30 @@
     #define traceRETURN_vTaskDelay()
 #endif
 
+#ifndef traceENTER_vTaskDelayWithSlack
+    #define traceENTER_vTaskDelayWithSlack( xTicksToDelay, xSlack )
+#endif
+
+#ifndef traceRETURN_vTaskDelayWithSlack
+    #define traceRETURN_vTaskDelayWithSlack()
+#endif
+
+#ifndef traceENTER_xTaskDelayUntilWithSlack
+    #define traceENTER_xTaskDelayUntilWithSlack( pxPreviousWakeTime, xTimeIncrement, xSlack )
+#endif
+
+#ifndef traceRETURN_xTaskDelayUntilWithSlack
+    #define traceRETURN_xTaskDelayUntilWithSlack( xShouldDelay )
+#endif
+
+#ifndef traceENTER_ulTaskGetWakeTicks
+    #define traceENTER_ulTaskGetWakeTicks()
+#endif
+
+#ifndef traceRETURN_ulTaskGetWakeTicks
+    #define traceRETURN_ulTaskGetWakeTicks( ulWakeTicks )
+#endif
+
 #ifndef traceENTER_eTaskGetState
     #define traceENTER_eTaskGetState( xTask )
 #endif
@@ -2106,6 +2191,14 @@
     #define traceRETURN_vTaskRemoveFromUnorderedEventList()
 #endif
 
+#ifndef traceENTER_xTaskRemoveFromUnorderedEventListFromISR
+    #define traceENTER_xTaskRemoveFromUnorderedEventListFromISR( pxEventListItem, xItemValue )
+#endif
+
+#ifndef traceRETURN_xTaskRemoveFromUnorderedEventListFromISR
+    #define traceRETURN_xTaskRemoveFromUnorderedEventListFromISR( xReturn )
+#endif
+
 #ifndef traceENTER_vTaskSetTimeOutState
     #define traceENTER_vTaskSetTimeOutState( pxTimeOut )
 #endif
@@ -2538,6 +2631,118 @@
     #define traceRETURN_xStreamBufferReceiveFromISR( xReceivedLength )
 #endif
 
+#ifndef traceENTER_xStreamBufferSendAcquire
+    #define traceENTER_xStreamBufferSendAcquire( xStreamBuffer, ppucData, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xStreamBufferSendAcquire
+    #define traceRETURN_xStreamBufferSendAcquire( xReturn )
+#endif
+
+#ifndef traceENTER_vStreamBufferSendCommit
+    #define traceENTER_vStreamBufferSendCommit( xStreamBuffer, xDataLengthBytes )
+#endif
+
+#ifndef traceRETURN_vStreamBufferSendCommit
+    #define traceRETURN_vStreamBufferSendCommit()
+#endif
+
+#ifndef traceENTER_vStreamBufferSendCommitFromISR
+    #define traceENTER_vStreamBufferSendCommitFromISR( xStreamBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_vStreamBufferSendCommitFromISR
+    #define traceRETURN_vStreamBufferSendCommitFromISR()
+#endif
+
+#ifndef traceENTER_xStreamBufferReceiveAcquire
+    #define traceENTER_xStreamBufferReceiveAcquire( xStreamBuffer, ppucData, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xStreamBufferReceiveAcquire
+    #define traceRETURN_xStreamBufferReceiveAcquire( xReturn )
+#endif
+
+#ifndef traceENTER_vStreamBufferReceiveCommit
+    #define traceENTER_vStreamBufferReceiveCommit( xStreamBuffer, xDataLengthBytes )
+#endif
+
+#ifndef traceRETURN_vStreamBufferReceiveCommit
+    #define traceRETURN_vStreamBufferReceiveCommit()
+#endif
+
+#ifndef traceENTER_vStreamBufferReceiveCommitFromISR
+    #define traceENTER_vStreamBufferReceiveCommitFromISR( xStreamBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_vStreamBufferReceiveCommitFromISR
+    #define traceRETURN_vStreamBufferReceiveCommitFromISR()
+#endif
+
+#ifndef traceENTER_xFastMutexCreateStatic
+    #define traceENTER_xFastMutexCreateStatic( pxMutexBuffer )
+#endif
+
+#ifndef traceRETURN_xFastMutexCreateStatic
+    #define traceRETURN_xFastMutexCreateStatic( xReturn )
+#endif
+
+#ifndef traceENTER_xFastMutexTake
+    #define traceENTER_xFastMutexTake( xMutex, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xFastMutexTake
+    #define traceRETURN_xFastMutexTake( xReturn )
+#endif
+
+#ifndef traceENTER_xFastMutexGive
+    #define traceENTER_xFastMutexGive( xMutex )
+#endif
+
+#ifndef traceRETURN_xFastMutexGive
+    #define traceRETURN_xFastMutexGive( xReturn )
+#endif
+
+#ifndef traceENTER_xFastMutexGetHolder
+    #define traceENTER_xFastMutexGetHolder( xMutex )
+#endif
+
+#ifndef traceRETURN_xFastMutexGetHolder
+    #define traceRETURN_xFastMutexGetHolder( xReturn )
+#endif
+
+#ifndef traceENTER_vFastMutexGetStats
+    #define traceENTER_vFastMutexGetStats( xMutex, pxStats )
+#endif
+
+#ifndef traceRETURN_vFastMutexGetStats
+    #define traceRETURN_vFastMutexGetStats()
+#endif
+
+#ifndef traceENTER_uxFastMutexGetMutexNumber
+    #define traceENTER_uxFastMutexGetMutexNumber( xMutex )
+#endif
+
+#ifndef traceRETURN_uxFastMutexGetMutexNumber
+    #define traceRETURN_uxFastMutexGetMutexNumber( uxReturn )
+#endif
+
+#ifndef traceENTER_vFastMutexSetMutexNumber
+    #define traceENTER_vFastMutexSetMutexNumber( xMutex, uxMutexNumber )
+#endif
+
+#ifndef traceRETURN_vFastMutexSetMutexNumber
+    #define traceRETURN_vFastMutexSetMutexNumber()
+#endif
+
+#ifndef traceENTER_vQueueGetSemaphoreStats
+    #define traceENTER_vQueueGetSemaphoreStats( xQueue, pxStats )
+#endif
+
+#ifndef traceRETURN_vQueueGetSemaphoreStats
+    #define traceRETURN_vQueueGetSemaphoreStats()
+#endif
+
 #ifndef traceENTER_xStreamBufferIsEmpty
     #define traceENTER_xStreamBufferIsEmpty( xStreamBuffer )
 #endif
@@ -2658,6 +2863,14 @@
     #define traceRETURN_xCoRoutineCreate( xReturn )
 #endif
 
+#ifndef traceENTER_xCoRoutineCreateStatic
+    #define traceENTER_xCoRoutineCreateStatic( pxCoRoutineCode, uxPriority, uxIndex, pxCoRoutineBuffer )
+#endif
+
+#ifndef traceRETURN_xCoRoutineCreateStatic
+    #define traceRETURN_xCoRoutineCreateStatic( xReturn )
+#endif
+
 #ifndef traceENTER_vCoRoutineAddToDelayedList
     #define traceENTER_vCoRoutineAddToDelayedList( xTicksToDelay, pxEventList )
 #endif
@@ -2728,6 +2941,72 @@
     #define configUSE_TICKLESS_IDLE    0
 #endif
 
+#ifndef configUSE_DELAYED_TASK_WHEEL
+    #define configUSE_DELAYED_TASK_WHEEL    0
+#endif
+
+#ifndef configDELAYED_TASK_WHEEL_BITS
+    #define configDELAYED_TASK_WHEEL_BITS    4
+#endif
+
+#if ( configDELAYED_TASK_WHEEL_BITS < 1 ) || ( configDELAYED_TASK_WHEEL_BITS > 8 )
+    #error configDELAYED_TASK_WHEEL_BITS must be between 1 and 8
+#endif
+
+#ifndef configUSE_TASK_DELAY_SLACK
+    #define configUSE_TASK_DELAY_SLACK    0
+#endif
+
+#ifndef configUSE_QUEUE_BATCH
+    #define configUSE_QUEUE_BATCH    0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_ZERO_COPY
+    #define configUSE_STREAM_BUFFER_ZERO_COPY    0
+#endif
+
+#ifndef configUSE_FAST_MUTEXES
+    #define configUSE_FAST_MUTEXES    0
+#endif
+
+#if ( configUSE_FAST_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 )
+    #error configUSE_FAST_MUTEXES needs configUSE_MUTEXES set to 1 for priority inheritance
+#endif
+
+#ifndef configUSE_MUTEX_STATS
+    #define configUSE_MUTEX_STATS    0
+#endif
+
+#if ( configUSE_MUTEX_STATS == 1 ) && ( configUSE_MUTEXES != 1 )
+    #error configUSE_MUTEX_STATS needs configUSE_MUTEXES set to 1
+#endif
+
+/* Times mutex waits and holds for configUSE_MUTEX_STATS, with the run time
+ * stats counter if there is one, else the tick count. */
+#ifndef configMUTEX_STATS_TIME
+    #if ( configGENERATE_RUN_TIME_STATS == 1 ) && defined( portGET_RUN_TIME_COUNTER_VALUE )
+        #define configMUTEX_STATS_TIME()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+    #else
+        #define configMUTEX_STATS_TIME()    ( ( uint32_t ) xTaskGetTickCount() )
+    #endif
+#endif
+
+#ifndef configEVENT_GROUP_ISR_MAX_WAITERS
+    #define configEVENT_GROUP_ISR_MAX_WAITERS    0
+#endif
+
+#ifndef configUSE_TIMER_WHEEL
+    #define configUSE_TIMER_WHEEL    0
+#endif
+
+#ifndef configTIMER_WHEEL_BITS
+    #define configTIMER_WHEEL_BITS    4
+#endif
+
+#if ( configTIMER_WHEEL_BITS < 1 ) || ( configTIMER_WHEEL_BITS > 8 )
+    #error configTIMER_WHEEL_BITS must be between 1 and 8
+#endif
+
 #ifndef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
     #define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( x )
 #endif
@@ -3221,6 +3500,25 @@ typedef struct xSTATIC_TCB
     #endif
 } StaticTask_t;
 
+/*
+ * Contention figures kept for each mutex and semaphore when
+ * configUSE_MUTEX_STATS is 1, read with vSemaphoreGetStats() or
+ * vFastMutexGetStats().  Times are in configMUTEX_STATS_TIME() counts.  A take
+ * that finds a mutex held and blocks counts as contended, whether it then
+ * gets the mutex or times out.
+ */
+typedef struct xMUTEX_STATS
+{
+    uint32_t ulTakes;                             /**< Successful takes. */
+    uint32_t ulContended;                         /**< Takes that had to wait. */
+    uint32_t ulInheritances;                      /**< Contended takes that raised the holder's priority. */
+    uint32_t ulTotalWait;                         /**< Time spent waiting over all contended takes. */
+    uint32_t ulMaxWait;                           /**< Longest wait. */
+    uint32_t ulMaxHold;                           /**< Longest a mutex was held, not kept for semaphores. */
+    struct tskTaskControlBlock * xMaxWaitHolder;  /**< The task holding the mutex when the longest wait began. */
+    uint32_t ulTakenAt;                           /**< When the mutex was last taken, for the hold time. */
+} MutexStats_t;
+
 /*
  * In line with software engineering best practice, especially when supplying a
  * library that is likely to change in future versions, FreeRTOS implements a
@@ -3261,6 +3559,10 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( configUSE_MUTEX_STATS == 1 )
+        MutexStats_t xDummy10;
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -3290,6 +3592,11 @@ typedef struct xSTATIC_EVENT_GROUP
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy4;
     #endif
+
+    #if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+        TickType_t xDummy5;
+        uint8_t ucDummy6;
+    #endif
 } StaticEventGroup_t;
 
 /*
@@ -3350,6 +3657,24 @@ typedef struct xSTATIC_STREAM_BUFFER
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * As StaticEventGroup_t, but for the fast mutexes of fast_mutex.c: the size of
+ * a fast mutex, for xFastMutexCreateStatic(), without its members.
+ */
+typedef struct xSTATIC_FAST_MUTEX
+{
+    void * pvDummy1;
+    StaticList_t xDummy2;
+
+    #if ( configUSE_MUTEX_STATS == 1 )
+        MutexStats_t xDummy3;
+    #endif
+
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        UBaseType_t uxDummy4;
+    #endif
+} StaticFastMutex_t;
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -137,6 +137,31 @@ BaseType_t xCoRoutineCreate( crCOROUTINE_CODE pxCoRoutineCode,
                              UBaseType_t uxPriority,
                              UBaseType_t uxIndex );
 
+/**
+ * croutine. h
+ * @code{c}
+ * BaseType_t xCoRoutineCreateStatic(
+ *                                     crCOROUTINE_CODE pxCoRoutineCode,
+ *                                     UBaseType_t uxPriority,
+ *                                     UBaseType_t uxIndex,
+ *                                     CRCB_t *pxCoRoutineBuffer
+ *                                   );
+ * @endcode
+ *
+ * As xCoRoutineCreate(), but the co-routine control block is supplied by the
+ * application in pxCoRoutineBuffer instead of being allocated from the heap.
+ * The buffer must stay valid for as long as the co-routine exists.
+ *
+ * @return pdPASS if the co-routine was created, otherwise pdFAIL.
+ *
+ * \defgroup xCoRoutineCreateStatic xCoRoutineCreateStatic
+ * \ingroup Tasks
+ */
+BaseType_t xCoRoutineCreateStatic( crCOROUTINE_CODE pxCoRoutineCode,
+                                   UBaseType_t uxPriority,
+                                   UBaseType_t uxIndex,
+                                   CRCB_t * pxCoRoutineBuffer );
+
 
 /**
  * croutine. h
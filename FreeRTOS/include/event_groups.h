@@ -610,6 +610,56 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
                                           BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #endif /* if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
 
+/**
+ * event_groups.h
+ * @code{c}
+ *  BaseType_t xEventGroupSetBitsFromISRDirect( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of xEventGroupSetBitsFromISR() that sets the bits and unblocks the
+ * waiting tasks in the interrupt itself, without the timer task.  To keep the
+ * time interrupts are masked bounded, it only does so while at most
+ * configEVENT_GROUP_ISR_MAX_WAITERS tasks are waiting for bits in the event
+ * group.  If a task is working on the event group at the time, the bits are
+ * left for that task to set once it is done, which it does before the
+ * scheduler is resumed.
+ *
+ * configEVENT_GROUP_ISR_MAX_WAITERS must be set above 0 in FreeRTOSConfig.h
+ * for this function to be available.  Task level calls then lock the event
+ * group while they work on it with the scheduler suspended, as queues are
+ * locked.
+ *
+ * @param xEventGroup The event group in which the bits are to be set.
+ *
+ * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if a task unblocked has a
+ * priority above that of the interrupted task, so a context switch should be
+ * requested before the interrupt exits.  Must be initialised to pdFALSE.
+ *
+ * @return pdPASS if the bits were set or left for the task working on the
+ * event group, pdFAIL if more than configEVENT_GROUP_ISR_MAX_WAITERS tasks were
+ * waiting, in which case nothing was set.
+ *
+ * Example usage:
+ * @code{c}
+ * void vButtonInterruptHandler( void )
+ * {
+ * BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ *
+ *      xEventGroupSetBitsFromISRDirect( xEventGroup, BUTTON_BIT, &xHigherPriorityTaskWoken );
+ *      portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ * }
+ * @endcode
+ * \defgroup xEventGroupSetBitsFromISRDirect xEventGroupSetBitsFromISRDirect
+ * \ingroup EventGroup
+ */
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+    BaseType_t xEventGroupSetBitsFromISRDirect( EventGroupHandle_t xEventGroup,
+                                                const EventBits_t uxBitsToSet,
+                                                BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * event_groups.h
  * @code{c}
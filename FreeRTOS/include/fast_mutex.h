@@ -0,0 +1,166 @@
+/*
+ * File:   fast_mutex.h
+ *
+ * Fast mutexes, a lighter alternative to the mutex type semaphores of
+ * semphr.h for mutexes that are mostly free when they are taken.  A take or
+ * give that finds no other task involved is one compare and swap or one short
+ * critical section, with no queue behind it.  A task that finds the mutex held
+ * waits on a priority ordered list and the holder inherits its priority, as
+ * with xSemaphoreCreateMutex().
+ *
+ * configUSE_FAST_MUTEXES must be set to 1 in FreeRTOSConfig.h for fast mutexes
+ * to be available.
+ */
+
+#ifndef FAST_MUTEX_H
+#define FAST_MUTEX_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include fast_mutex.h"
+#endif
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * fast_mutex.h
+ *
+ * Type by which fast mutexes are referenced.
+ *
+ * \defgroup FastMutexHandle_t FastMutexHandle_t
+ * \ingroup FastMutex
+ */
+struct FastMutexDef_t;
+typedef struct FastMutexDef_t * FastMutexHandle_t;
+
+/**
+ * fast_mutex.h
+ *
+ * @code{c}
+ * FastMutexHandle_t xFastMutexCreateStatic( StaticFastMutex_t * pxMutexBuffer );
+ * @endcode
+ *
+ * Creates a fast mutex in memory the application provides, free to start
+ * with.
+ *
+ * @param pxMutexBuffer Must point to a StaticFastMutex_t, which holds the
+ * mutex for as long as it is used.
+ *
+ * @return The handle of the mutex.
+ *
+ * \defgroup xFastMutexCreateStatic xFastMutexCreateStatic
+ * \ingroup FastMutex
+ */
+FastMutexHandle_t xFastMutexCreateStatic( StaticFastMutex_t * pxMutexBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+ * @code{c}
+ * BaseType_t xFastMutexTake( FastMutexHandle_t xMutex, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Takes a fast mutex, waiting up to xTicksToWait for it if another task holds
+ * it.  While the calling task waits, the holder runs at the calling task's
+ * priority if that is higher than its own.
+ *
+ * Fast mutexes are not recursive, a task must not take one it already holds,
+ * and they must not be used from interrupts.
+ *
+ * @param xMutex The mutex to take.
+ *
+ * @param xTicksToWait The maximum time to wait for the mutex, 0 to return at
+ * once if it is held.
+ *
+ * @return pdPASS if the mutex was taken, pdFAIL if the time ran out first.
+ *
+ * \defgroup xFastMutexTake xFastMutexTake
+ * \ingroup FastMutex
+ */
+BaseType_t xFastMutexTake( FastMutexHandle_t xMutex,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+ * @code{c}
+ * BaseType_t xFastMutexGive( FastMutexHandle_t xMutex );
+ * @endcode
+ *
+ * Gives back a fast mutex the calling task holds.  If tasks are waiting for
+ * it, the highest priority one is unblocked to take it, and the calling task
+ * goes back to its own priority once it holds no more mutexes.
+ *
+ * @param xMutex The mutex to give.
+ *
+ * @return pdPASS, or pdFAIL if the calling task does not hold the mutex.
+ *
+ * \defgroup xFastMutexGive xFastMutexGive
+ * \ingroup FastMutex
+ */
+BaseType_t xFastMutexGive( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+ * @code{c}
+ * TaskHandle_t xFastMutexGetHolder( FastMutexHandle_t xMutex );
+ * @endcode
+ *
+ * @param xMutex The mutex to query.
+ *
+ * @return The task holding the mutex, NULL if it is free.
+ *
+ * \defgroup xFastMutexGetHolder xFastMutexGetHolder
+ * \ingroup FastMutex
+ */
+TaskHandle_t xFastMutexGetHolder( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+ * @code{c}
+ * void vFastMutexGetStats( FastMutexHandle_t xMutex, MutexStats_t * pxStats );
+ * @endcode
+ *
+ * Copies the contention figures of a fast mutex into *pxStats, see
+ * MutexStats_t in FreeRTOS.h.
+ *
+ * configUSE_MUTEX_STATS must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * @param xMutex The mutex to query.
+ *
+ * @param pxStats Where the figures are copied to.
+ *
+ * \defgroup vFastMutexGetStats vFastMutexGetStats
+ * \ingroup FastMutex
+ */
+#if ( configUSE_MUTEX_STATS == 1 )
+    void vFastMutexGetStats( FastMutexHandle_t xMutex,
+                             MutexStats_t * pxStats ) PRIVILEGED_FUNCTION;
+#endif
+
+/* Not public API functions.  A number for trace tools to tell fast mutexes
+ * apart by, as vQueueSetQueueNumber() for queues, 0 until it is set. */
+#if ( configUSE_TRACE_FACILITY == 1 )
+    void vFastMutexSetMutexNumber( FastMutexHandle_t xMutex,
+                                   UBaseType_t uxMutexNumber ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+    UBaseType_t uxFastMutexGetMutexNumber( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* FAST_MUTEX_H */
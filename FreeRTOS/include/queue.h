@@ -914,6 +914,55 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                           void * const pvBuffer,
                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * pvItems, UBaseType_t uxCount, TickType_t xTicksToWait );
+ * BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * pvBuffer, UBaseType_t uxCount, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * configUSE_QUEUE_BATCH must be defined as 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * Send up to uxCount items to the back of a queue, or receive up to uxCount
+ * items from its front, in one critical section.  The items are copied as one
+ * block (two if it wraps round the end of the queue storage), and a task
+ * blocked on the other side is woken once for the batch rather than once per
+ * item, so a higher priority reader or writer is switched to once.  Each of
+ * the items is otherwise the same as an xQueueSend() or xQueueReceive() call,
+ * in the same order.  They cannot be used on semaphores or mutexes.
+ *
+ * The calling task only blocks while the queue is full (or empty), then
+ * moves as many items as there is room (or data) for.
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * @param pvItems Pointer to uxCount items stored one after the other, as an
+ * array of the queue's item type.
+ *
+ * @param pvBuffer Pointer to room for uxCount items.
+ *
+ * @param uxCount The most items to move, must be more than 0.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space (or data) if there is none when the function is called.
+ *
+ * @return The number of items moved, 0 if the block time expired first.
+ *
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_BATCH == 1 )
+    BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                   const void * pvItems,
+                                   UBaseType_t uxCount,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                      void * pvBuffer,
+                                      UBaseType_t uxCount,
+                                      TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * queue. h
  * @code{c}
@@ -1456,6 +1505,33 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
                                  void * const pvBuffer,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * pvItems, UBaseType_t uxCount, BaseType_t * pxHigherPriorityTaskWoken );
+ * BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * pvBuffer, UBaseType_t uxCount, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Versions of xQueueSendMultiple() and xQueueReceiveMultiple() that can be
+ * called from an interrupt service routine.  They never block, they move as
+ * many items as there is room (or data) for and return how many that was.
+ * *pxHigherPriorityTaskWoken is set to pdTRUE if a task the batch unblocked
+ * has a higher priority than the interrupted task.
+ *
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_BATCH == 1 )
+    BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                          const void * pvItems,
+                                          UBaseType_t uxCount,
+                                          BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+    BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                             void * pvBuffer,
+                                             UBaseType_t uxCount,
+                                             BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from within an ISR, or within a critical section.
@@ -1521,6 +1597,24 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
     TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * For internal use only.  Use vSemaphoreGetStats() instead of calling
+ * vQueueGetSemaphoreStats() directly.  The vQueueMutexStats functions keep
+ * the figures for queue.c and fast_mutex.c, and are called from a critical
+ * section: Taken on every successful take, Waited when a take that blocked
+ * ends either way, Given when a mutex is given back.
+ */
+#if ( configUSE_MUTEX_STATS == 1 )
+    void vQueueGetSemaphoreStats( QueueHandle_t xSemaphore,
+                                  MutexStats_t * pxStats ) PRIVILEGED_FUNCTION;
+    void vQueueMutexStatsTaken( MutexStats_t * pxStats ) PRIVILEGED_FUNCTION;
+    void vQueueMutexStatsWaited( MutexStats_t * pxStats,
+                                 uint32_t ulWaitStart,
+                                 TaskHandle_t xHolder,
+                                 BaseType_t xInherited ) PRIVILEGED_FUNCTION;
+    void vQueueMutexStatsGiven( MutexStats_t * pxStats ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * For internal use only.  Use xSemaphoreTakeRecursive() or
  * xSemaphoreGiveRecursive() instead of calling these functions directly.
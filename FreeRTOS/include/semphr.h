@@ -1190,6 +1190,22 @@ typedef QueueHandle_t SemaphoreHandle_t;
  */
 #define uxSemaphoreGetCountFromISR( xSemaphore )    uxQueueMessagesWaitingFromISR( ( QueueHandle_t ) ( xSemaphore ) )
 
+/**
+ * semphr.h
+ * @code{c}
+ * void vSemaphoreGetStats( SemaphoreHandle_t xSemaphore, MutexStats_t * pxStats );
+ * @endcode
+ *
+ * Copies the contention figures of a semaphore or mutex into *pxStats, see
+ * MutexStats_t in FreeRTOS.h.  The hold time is only kept for mutexes.
+ *
+ * configUSE_MUTEX_STATS must be set to 1 in FreeRTOSConfig.h for this macro
+ * to be available.
+ */
+#if ( configUSE_MUTEX_STATS == 1 )
+    #define vSemaphoreGetStats( xSemaphore, pxStats )    vQueueGetSemaphoreStats( ( QueueHandle_t ) ( xSemaphore ), ( pxStats ) )
+#endif
+
 /**
  * semphr.h
  * @code{c}
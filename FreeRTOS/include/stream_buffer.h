@@ -879,6 +879,221 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
                                     size_t xBufferLengthBytes,
                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+ *                                  uint8_t ** ppucData,
+ *                                  TickType_t xTicksToWait );
+ * @endcode
+ *
+ * The first half of a send that writes straight into the stream buffer's own
+ * storage area instead of copying from a separate buffer as
+ * xStreamBufferSend() does.  Sets *ppucData to the next free byte in the
+ * storage area and returns how many bytes from there can be written, which
+ * the writer then fills and publishes with vStreamBufferSendCommit() or
+ * vStreamBufferSendCommitFromISR().  Nothing is visible to the reader until
+ * the commit.
+ *
+ * The region returned never runs past the end of the storage area.  When the
+ * free space wraps round to the beginning it is handed out as two spans: the
+ * part up to the end first, then the part from the beginning when
+ * xStreamBufferSendAcquire() is called again after the first commit.
+ *
+ * As with xStreamBufferSend(), there must be only one writer.  The region
+ * belongs to the writer until it commits, and a commit may publish any part
+ * of it from the start, including none.  Only for stream buffers, not message
+ * buffers, whose messages are each stored after their length.
+ *
+ * May be called from an interrupt service routine with xTicksToWait set to 0.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * xStreamBufferSendAcquire() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to write to.
+ *
+ * @param ppucData Set to where in the storage area the bytes are written.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should
+ * remain in the Blocked state to wait for at least one byte of space if the
+ * stream buffer is full.
+ *
+ * @return The number of bytes that can be written at *ppucData, 0 if the
+ * stream buffer stayed full.
+ *
+ * Example use:
+ * @code{c}
+ * void vAnInterruptServiceRoutine( void )
+ * {
+ * uint8_t * pucSpan;
+ * BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ *
+ *  // Write the received byte straight into the stream buffer.
+ *  if( xStreamBufferSendAcquire( xStreamBuffer, &pucSpan, 0 ) > 0 )
+ *  {
+ *      *pucSpan = U1RXREG;
+ *      vStreamBufferSendCommitFromISR( xStreamBuffer, 1, &xHigherPriorityTaskWoken );
+ *  }
+ *
+ *  portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferSendAcquire xStreamBufferSendAcquire
+ * \ingroup StreamBufferManagement
+ */
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+    size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+                                     uint8_t ** ppucData,
+                                     TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+ *                               size_t xDataLengthBytes );
+ * void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                      size_t xDataLengthBytes,
+ *                                      BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * The second half of a send started with xStreamBufferSendAcquire().
+ * Publishes the first xDataLengthBytes of the region it returned, which must
+ * already hold the data, and unblocks a task waiting to receive once the
+ * trigger level is reached, as xStreamBufferSend() does.
+ * vStreamBufferSendCommitFromISR() is the version for interrupt service
+ * routines.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * vStreamBufferSendCommit() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer written to.
+ *
+ * @param xDataLengthBytes The number of bytes written, no more than the last
+ * xStreamBufferSendAcquire() returned.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the commit unblocked a task
+ * with a priority above the interrupted task, as for
+ * xStreamBufferSendFromISR().
+ *
+ * \defgroup vStreamBufferSendCommit vStreamBufferSendCommit
+ * \ingroup StreamBufferManagement
+ */
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+    void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+    void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                         size_t xDataLengthBytes,
+                                         BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+ *                                     uint8_t ** ppucData,
+ *                                     TickType_t xTicksToWait );
+ * @endcode
+ *
+ * The first half of a receive that reads the data where it lies in the stream
+ * buffer's storage area instead of copying it out as xStreamBufferReceive()
+ * does.  Sets *ppucData to the oldest byte in the stream buffer and returns
+ * how many bytes from there can be read.  The bytes stay in the stream buffer
+ * until vStreamBufferReceiveCommit() or vStreamBufferReceiveCommitFromISR()
+ * frees them, so the reader can parse them in place and only free what it has
+ * used.
+ *
+ * As with xStreamBufferSendAcquire(), data that wraps round to the beginning
+ * of the storage area comes as two spans, the second from calling
+ * xStreamBufferReceiveAcquire() again after the first commit.
+ *
+ * There must be only one reader, and only stream buffers are supported, not
+ * message buffers.  May be called from an interrupt service routine with
+ * xTicksToWait set to 0.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * xStreamBufferReceiveAcquire() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param ppucData Set to where in the storage area the bytes are read.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should
+ * remain in the Blocked state to wait for data if the stream buffer is empty,
+ * or for a batching buffer holds no more than its trigger level.
+ *
+ * @return The number of bytes that can be read at *ppucData, 0 if none
+ * arrived.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( StreamBufferHandle_t xStreamBuffer )
+ * {
+ * uint8_t * pucSpan;
+ * size_t xBytes, xUsed;
+ *
+ *  xBytes = xStreamBufferReceiveAcquire( xStreamBuffer, &pucSpan, pdMS_TO_TICKS( 20 ) );
+ *
+ *  if( xBytes > 0 )
+ *  {
+ *      // Parse the bytes in place, leaving a partial line for next time.
+ *      xUsed = prvParseLines( pucSpan, xBytes );
+ *      vStreamBufferReceiveCommit( xStreamBuffer, xUsed );
+ *  }
+ * }
+ * @endcode
+ * \defgroup xStreamBufferReceiveAcquire xStreamBufferReceiveAcquire
+ * \ingroup StreamBufferManagement
+ */
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+    size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+                                        uint8_t ** ppucData,
+                                        TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * void vStreamBufferReceiveCommit( StreamBufferHandle_t xStreamBuffer,
+ *                                  size_t xDataLengthBytes );
+ * void vStreamBufferReceiveCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                         size_t xDataLengthBytes,
+ *                                         BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * The second half of a receive started with xStreamBufferReceiveAcquire().
+ * Frees the first xDataLengthBytes of the region it returned for the writer to
+ * reuse, and unblocks a task waiting to send, as xStreamBufferReceive() does.
+ * vStreamBufferReceiveCommitFromISR() is the version for interrupt service
+ * routines.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * vStreamBufferReceiveCommit() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer read from.
+ *
+ * @param xDataLengthBytes The number of bytes used, no more than the last
+ * xStreamBufferReceiveAcquire() returned.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the commit unblocked a task
+ * with a priority above the interrupted task, as for
+ * xStreamBufferReceiveFromISR().
+ *
+ * \defgroup vStreamBufferReceiveCommit vStreamBufferReceiveCommit
+ * \ingroup StreamBufferManagement
+ */
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+    void vStreamBufferReceiveCommit( StreamBufferHandle_t xStreamBuffer,
+                                     size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+    void vStreamBufferReceiveCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                            size_t xDataLengthBytes,
+                                            BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * stream_buffer.h
  *
@@ -935,6 +935,58 @@ BaseType_t xTaskDelayUntil( TickType_t * const pxPreviousWakeTime,
         ( void ) xTaskDelayUntil( ( pxPreviousWakeTime ), ( xTimeIncrement ) ); \
     } while( 0 )
 
+/**
+ * task. h
+ * @code{c}
+ * void vTaskDelayWithSlack( const TickType_t xTicksToDelay, const TickType_t xSlack );
+ * BaseType_t xTaskDelayUntilWithSlack( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement, const TickType_t xSlack );
+ * @endcode
+ *
+ * configUSE_TASK_DELAY_SLACK must be defined as 1 in FreeRTOSConfig.h for
+ * these functions to be available.
+ *
+ * As vTaskDelay() and xTaskDelayUntil(), but the task may be woken up to
+ * xSlack ticks after the requested time.  Within that window the kernel picks
+ * a tick another task is already due to wake on, or failing that the tick on
+ * the coarsest power of two boundary, so wake-ups from several tasks land on
+ * fewer ticks and tickless idle gets longer sleeps.  A slack of 0 is the same
+ * as the plain function.  xTaskDelayUntilWithSlack() still advances
+ * *pxPreviousWakeTime by exactly xTimeIncrement, so the slack never
+ * accumulates.
+ *
+ * @param xSlack The number of ticks the wake-up may be deferred by.
+ *
+ * \defgroup vTaskDelayWithSlack vTaskDelayWithSlack
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_TASK_DELAY_SLACK == 1 )
+    void vTaskDelayWithSlack( const TickType_t xTicksToDelay,
+                              const TickType_t xSlack ) PRIVILEGED_FUNCTION;
+    BaseType_t xTaskDelayUntilWithSlack( TickType_t * const pxPreviousWakeTime,
+                                         const TickType_t xTimeIncrement,
+                                         const TickType_t xSlack ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * @code{c}
+ * uint32_t ulTaskGetWakeTicks( void );
+ * @endcode
+ *
+ * configUSE_TASK_DELAY_SLACK must be defined as 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * @return The number of ticks so far on which at least one task left the
+ * Blocked state because its delay or timeout was up.  Comparing it over a
+ * period shows how well delay slack is coalescing wake-ups.
+ *
+ * \defgroup ulTaskGetWakeTicks ulTaskGetWakeTicks
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_TASK_DELAY_SLACK == 1 )
+    uint32_t ulTaskGetWakeTicks( void ) PRIVILEGED_FUNCTION;
+#endif
+
 
 /**
  * task. h
@@ -3580,6 +3632,24 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList ) PRIVILEG
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
                                         const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
+ * INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.
+ *
+ * As vTaskRemoveFromUnorderedEventList(), but for event groups set directly
+ * from an interrupt: the scheduler need not be suspended, and if it is the
+ * task is held on the pending ready list as by xTaskRemoveFromEventList().
+ *
+ * @return pdTRUE if the task being removed has a higher priority than the task
+ * making the call, otherwise pdFALSE.
+ */
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
  * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
@@ -51,6 +51,12 @@ FreeRTOS.org V4.3.0. */
     #define configKERNEL_INTERRUPT_PRIORITY 1
 #endif
 
+/* Projects that predate the syscall priority split masked only the kernel
+priority in critical sections. */
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+    #define configMAX_SYSCALL_INTERRUPT_PRIORITY configKERNEL_INTERRUPT_PRIORITY
+#endif
+
 /* Use _T1Interrupt as the interrupt handler name if the application writer has
 not provided their own. */
 #ifndef configTICK_INTERRUPT_HANDLER
@@ -60,25 +66,87 @@ not provided their own. */
 /* The program counter is only 23 bits. */
 #define portUNUSED_PR_BITS  0x7f
 
+/* How deeply interrupts are nested, and whether one of them asked for a
+context switch on the way out.  Both are used by _vPortInterruptEntry. */
+volatile UBaseType_t uxPortInterruptNesting __attribute__((near)) = 0;
+volatile BaseType_t xPortYieldPending __attribute__((near)) = pdFALSE;
+
 /* Records the nesting depth of calls to portENTER_CRITICAL(). */
 UBaseType_t uxCriticalNesting = 0xef;
 
-#if configKERNEL_INTERRUPT_PRIORITY != 1
-    #error If configKERNEL_INTERRUPT_PRIORITY is not 1 then the #32 in the following macros needs changing to equal the portINTERRUPT_BITS value, which is ( configKERNEL_INTERRUPT_PRIORITY << 5 )
+/* The IPL in force when the outermost critical section was entered.  Tasks
+run at IPL 0, so this is only ever different while the idle task holds the
+IPL raised around a tickless sleep, and it does not yield in that time. */
+static UBaseType_t uxCriticalSavedIPL = 0;
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+    /* The number of timer 1 counts that make up one tick period, and the
+    maximum number of tick periods that can be suppressed, which is limited by
+    the 16-bit width of PR1. */
+    static uint16_t usTimerCountsForOneTick = 0;
+    static TickType_t xMaximumPossibleSuppressedTicks = 0;
+
+    /* Timer 1 is stopped for a few instructions when a suppressed tick period
+    is cut short, so a small number of counts are added back to compensate.
+    Stopping the timer also clears the 1:8 prescaler. */
+    #define portSTOPPED_TIMER_COMPENSATION  ( 2U )
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    /* Run time counter counts spent in interrupt handlers, accumulated by
+    _vPortInterruptEntry around the outermost handler only, so nested handlers
+    are not counted twice.  The same time is also included in the run time of
+    whichever task was interrupted. */
+    volatile uint32_t ulPortISRRunTime __attribute__((near)) = 0;
+    volatile uint16_t usPortISREntryTime __attribute__((near)) = 0;
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+#if ( configKERNEL_INTERRUPT_PRIORITY < 1 ) || ( configMAX_SYSCALL_INTERRUPT_PRIORITY > 7 )
+    #error configKERNEL_INTERRUPT_PRIORITY and configMAX_SYSCALL_INTERRUPT_PRIORITY must be in the range 1 to 7
+#endif
+
+#if configMAX_SYSCALL_INTERRUPT_PRIORITY < configKERNEL_INTERRUPT_PRIORITY
+    #error configMAX_SYSCALL_INTERRUPT_PRIORITY must not be lower than configKERNEL_INTERRUPT_PRIORITY
+#endif
+
+#if ( configUSE_REDUCED_TASK_CONTEXT == 1 ) && ( defined( __dsPIC30F__ ) || defined( __dsPIC33F__ ) )
+    #error configUSE_REDUCED_TASK_CONTEXT is only implemented for the PIC24 context layout
 #endif
 
 #if defined( __PIC24E__ ) || defined ( __PIC24F__ ) || defined( __PIC24FK__ ) || defined( __PIC24H__ )
 
+    /* TBLPAG, CORCON and the page registers are only part of the task context
+    when configUSE_REDUCED_TASK_CONTEXT is 0. */
+    #if ( configUSE_REDUCED_TASK_CONTEXT == 1 )
+        #define portRESTORE_PAGES   ""
+    #elif defined( __HAS_EDS__ )
+        #define portRESTORE_PAGES   "POP    DSWPAG                  \n"                                                             \
+                                    "POP    DSRPAG                  \n"                                                             \
+                                    "POP    CORCON                  \n"                                                             \
+                                    "POP    TBLPAG                  \n"
+    #else
+        #define portRESTORE_PAGES   "POP    PSVPAG                  \n"                                                             \
+                                    "POP    CORCON                  \n"                                                             \
+                                    "POP    TBLPAG                  \n"
+    #endif /* configUSE_REDUCED_TASK_CONTEXT */
+
+    /* The stack limit is the last word of the frame, and is loaded before the
+    stack pointer moves onto the task's stack. */
     #ifdef __HAS_EDS__
         #define portRESTORE_CONTEXT()                                                                                       \
                     asm volatile(   "MOV    _pxCurrentTCB, W0       \n" /* Restore the stack pointer for the task. */       \
-                            "MOV    [W0], W15               \n"                                                             \
+                            "MOV    [W0], W1                \n"                                                             \
+                            "MOV    [W1-2], W0              \n"                                                             \
+                            "DISI   #1                      \n"                                                             \
+                            "MOV    W0, SPLIM               \n"                                                             \
+                            "SUB    W1, #2, W15             \n"                                                             \
                             "POP    W0                      \n" /* Restore the critical nesting counter for the task. */    \
                             "MOV    W0, _uxCriticalNesting  \n"                                                             \
-                            "POP    DSWPAG                  \n"                                                             \
-                            "POP    DSRPAG                  \n"                                                             \
-                            "POP    CORCON                  \n"                                                             \
-                            "POP    TBLPAG                  \n"                                                             \
+                            portRESTORE_PAGES                                                                               \
                             "POP    RCOUNT                  \n" /* Restore the registers from the stack. */                 \
                             "POP    W14                     \n"                                                             \
                             "POP.D  W12                     \n"                                                             \
@@ -92,12 +160,14 @@ UBaseType_t uxCriticalNesting = 0xef;
     #else /* __HAS_EDS__ */
         #define portRESTORE_CONTEXT()                                                                                       \
             asm volatile(   "MOV    _pxCurrentTCB, W0       \n" /* Restore the stack pointer for the task. */               \
-                            "MOV    [W0], W15               \n"                                                             \
+                            "MOV    [W0], W1                \n"                                                             \
+                            "MOV    [W1-2], W0              \n"                                                             \
+                            "DISI   #1                      \n"                                                             \
+                            "MOV    W0, SPLIM               \n"                                                             \
+                            "SUB    W1, #2, W15             \n"                                                             \
                             "POP    W0                      \n" /* Restore the critical nesting counter for the task. */    \
                             "MOV    W0, _uxCriticalNesting  \n"                                                             \
-                            "POP    PSVPAG                  \n"                                                             \
-                            "POP    CORCON                  \n"                                                             \
-                            "POP    TBLPAG                  \n"                                                             \
+                            portRESTORE_PAGES                                                                               \
                             "POP    RCOUNT                  \n" /* Restore the registers from the stack. */                 \
                             "POP    W14                     \n"                                                             \
                             "POP.D  W12                     \n"                                                             \
@@ -157,10 +227,35 @@ UBaseType_t uxCriticalNesting = 0xef;
  */
 void vApplicationSetupTickTimerInterrupt( void );
 
+/*
+ * The tick interrupt handler, installed on configTICK_INTERRUPT_HANDLER.
+ */
+void vPortTickInterruptHandler( void );
+
+#if ( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+
+    /* Called from the stack error trap, on the trap handler's own stack. */
+    void vPortStackError( const uint16_t *pusTrappedStackPointer );
+
+    /* Return address of the stack error trap, one instruction past the push
+    that overflowed.  Kept for inspection in the debugger. */
+    volatile uint32_t ulPortStackErrorAddress = 0;
+
+    #if ( configCHECK_FOR_STACK_OVERFLOW == 0 )
+        /* task.h only declares the hook when the software check is used. */
+        extern void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName );
+    #endif
+
+#endif /* portHAS_STACK_OVERFLOW_CHECKING */
+
 /*
  * See header file for description.
  */
+#if ( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+#else
 StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+#endif
 {
 uint16_t usCode;
 UBaseType_t i;
@@ -182,7 +277,9 @@ const StackType_t xInitialStack[] =
     0xdddd, /* W13 */
     0xeeee, /* W14 */
     0xcdce, /* RCOUNT */
-    0xabac, /* TBLPAG */
+    #if ( configUSE_REDUCED_TASK_CONTEXT == 0 )
+        0xabac, /* TBLPAG */
+    #endif
 
     /* dsPIC specific registers. */
     #if defined( __dsPIC30F__ ) || defined( __dsPIC33F__ )
@@ -227,32 +324,70 @@ const StackType_t xInitialStack[] =
         pxTopOfStack++;
     }
 
-    *pxTopOfStack = CORCON;
-    pxTopOfStack++;
-
-    #if defined(__HAS_EDS__)
-        *pxTopOfStack = DSRPAG;
-        pxTopOfStack++;
-        *pxTopOfStack = DSWPAG;
-        pxTopOfStack++;
-    #else /* __HAS_EDS__ */
-        *pxTopOfStack = PSVPAG;
+    #if ( configUSE_REDUCED_TASK_CONTEXT == 0 )
+    {
+        *pxTopOfStack = CORCON;
         pxTopOfStack++;
-    #endif /* __HAS_EDS__ */
+
+        #if defined(__HAS_EDS__)
+            *pxTopOfStack = DSRPAG;
+            pxTopOfStack++;
+            *pxTopOfStack = DSWPAG;
+            pxTopOfStack++;
+        #else /* __HAS_EDS__ */
+            *pxTopOfStack = PSVPAG;
+            pxTopOfStack++;
+        #endif /* __HAS_EDS__ */
+    }
+    #endif /* configUSE_REDUCED_TASK_CONTEXT */
 
     /* Finally the critical nesting depth. */
     *pxTopOfStack = 0x00;
     pxTopOfStack++;
 
+    #if ( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+    {
+        /* And the stack limit, loaded into SPLIM before the stack pointer. */
+        *pxTopOfStack = ( StackType_t ) ( pxEndOfStack - portSTACK_LIMIT_PADDING );
+        pxTopOfStack++;
+    }
+    #endif /* portHAS_STACK_OVERFLOW_CHECKING */
+
     return pxTopOfStack;
 }
 /*-----------------------------------------------------------*/
 
+#if ( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+
+    void vPortStackError( const uint16_t *pusTrappedStackPointer )
+    {
+        /* The trap pushed PC<15:0> and then SR<7:0>:IPL3:PC<22:16>. */
+        ulPortStackErrorAddress = ( ( uint32_t ) ( pusTrappedStackPointer[ -1 ] & portUNUSED_PR_BITS ) << 16 ) | pusTrappedStackPointer[ -2 ];
+
+        vApplicationStackOverflowHook( xTaskGetCurrentTaskHandle(), pcTaskGetName( NULL ) );
+
+        /* The hook should not return. */
+        portDISABLE_INTERRUPTS();
+        for( ;; );
+    }
+
+#endif /* portHAS_STACK_OVERFLOW_CHECKING */
+/*-----------------------------------------------------------*/
+
 BaseType_t xPortStartScheduler( void )
 {
     /* Setup a timer for the tick ISR. */
     vApplicationSetupTickTimerInterrupt();
 
+    #if ( configUSE_TICKLESS_IDLE == 1 )
+    {
+        /* Take the tick period from the timer as it was actually configured,
+        in case the application provided its own setup function. */
+        usTimerCountsForOneTick = PR1 + 1U;
+        xMaximumPossibleSuppressedTicks = ( TickType_t ) ( 0x10000UL / usTimerCountsForOneTick );
+    }
+    #endif /* configUSE_TICKLESS_IDLE */
+
     /* Restore the context of the first task to run. */
     portRESTORE_CONTEXT();
 
@@ -303,9 +438,58 @@ const uint32_t ulCompareMatch = ( ( configCPU_CLOCK_HZ / portTIMER_PRESCALE ) /
 }
 /*-----------------------------------------------------------*/
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/*
+ * Setup a free running 32-bit counter for the run time statistics.  The part
+ * has no Timer 4/5 pair, so SCCP4 is used in its 32-bit timer mode.  Fcy / 64
+ * gives 62.5 kHz, 62 counts per tick at 4 MHz, and the count wraps after about
+ * 19 hours.
+ */
+__attribute__(( weak )) void vPortConfigureTimerForRunTimeStats( void )
+{
+    CCP4CON1L = 0;
+    CCP4CON1Lbits.T32 = 1;          /* 32-bit timer. */
+    CCP4CON1Lbits.MOD = 0;          /* Timer mode, no compare output. */
+    CCP4CON1Lbits.CLKSEL = 0;       /* Instruction clock. */
+    CCP4CON1Lbits.TMRPS = 0b11;     /* 1:64 prescale. */
+    CCP4TMRL = 0;
+    CCP4TMRH = 0;
+    CCP4PRL = 0xFFFF;
+    CCP4PRH = 0xFFFF;
+
+    /* Free running, the timer interrupt is left disabled. */
+    CCP4CON1Lbits.CCPON = 1;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetRunTimeCounterValue( void )
+{
+uint16_t usHigh, usLow;
+
+    /* The two halves are not latched together, so read the high half again
+    to catch the low half wrapping between the reads. */
+    do
+    {
+        usHigh = CCP4TMRH;
+        usLow = CCP4TMRL;
+    } while( usHigh != CCP4TMRH );
+
+    return ( ( uint32_t ) usHigh << 16 ) | usLow;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
 void vPortEnterCritical( void )
 {
+UBaseType_t uxIPL = SRbits.IPL;
+
     portDISABLE_INTERRUPTS();
+    if( uxCriticalNesting == 0 )
+    {
+        uxCriticalSavedIPL = uxIPL;
+    }
     uxCriticalNesting++;
 }
 /*-----------------------------------------------------------*/
@@ -316,19 +500,184 @@ void vPortExitCritical( void )
     uxCriticalNesting--;
     if( uxCriticalNesting == 0 )
     {
-        portENABLE_INTERRUPTS();
+        SET_CPU_IPL( uxCriticalSavedIPL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMaskFromISR( void )
+{
+UBaseType_t uxSavedIPL = SRbits.IPL;
+
+    /* Never lower the IPL, a handler above the syscall priority that calls
+    this by mistake is caught by portASSERT_IF_INTERRUPT_PRIORITY_INVALID(). */
+    if( uxSavedIPL < configMAX_SYSCALL_INTERRUPT_PRIORITY )
+    {
+        SET_CPU_IPL( configMAX_SYSCALL_INTERRUPT_PRIORITY );
     }
+
+    return uxSavedIPL;
 }
 /*-----------------------------------------------------------*/
 
-void __attribute__((__interrupt__, auto_psv)) configTICK_INTERRUPT_HANDLER( void )
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSavedIPL )
 {
+    SET_CPU_IPL( uxSavedIPL );
+}
+/*-----------------------------------------------------------*/
+
+portDEFINE_ISR( configTICK_INTERRUPT_HANDLER, vPortTickInterruptHandler );
+
+void vPortTickInterruptHandler( void )
+{
+UBaseType_t uxSavedIPL;
+BaseType_t xSwitchRequired;
+
+    traceISR_ENTER();
+
     /* Clear the timer interrupt. */
     IFS0bits.T1IF = 0;
 
-    if( xTaskIncrementTick() != pdFALSE )
+    #if ( configUSE_TICKLESS_IDLE == 1 )
     {
-        portYIELD();
+        /* The first tick after a suppressed tick period still has the
+        stretched period in PR1, so restore the normal one. */
+        PR1 = usTimerCountsForOneTick - 1U;
     }
+    #endif /* configUSE_TICKLESS_IDLE */
+
+    /* The tick runs at the kernel priority, so mask the interrupts that may
+    call the API while the delayed lists are updated. */
+    uxSavedIPL = portSET_INTERRUPT_MASK_FROM_ISR();
+    xSwitchRequired = xTaskIncrementTick();
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedIPL );
+
+    if( xSwitchRequired != pdFALSE )
+    {
+        traceISR_EXIT_TO_SCHEDULER();
+    }
+    else
+    {
+        traceISR_EXIT();
+    }
+
+    portYIELD_FROM_ISR( xSwitchRequired );
 }
 /*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+    uint16_t usCompletedCounts;
+    TickType_t xCompleteTickPeriods, xModifiableIdleTime;
+
+        /* Make sure the stretched period still fits in PR1. */
+        if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+        {
+            xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+        }
+
+        /* Raise the IPL rather than using taskENTER_CRITICAL().  An enabled
+        interrupt at or below the CPU priority still wakes the core from Idle,
+        it just isn't taken until the IPL is lowered again. */
+        portDISABLE_INTERRUPTS();
+
+        /* Stretch the period so the next match lands exactly on the tick
+        boundary xExpectedIdleTime ticks away.  TMR1 already holds the elapsed
+        part of the current tick, and is never larger than the new period, so
+        the timer can be left running. */
+        PR1 = ( uint16_t ) ( ( ( uint32_t ) usTimerCountsForOneTick * xExpectedIdleTime ) - 1UL );
+
+        /* If the tick matched just before PR1 was written, or a task was made
+        ready while the scheduler was suspended, abandon the low power entry.
+        The pending tick interrupt (if any) restores the normal period. */
+        if( ( IFS0bits.T1IF != 0 ) || ( eTaskConfirmSleepModeStatus() == eAbortSleep ) )
+        {
+            PR1 = usTimerCountsForOneTick - 1U;
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+        xCompleteTickPeriods = xExpectedIdleTime - 1U;
+
+        for( ;; )
+        {
+            /* Allow the application to define some pre-sleep processing.  This
+            is the standard configPRE_SLEEP_PROCESSING() macro as described on
+            the FreeRTOS.org website. */
+            xModifiableIdleTime = xExpectedIdleTime;
+            configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+
+            if( xModifiableIdleTime > 0 )
+            {
+                /* Idle rather than Sleep, so timer 1 keeps running from Fcy. */
+                Idle();
+            }
+
+            configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+            if( IFS0bits.T1IF != 0 )
+            {
+                /* The stretched period expired.  The tick interrupt is still
+                pending and will account for the final tick itself once the
+                IPL is lowered, so step the others. */
+                break;
+            }
+
+            /* Something else woke the core.  Let its handler run, then go back
+            to sleep without touching timer 1 unless the handler made a task
+            ready. */
+            portENABLE_INTERRUPTS();
+            portNOP();
+            portDISABLE_INTERRUPTS();
+
+            if( PR1 == ( usTimerCountsForOneTick - 1U ) )
+            {
+                /* The tick interrupt itself was taken in that window, which
+                also restored the period. */
+                break;
+            }
+
+            if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+            {
+                /* Work out how many whole tick periods have passed.  Timer 1
+                is stopped so the partial count can be carried into a normal
+                length tick without racing the match. */
+                T1CONbits.TON = 0;
+
+                if( IFS0bits.T1IF == 0 )
+                {
+                    usCompletedCounts = TMR1 + portSTOPPED_TIMER_COMPENSATION;
+                    xCompleteTickPeriods = usCompletedCounts / usTimerCountsForOneTick;
+
+                    if( xCompleteTickPeriods >= xExpectedIdleTime )
+                    {
+                        /* Only possible if the compensation carried the count
+                        over the boundary, leave the last tick to the ISR. */
+                        xCompleteTickPeriods = xExpectedIdleTime - 1U;
+                        IFS0bits.T1IF = 1;
+                        TMR1 = 0;
+                    }
+                    else
+                    {
+                        TMR1 = usCompletedCounts % usTimerCountsForOneTick;
+                    }
+                }
+
+                PR1 = usTimerCountsForOneTick - 1U;
+                T1CONbits.TON = 1;
+                break;
+            }
+        }
+
+        /* Correct the kernel tick count.  xCompleteTickPeriods is always less
+        than xExpectedIdleTime, so this never reaches xNextTaskUnblockTime and
+        vTaskStepTick() does not need to pend a tick. */
+        vTaskStepTick( xCompleteTickPeriods );
+
+        portENABLE_INTERRUPTS();
+    }
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
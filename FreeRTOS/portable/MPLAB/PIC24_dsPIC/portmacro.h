@@ -77,25 +77,103 @@ typedef unsigned short UBaseType_t;
 /* Hardware specifics. */
 #define portBYTE_ALIGNMENT          2
 #define portSTACK_GROWTH            1
+
+/* On PIC24 parts each task's stack limit is kept in SPLIM, so an overflow
+traps on the push that causes it.  The limit is set this many words below
+the end of the stack to leave room for the push and the trap frame. */
+#if defined( __PIC24E__ ) || defined ( __PIC24F__ ) || defined( __PIC24FK__ ) || defined( __PIC24H__ )
+    #define portHAS_STACK_OVERFLOW_CHECKING     1
+    #define portSTACK_LIMIT_PADDING             4
+#endif
 #define portTICK_PERIOD_MS          ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
 /*-----------------------------------------------------------*/
 
-/* Critical section management. */
-#define portDISABLE_INTERRUPTS()    SET_CPU_IPL( configKERNEL_INTERRUPT_PRIORITY ); __asm volatile ( "NOP" )
+/* Critical section management.  Interrupts are masked up to and including
+configMAX_SYSCALL_INTERRUPT_PRIORITY, higher priority interrupts are never
+masked by the kernel. */
+#define portDISABLE_INTERRUPTS()    SET_CPU_IPL( configMAX_SYSCALL_INTERRUPT_PRIORITY ); __asm volatile ( "NOP" )
 #define portENABLE_INTERRUPTS()     SET_CPU_IPL( 0 )
 
-/* Note that exiting a critical sectino will set the IPL bits to 0, no matter
-what their value was prior to entering the critical section. */
+/* Exiting the outermost critical section puts back the IPL that was in force
+when it was entered. */
 extern void vPortEnterCritical( void );
 extern void vPortExitCritical( void );
 #define portENTER_CRITICAL()        vPortEnterCritical()
 #define portEXIT_CRITICAL()         vPortExitCritical()
+
+/* Interrupt safe critical sections save the current IPL and only ever raise
+it, so they nest correctly inside higher priority handlers. */
+extern UBaseType_t uxPortSetInterruptMaskFromISR( void );
+extern void vPortClearInterruptMaskFromISR( UBaseType_t uxSavedIPL );
+#define portSET_INTERRUPT_MASK_FROM_ISR()                   uxPortSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedIPL )     vPortClearInterruptMaskFromISR( uxSavedIPL )
+
+/* Only interrupts at or below the syscall priority may use the FromISR API. */
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()    configASSERT( SRbits.IPL <= configMAX_SYSCALL_INTERRUPT_PRIORITY )
 /*-----------------------------------------------------------*/
 
 /* Task utilities. */
 extern void vPortYield( void );
 #define portYIELD()             asm volatile ( "CALL _vPortYield            \n"     \
                                                 "NOP                      " );
+
+/* Interrupt handlers run on the interrupt stack, so a switch requested from
+one is made when the outermost interrupt returns to the task stack. */
+extern volatile BaseType_t xPortYieldPending;
+#define portYIELD_FROM_ISR( xSwitchRequired )    do { if( ( xSwitchRequired ) != pdFALSE ) { xPortYieldPending = pdTRUE; } } while( 0 )
+#define portEND_SWITCHING_ISR( xSwitchRequired ) portYIELD_FROM_ISR( xSwitchRequired )
+/*-----------------------------------------------------------*/
+
+/* Installs pxHandler, a plain void( void ) function, as the handler for the
+interrupt vector xVector (_T1Interrupt, _U2RXInterrupt, ...).  The generated
+vector saves W0 and enters _vPortInterruptEntry, which runs the handler on the
+interrupt stack.  Use at file scope in place of an interrupt attribute. */
+#define portDEFINE_ISR( xVector, pxHandler )    portDEFINE_ISR_STUB( xVector, pxHandler )
+#define portDEFINE_ISR_STUB( xVector, pxHandler )                           \
+    __asm__( "    .pushsection .text                    \n"                 \
+             "    .global _" #xVector "                 \n"                 \
+             "_" #xVector ":                            \n"                 \
+             "    PUSH    W0                            \n"                 \
+             "    MOV     #handle(_" #pxHandler "), W0  \n"                 \
+             "    GOTO    _vPortInterruptEntry          \n"                 \
+             "    .popsection                             " )
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisations. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+    /* Check the configuration. */
+    #if ( configMAX_PRIORITIES > 16 )
+        #error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 16.  It is very rare that a system requires more than 10 to 15 different priorities as tasks that share a priority will time slice.
+    #endif
+
+    /* Store/clear the ready priorities in a bit map. */
+    #define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities )    ( uxReadyPriorities ) |= ( 1U << ( uxPriority ) )
+    #define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities )     ( uxReadyPriorities ) &= ~( 1U << ( uxPriority ) )
+
+    /* FF1L gives the position of the most significant set bit counting from 1
+    at bit 15, in a single cycle.  The idle task is always ready so the bit map
+    is never zero here. */
+    #define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )    uxTopPriority = ( 16U - __builtin_ff1l( uxReadyPriorities ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+/*-----------------------------------------------------------*/
+
+/* Tickless idle/low power functionality. */
+#if ( configUSE_TICKLESS_IDLE == 1 )
+    extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+    #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Run time statistics, counted by SCCP4 in port.c. */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    extern void vPortConfigureTimerForRunTimeStats( void );
+    extern uint32_t ulPortGetRunTimeCounterValue( void );
+    extern volatile uint32_t ulPortISRRunTime;
+    #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vPortConfigureTimerForRunTimeStats()
+    #define portGET_RUN_TIME_COUNTER_VALUE()            ulPortGetRunTimeCounterValue()
+#endif
 /*-----------------------------------------------------------*/
 
 /* Task function macros as described on the FreeRTOS.org WEB site. */
@@ -133,6 +133,10 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
     #endif
+
+    #if ( configUSE_MUTEX_STATS == 1 )
+        MutexStats_t xStats; /**< Contention figures, kept by xQueueSemaphoreTake() and the mutex give. */
+    #endif
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -210,6 +214,42 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_QUEUE_BATCH == 1 )
+
+/*
+ * Copies as many of uxCount items as there is room for to the back of the
+ * queue, and returns how many that was.
+ */
+    static UBaseType_t prvCopyMultipleToQueue( Queue_t * const pxQueue,
+                                               const void * pvItems,
+                                               UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies as many of uxCount items as the queue holds out of the front of the
+ * queue, and returns how many that was.
+ */
+    static UBaseType_t prvCopyMultipleFromQueue( Queue_t * const pxQueue,
+                                                 void * const pvBuffer,
+                                                 UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblocks the tasks uxItems new items (or spaces) are enough for, at most one
+ * each, from the front of pxEventList.  Returns pdTRUE if one of them has a
+ * higher priority than the calling task.  Called from a critical section with
+ * the queue unlocked.
+ */
+    static BaseType_t prvUnblockForItems( List_t * const pxEventList,
+                                          UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
+/*
+ * As prvUnblockForItems() for items sent to the queue, which go to the queue
+ * set instead if the queue is a member of one.
+ */
+    static BaseType_t prvUnblockForItemsSent( Queue_t * const pxQueue,
+                                              UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_QUEUE_BATCH */
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -608,6 +648,12 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
     }
     #endif /* configUSE_QUEUE_SETS */
 
+    #if ( configUSE_MUTEX_STATS == 1 )
+    {
+        ( void ) memset( &( pxNewQueue->xStats ), 0x00, sizeof( pxNewQueue->xStats ) );
+    }
+    #endif /* configUSE_MUTEX_STATS */
+
     traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -754,6 +800,88 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
 #endif /* if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MUTEX_STATS == 1 )
+
+    void vQueueGetSemaphoreStats( QueueHandle_t xSemaphore,
+                                  MutexStats_t * pxStats )
+    {
+        Queue_t * const pxQueue = xSemaphore;
+
+        traceENTER_vQueueGetSemaphoreStats( xSemaphore, pxStats );
+
+        configASSERT( pxQueue );
+        configASSERT( pxStats );
+        configASSERT( pxQueue->uxItemSize == 0 );
+
+        /* Several words, kept up to date from critical sections. */
+        taskENTER_CRITICAL();
+        {
+            *pxStats = pxQueue->xStats;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vQueueGetSemaphoreStats();
+    }
+/*-----------------------------------------------------------*/
+
+    void vQueueMutexStatsTaken( MutexStats_t * pxStats )
+    {
+        /* Called from a critical section. */
+        pxStats->ulTakes++;
+        pxStats->ulTakenAt = configMUTEX_STATS_TIME();
+    }
+/*-----------------------------------------------------------*/
+
+    void vQueueMutexStatsWaited( MutexStats_t * pxStats,
+                                 uint32_t ulWaitStart,
+                                 TaskHandle_t xHolder,
+                                 BaseType_t xInherited )
+    {
+        const uint32_t ulWait = configMUTEX_STATS_TIME() - ulWaitStart;
+
+        /* Called from a critical section. */
+        pxStats->ulContended++;
+        pxStats->ulTotalWait += ulWait;
+
+        if( ulWait > pxStats->ulMaxWait )
+        {
+            pxStats->ulMaxWait = ulWait;
+            pxStats->xMaxWaitHolder = xHolder;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xInherited != pdFALSE )
+        {
+            pxStats->ulInheritances++;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vQueueMutexStatsGiven( MutexStats_t * pxStats )
+    {
+        const uint32_t ulHold = configMUTEX_STATS_TIME() - pxStats->ulTakenAt;
+
+        /* Called from a critical section. */
+        if( ulHold > pxStats->ulMaxHold )
+        {
+            pxStats->ulMaxHold = ulHold;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_MUTEX_STATS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_RECURSIVE_MUTEXES == 1 )
 
     BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex )
@@ -1667,6 +1795,11 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
         BaseType_t xInheritanceOccurred = pdFALSE;
     #endif
 
+    #if ( configUSE_MUTEX_STATS == 1 )
+        uint32_t ulWaitStart = 0U;
+        TaskHandle_t xHolderAtWait = NULL;
+    #endif
+
     traceENTER_xQueueSemaphoreTake( xQueue, xTicksToWait );
 
     /* Check the queue pointer is not NULL. */
@@ -1716,6 +1849,21 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 }
                 #endif /* configUSE_MUTEXES */
 
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    if( xEntryTimeSet != pdFALSE )
+                    {
+                        vQueueMutexStatsWaited( &( pxQueue->xStats ), ulWaitStart, xHolderAtWait, xInheritanceOccurred );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    vQueueMutexStatsTaken( &( pxQueue->xStats ) );
+                }
+                #endif /* configUSE_MUTEX_STATS */
+
                 /* Check to see if other tasks are blocked waiting to give the
                  * semaphore, and if so, unblock the highest priority such task. */
                 if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
@@ -1759,6 +1907,21 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                      * so configure the timeout structure ready to block. */
                     vTaskInternalSetTimeOutState( &xTimeOut );
                     xEntryTimeSet = pdTRUE;
+
+                    #if ( configUSE_MUTEX_STATS == 1 )
+                    {
+                        ulWaitStart = configMUTEX_STATS_TIME();
+
+                        if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+                        {
+                            xHolderAtWait = pxQueue->u.xSemaphore.xMutexHolder;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif /* configUSE_MUTEX_STATS */
                 }
                 else
                 {
@@ -1867,6 +2030,16 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 }
                 #endif /* configUSE_MUTEXES */
 
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    taskENTER_CRITICAL();
+                    {
+                        vQueueMutexStatsWaited( &( pxQueue->xStats ), ulWaitStart, xHolderAtWait, xInheritanceOccurred );
+                    }
+                    taskEXIT_CRITICAL();
+                }
+                #endif /* configUSE_MUTEX_STATS */
+
                 traceQUEUE_RECEIVE_FAILED( pxQueue );
                 traceRETURN_xQueueSemaphoreTake( errQUEUE_EMPTY );
 
@@ -2197,6 +2370,383 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_BATCH == 1 )
+
+    BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                   const void * pvItems,
+                                   UBaseType_t uxCount,
+                                   TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        UBaseType_t uxCopied;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueSendMultiple( xQueue, pvItems, uxCount, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pvItems );
+        configASSERT( uxCount > ( UBaseType_t ) 0U );
+
+        /* Semaphores and mutexes hold no items to copy. */
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                /* Is there room for at least one item now? */
+                if( pxQueue->uxMessagesWaiting < pxQueue->uxLength )
+                {
+                    traceQUEUE_SEND( pxQueue );
+
+                    uxCopied = prvCopyMultipleToQueue( pxQueue, pvItems, uxCount );
+
+                    /* A higher priority reader is only switched to once
+                     * the whole batch is in the queue. */
+                    if( prvUnblockForItemsSent( pxQueue, uxCopied ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    taskEXIT_CRITICAL();
+
+                    traceRETURN_xQueueSendMultiple( ( BaseType_t ) uxCopied );
+
+                    return ( BaseType_t ) uxCopied;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was full and no block time is specified
+                         * (or the block time has expired) so leave now. */
+                        taskEXIT_CRITICAL();
+
+                        traceQUEUE_SEND_FAILED( pxQueue );
+                        traceRETURN_xQueueSendMultiple( 0 );
+
+                        return 0;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* Block as xQueueGenericSend() does. */
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                traceQUEUE_SEND_FAILED( pxQueue );
+                traceRETURN_xQueueSendMultiple( 0 );
+
+                return 0;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                      void * pvBuffer,
+                                      UBaseType_t uxCount,
+                                      TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        UBaseType_t uxCopied;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueReceiveMultiple( xQueue, pvBuffer, uxCount, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+        configASSERT( uxCount > ( UBaseType_t ) 0U );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                /* Is there at least one item in the queue now? */
+                if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+                {
+                    uxCopied = prvCopyMultipleFromQueue( pxQueue, pvBuffer, uxCount );
+                    traceQUEUE_RECEIVE( pxQueue );
+
+                    /* Each space freed can unblock one writer. */
+                    if( prvUnblockForItems( &( pxQueue->xTasksWaitingToSend ), uxCopied ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    taskEXIT_CRITICAL();
+
+                    traceRETURN_xQueueReceiveMultiple( ( BaseType_t ) uxCopied );
+
+                    return ( BaseType_t ) uxCopied;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was empty and no block time is specified
+                         * (or the block time has expired) so leave now. */
+                        taskEXIT_CRITICAL();
+
+                        traceQUEUE_RECEIVE_FAILED( pxQueue );
+                        traceRETURN_xQueueReceiveMultiple( 0 );
+
+                        return 0;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* Block as xQueueReceive() does. */
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The queue contains data again.  Loop back to try and
+                     * read it. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  If there is no data in the queue exit,
+                 * otherwise loop back and read it. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    traceRETURN_xQueueReceiveMultiple( 0 );
+
+                    return 0;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                          const void * pvItems,
+                                          UBaseType_t uxCount,
+                                          BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxCopied = 0U;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueSendMultipleFromISR( xQueue, pvItems, uxCount, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxQueue );
+        configASSERT( pvItems );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+        {
+            if( ( uxCount > ( UBaseType_t ) 0U ) && ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) )
+            {
+                int8_t cTxLock = pxQueue->cTxLock;
+
+                traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+                uxCopied = prvCopyMultipleToQueue( pxQueue, pvItems, uxCount );
+
+                /* The event lists are not altered while the queue is locked,
+                 * the task that unlocks it wakes a reader per item counted. */
+                if( cTxLock == queueUNLOCKED )
+                {
+                    if( ( prvUnblockForItemsSent( pxQueue, uxCopied ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    UBaseType_t uxItem;
+
+                    for( uxItem = 0U; uxItem < uxCopied; uxItem++ )
+                    {
+                        prvIncrementQueueTxLock( pxQueue, cTxLock );
+                        cTxLock = pxQueue->cTxLock;
+                    }
+                }
+            }
+            else
+            {
+                traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        traceRETURN_xQueueSendMultipleFromISR( ( BaseType_t ) uxCopied );
+
+        return ( BaseType_t ) uxCopied;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                             void * pvBuffer,
+                                             UBaseType_t uxCount,
+                                             BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxCopied = 0U;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueReceiveMultipleFromISR( xQueue, pvBuffer, uxCount, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+        {
+            if( ( uxCount > ( UBaseType_t ) 0U ) && ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) )
+            {
+                int8_t cRxLock = pxQueue->cRxLock;
+
+                traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+                uxCopied = prvCopyMultipleFromQueue( pxQueue, pvBuffer, uxCount );
+
+                if( cRxLock == queueUNLOCKED )
+                {
+                    if( ( prvUnblockForItems( &( pxQueue->xTasksWaitingToSend ), uxCopied ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    UBaseType_t uxItem;
+
+                    for( uxItem = 0U; uxItem < uxCopied; uxItem++ )
+                    {
+                        prvIncrementQueueRxLock( pxQueue, cRxLock );
+                        cRxLock = pxQueue->cRxLock;
+                    }
+                }
+            }
+            else
+            {
+                traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        traceRETURN_xQueueReceiveMultipleFromISR( ( BaseType_t ) uxCopied );
+
+        return ( BaseType_t ) uxCopied;
+    }
+
+#endif /* configUSE_QUEUE_BATCH */
+/*-----------------------------------------------------------*/
+
 UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
 {
     UBaseType_t uxReturn;
@@ -2407,6 +2957,20 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
         {
             if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
             {
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    /* Not when the mutex is first made available. */
+                    if( pxQueue->u.xSemaphore.xMutexHolder != NULL )
+                    {
+                        vQueueMutexStatsGiven( &( pxQueue->xStats ) );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_MUTEX_STATS */
+
                 /* The mutex is no longer being held. */
                 xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
                 pxQueue->u.xSemaphore.xMutexHolder = NULL;
@@ -2494,6 +3058,162 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_BATCH == 1 )
+
+    static UBaseType_t prvCopyMultipleToQueue( Queue_t * const pxQueue,
+                                               const void * pvItems,
+                                               UBaseType_t uxCount )
+    {
+        const UBaseType_t uxSpaces = ( UBaseType_t ) ( pxQueue->uxLength - pxQueue->uxMessagesWaiting );
+        size_t xBytes;
+        size_t xToTail;
+
+        /* This function is called from a critical section. */
+
+        if( uxCount > uxSpaces )
+        {
+            uxCount = uxSpaces;
+        }
+
+        /* One copy up to the end of the storage area, and one from the start
+         * if the items wrap round. */
+        xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+        xToTail = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo );
+
+        if( xBytes < xToTail )
+        {
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xBytes );
+            pxQueue->pcWriteTo += xBytes;
+        }
+        else
+        {
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xToTail );
+            ( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) &( ( ( const uint8_t * ) pvItems )[ xToTail ] ), xBytes - xToTail );
+            pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xToTail );
+        }
+
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting + uxCount );
+
+        return uxCount;
+    }
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvCopyMultipleFromQueue( Queue_t * const pxQueue,
+                                                 void * const pvBuffer,
+                                                 UBaseType_t uxCount )
+    {
+        int8_t * pcReadFrom;
+        size_t xBytes;
+        size_t xToTail;
+
+        /* This function is called from a critical section. */
+
+        if( uxCount > pxQueue->uxMessagesWaiting )
+        {
+            uxCount = pxQueue->uxMessagesWaiting;
+        }
+
+        /* pcReadFrom points at the last item read, so the first to copy is
+         * the one after it. */
+        pcReadFrom = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+
+        if( pcReadFrom >= pxQueue->u.xQueue.pcTail )
+        {
+            pcReadFrom = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+        xToTail = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadFrom );
+
+        if( xBytes <= xToTail )
+        {
+            ( void ) memcpy( pvBuffer, ( void * ) pcReadFrom, xBytes );
+            pcReadFrom += xBytes;
+        }
+        else
+        {
+            ( void ) memcpy( pvBuffer, ( void * ) pcReadFrom, xToTail );
+            ( void ) memcpy( ( void * ) &( ( ( uint8_t * ) pvBuffer )[ xToTail ] ), ( void * ) pxQueue->pcHead, xBytes - xToTail );
+            pcReadFrom = pxQueue->pcHead + ( xBytes - xToTail );
+        }
+
+        /* Leave it on the last item read, as prvCopyDataFromQueue() does. */
+        pxQueue->u.xQueue.pcReadFrom = pcReadFrom - pxQueue->uxItemSize;
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting - uxCount );
+
+        return uxCount;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvUnblockForItems( List_t * const pxEventList,
+                                          UBaseType_t uxItems )
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        /* The same tasks xQueueSend() or xQueueReceive() would unblock, one
+         * per item, but with a single reader or writer waiting that is one
+         * wake-up for the whole batch. */
+        while( ( uxItems > ( UBaseType_t ) 0U ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
+        {
+            if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+            {
+                xHigherPriorityTaskWoken = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxItems--;
+        }
+
+        return xHigherPriorityTaskWoken;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvUnblockForItemsSent( Queue_t * const pxQueue,
+                                              UBaseType_t uxItems )
+    {
+        #if ( configUSE_QUEUE_SETS == 1 )
+        {
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+            if( pxQueue->pxQueueSetContainer != NULL )
+            {
+                /* The set holds one handle per item in its member queues. */
+                while( uxItems > ( UBaseType_t ) 0U )
+                {
+                    if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                    {
+                        xHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    uxItems--;
+                }
+
+                return xHigherPriorityTaskWoken;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_QUEUE_SETS */
+
+        return prvUnblockForItems( &( pxQueue->xTasksWaitingToReceive ), uxItems );
+    }
+
+#endif /* configUSE_QUEUE_BATCH */
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
     /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
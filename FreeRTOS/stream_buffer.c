@@ -314,6 +314,22 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t * pxStreamBuffer,
                                       size_t xCount,
                                       size_t xTail ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+/*
+ * Publish xDataLengthBytes written in place at the buffer's xHead, or mark as
+ * free xDataLengthBytes read in place at its xTail, wrapping back to the start
+ * of the storage area.  Return pdTRUE if the task waiting on the other side
+ * should be told.
+ */
+    static BaseType_t prvCommitBytesSent( StreamBuffer_t * const pxStreamBuffer,
+                                          size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+    static BaseType_t prvCommitBytesReceived( StreamBuffer_t * const pxStreamBuffer,
+                                              size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
  * initialise the members of the newly created stream buffer structure.
@@ -1273,6 +1289,348 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+                                     uint8_t ** ppucData,
+                                     TickType_t xTicksToWait )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xSpace, xReturn;
+        TimeOut_t xTimeOut;
+
+        traceENTER_xStreamBufferSendAcquire( xStreamBuffer, ppucData, xTicksToWait );
+
+        configASSERT( ppucData );
+        configASSERT( pxStreamBuffer );
+
+        /* The space is handed out as it lies in the buffer, which a message
+         * buffer cannot do as each message is written after its length. */
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+        if( ( xSpace == ( size_t ) 0 ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+
+            do
+            {
+                /* Wait until at least one byte is free, as xStreamBufferSend()
+                 * does for the whole of its data. */
+                taskENTER_CRITICAL();
+                {
+                    xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+                    if( xSpace == ( size_t ) 0 )
+                    {
+                        ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                        /* Should only be one writer. */
+                        configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+                        pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+                    }
+                    else
+                    {
+                        taskEXIT_CRITICAL();
+                        break;
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+                ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+                pxStreamBuffer->xTaskWaitingToSend = NULL;
+            } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+
+            if( xSpace == ( size_t ) 0 )
+            {
+                xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Only up to the end of the storage area, the rest of the space starts
+         * again at the beginning and is acquired after this part is
+         * committed. */
+        xReturn = configMIN( xSpace, pxStreamBuffer->xLength - pxStreamBuffer->xHead );
+        *ppucData = &( pxStreamBuffer->pucBuffer[ pxStreamBuffer->xHead ] );
+
+        traceRETURN_xStreamBufferSendAcquire( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xDataLengthBytes )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        traceENTER_vStreamBufferSendCommit( xStreamBuffer, xDataLengthBytes );
+
+        if( prvCommitBytesSent( pxStreamBuffer, xDataLengthBytes ) != pdFALSE )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_vStreamBufferSendCommit();
+    }
+/*-----------------------------------------------------------*/
+
+    void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                         size_t xDataLengthBytes,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        traceENTER_vStreamBufferSendCommitFromISR( xStreamBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken );
+
+        if( prvCommitBytesSent( pxStreamBuffer, xDataLengthBytes ) != pdFALSE )
+        {
+            prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_vStreamBufferSendCommitFromISR();
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+                                        uint8_t ** ppucData,
+                                        TickType_t xTicksToWait )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xBytesAvailable, xMinimumBytes, xReturn = 0;
+
+        traceENTER_xStreamBufferReceiveAcquire( xStreamBuffer, ppucData, xTicksToWait );
+
+        configASSERT( ppucData );
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+        /* As xStreamBufferReceive(), a batching buffer only hands out data once
+         * it holds more than the trigger level. */
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_BATCHING_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xMinimumBytes = pxStreamBuffer->xTriggerLevelBytes;
+        }
+        else
+        {
+            xMinimumBytes = 0;
+        }
+
+        if( xTicksToWait != ( TickType_t ) 0 )
+        {
+            taskENTER_CRITICAL();
+            {
+                xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+                if( xBytesAvailable <= xMinimumBytes )
+                {
+                    ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                    /* Should only be one reader. */
+                    configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+                    pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xBytesAvailable <= xMinimumBytes )
+            {
+                traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+                ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+                pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+                xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+        }
+
+        if( xBytesAvailable > xMinimumBytes )
+        {
+            /* Only up to the end of the storage area, data that wrapped round
+             * to the beginning is acquired after this part is committed. */
+            xReturn = configMIN( xBytesAvailable, pxStreamBuffer->xLength - pxStreamBuffer->xTail );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        *ppucData = &( pxStreamBuffer->pucBuffer[ pxStreamBuffer->xTail ] );
+
+        traceRETURN_xStreamBufferReceiveAcquire( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vStreamBufferReceiveCommit( StreamBufferHandle_t xStreamBuffer,
+                                     size_t xDataLengthBytes )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        traceENTER_vStreamBufferReceiveCommit( xStreamBuffer, xDataLengthBytes );
+
+        if( prvCommitBytesReceived( pxStreamBuffer, xDataLengthBytes ) != pdFALSE )
+        {
+            prvRECEIVE_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_vStreamBufferReceiveCommit();
+    }
+/*-----------------------------------------------------------*/
+
+    void vStreamBufferReceiveCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                            size_t xDataLengthBytes,
+                                            BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        traceENTER_vStreamBufferReceiveCommitFromISR( xStreamBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken );
+
+        if( prvCommitBytesReceived( pxStreamBuffer, xDataLengthBytes ) != pdFALSE )
+        {
+            prvRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_vStreamBufferReceiveCommitFromISR();
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCommitBytesSent( StreamBuffer_t * const pxStreamBuffer,
+                                          size_t xDataLengthBytes )
+    {
+        size_t xNextHead;
+        BaseType_t xReturn = pdFALSE;
+
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+        /* No more than the last xStreamBufferSendAcquire() handed out, which
+         * never runs past the end of the storage area. */
+        configASSERT( xDataLengthBytes <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+        configASSERT( xDataLengthBytes <= ( pxStreamBuffer->xLength - pxStreamBuffer->xHead ) );
+
+        if( xDataLengthBytes > ( size_t ) 0 )
+        {
+            xNextHead = pxStreamBuffer->xHead + xDataLengthBytes;
+
+            if( xNextHead >= pxStreamBuffer->xLength )
+            {
+                xNextHead -= pxStreamBuffer->xLength;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The bytes were written in place before this call, publishing the
+             * new head is all that makes them readable. */
+            pxStreamBuffer->xHead = xNextHead;
+
+            traceSTREAM_BUFFER_SEND( pxStreamBuffer, xDataLengthBytes );
+
+            /* Was a task waiting for the data? */
+            if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCommitBytesReceived( StreamBuffer_t * const pxStreamBuffer,
+                                              size_t xDataLengthBytes )
+    {
+        size_t xNextTail;
+        BaseType_t xReturn = pdFALSE;
+
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+        /* No more than the last xStreamBufferReceiveAcquire() handed out. */
+        configASSERT( xDataLengthBytes <= prvBytesInBuffer( pxStreamBuffer ) );
+        configASSERT( xDataLengthBytes <= ( pxStreamBuffer->xLength - pxStreamBuffer->xTail ) );
+
+        if( xDataLengthBytes > ( size_t ) 0 )
+        {
+            xNextTail = pxStreamBuffer->xTail + xDataLengthBytes;
+
+            if( xNextTail >= pxStreamBuffer->xLength )
+            {
+                xNextTail -= pxStreamBuffer->xLength;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The bytes are only free for the writer to reuse once the new
+             * tail is published. */
+            pxStreamBuffer->xTail = xNextTail;
+
+            traceSTREAM_BUFFER_RECEIVE( pxStreamBuffer, xDataLengthBytes );
+
+            /* Was a task waiting for space in the buffer? */
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+
 static size_t prvReadMessageFromBuffer( StreamBuffer_t * pxStreamBuffer,
                                         void * pvRxData,
                                         size_t xBufferLengthBytes,
@@ -259,9 +259,22 @@
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* The timing wheel holds wake times either side of the tick wrap, but
+ * xNextTaskUnblockTime only covers those before it, the same as the delayed
+ * list does.  So it is worked out again once the tick count wraps. */
+    #define taskSWITCH_DELAYED_LISTS()                                \
+    do {                                                              \
+        xNumOfOverflows = ( BaseType_t ) ( xNumOfOverflows + 1 );     \
+        prvResetNextTaskUnblockTime();                                \
+    } while( 0 )
+
+#else /* configUSE_DELAYED_TASK_WHEEL */
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
-#define taskSWITCH_DELAYED_LISTS()                                                \
+    #define taskSWITCH_DELAYED_LISTS()                                                \
     do {                                                                          \
         List_t * pxTemp;                                                          \
                                                                                   \
@@ -275,6 +288,8 @@
         prvResetNextTaskUnblockTime();                                            \
     } while( 0 )
 
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -473,10 +488,35 @@ typedef tskTCB TCB_t;
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* Delayed tasks are kept on a hierarchical timing wheel instead of a list
+ * sorted by wake time, so delaying a task is O(1) however many others are
+ * delayed.  Each level has taskWHEEL_SLOTS slots, and a slot on level n
+ * covers 2^( n * configDELAYED_TASK_WHEEL_BITS ) ticks.  A task goes on the
+ * level its delay falls in, in the slot its wake time falls in.  When the tick
+ * count reaches the start of a slot above level 0, the tasks in it move down
+ * to the level their remaining delay now falls in, and every task in the level
+ * 0 slot of the current tick is due.  A task moves at most once per level, so
+ * expiry is amortised O(1) too. */
+    #define taskWHEEL_SLOTS                    ( ( UBaseType_t ) 1U << configDELAYED_TASK_WHEEL_BITS )
+    #define taskWHEEL_LEVELS                   ( ( ( sizeof( TickType_t ) * 8U ) + configDELAYED_TASK_WHEEL_BITS - 1U ) / configDELAYED_TASK_WHEEL_BITS )
+    #define taskWHEEL_SLOT( uxLevel, uxSlot )  ( &( xDelayedTaskWheel[ ( ( uxLevel ) * taskWHEEL_SLOTS ) + ( uxSlot ) ] ) )
+    #define taskWHEEL_FIRST                    ( taskWHEEL_SLOT( 0U, 0U ) )
+    #define taskWHEEL_LAST                     ( taskWHEEL_SLOT( taskWHEEL_LEVELS - 1U, taskWHEEL_SLOTS - 1U ) )
+
+PRIVILEGED_DATA static List_t xDelayedTaskWheel[ taskWHEEL_LEVELS * taskWHEEL_SLOTS ]; /**< Delayed tasks, by level then slot. */
+
+#else
+
 PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
 PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -529,6 +569,14 @@ static const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
  * from either an ISR or a task. */
 PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t ) 0U;
 
+#if ( configUSE_TASK_DELAY_SLACK == 1 )
+
+/* The number of ticks on which xTaskIncrementTick() unblocked a task, see
+ * ulTaskGetWakeTicks(). */
+PRIVILEGED_DATA static uint32_t ulWakeTicks = 0U;
+
+#endif
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 /* Do not move these variables to function scope as doing so prevents the
@@ -698,6 +746,48 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/*
+ * Put a delayed task's state list item on the timing wheel, from its item
+ * value (the wake time) and the current tick count.
+ */
+    static void prvWheelInsert( ListItem_t * pxItem,
+                                TickType_t xNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the tasks out of every slot whose start the tick count passes going
+ * from xFrom to xTo.  No task may be due before xTo.
+ */
+    static void prvWheelAdvance( TickType_t xFrom,
+                                 TickType_t xTo ) PRIVILEGED_FUNCTION;
+
+/*
+ * The wake time of the next task to leave the wheel, or portMAX_DELAY if the
+ * wheel is empty or the next wake time is past the tick wrap.
+ */
+    static TickType_t prvWheelNextUnblockTime( TickType_t xNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Put the calling task on the wheel, see prvAddCurrentTaskToDelayedList().
+ */
+    static void prvWheelDelayCurrentTask( TickType_t xTimeToWake,
+                                          TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
+#if ( configUSE_TASK_DELAY_SLACK == 1 )
+
+/*
+ * The tick in [ xTimeToWake, xTimeToWake + xSlack ] a delayed task should
+ * wake on: the earliest one another task is already due on, else the one
+ * with the most low order zero bits.  Called with the scheduler suspended.
+ */
+    static TickType_t prvCoalesceWakeTime( TickType_t xTimeToWake,
+                                           TickType_t xSlack ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TASK_DELAY_SLACK */
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -2503,6 +2593,139 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 #endif /* INCLUDE_vTaskDelay */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_DELAY_SLACK == 1 )
+
+    void vTaskDelayWithSlack( const TickType_t xTicksToDelay,
+                              const TickType_t xSlack )
+    {
+        TickType_t xTimeToWake;
+        BaseType_t xAlreadyYielded = pdFALSE;
+
+        traceENTER_vTaskDelayWithSlack( xTicksToDelay, xSlack );
+
+        /* A delay time of zero just forces a reschedule. */
+        if( xTicksToDelay > ( TickType_t ) 0U )
+        {
+            vTaskSuspendAll();
+            {
+                const TickType_t xConstTickCount = xTickCount;
+
+                configASSERT( uxSchedulerSuspended == 1U );
+
+                traceTASK_DELAY();
+
+                xTimeToWake = prvCoalesceWakeTime( xConstTickCount + xTicksToDelay, xSlack );
+                prvAddCurrentTaskToDelayedList( xTimeToWake - xConstTickCount, pdFALSE );
+            }
+            xAlreadyYielded = xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Force a reschedule if xTaskResumeAll has not already done so, we may
+         * have put ourselves to sleep. */
+        if( xAlreadyYielded == pdFALSE )
+        {
+            taskYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_vTaskDelayWithSlack();
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTaskDelayUntilWithSlack( TickType_t * const pxPreviousWakeTime,
+                                         const TickType_t xTimeIncrement,
+                                         const TickType_t xSlack )
+    {
+        TickType_t xTimeToWake;
+        BaseType_t xAlreadyYielded, xShouldDelay = pdFALSE;
+
+        traceENTER_xTaskDelayUntilWithSlack( pxPreviousWakeTime, xTimeIncrement, xSlack );
+
+        configASSERT( pxPreviousWakeTime );
+        configASSERT( ( xTimeIncrement > 0U ) );
+
+        vTaskSuspendAll();
+        {
+            const TickType_t xConstTickCount = xTickCount;
+
+            configASSERT( uxSchedulerSuspended == 1U );
+
+            /* Counting from the previous wake time covers the tick count
+             * wrapping in between, as the two cases in xTaskDelayUntil() do.
+             * The wake time is due unless the whole increment has gone. */
+            if( ( TickType_t ) ( xConstTickCount - *pxPreviousWakeTime ) < xTimeIncrement )
+            {
+                xShouldDelay = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The next period counts from the requested wake time, not the
+             * one the slack moved it to. */
+            *pxPreviousWakeTime += xTimeIncrement;
+
+            if( xShouldDelay != pdFALSE )
+            {
+                xTimeToWake = prvCoalesceWakeTime( *pxPreviousWakeTime, xSlack );
+
+                traceTASK_DELAY_UNTIL( xTimeToWake );
+
+                prvAddCurrentTaskToDelayedList( xTimeToWake - xConstTickCount, pdFALSE );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        xAlreadyYielded = xTaskResumeAll();
+
+        /* Force a reschedule if xTaskResumeAll has not already done so, we may
+         * have put ourselves to sleep. */
+        if( xAlreadyYielded == pdFALSE )
+        {
+            taskYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_xTaskDelayUntilWithSlack( xShouldDelay );
+
+        return xShouldDelay;
+    }
+/*-----------------------------------------------------------*/
+
+    uint32_t ulTaskGetWakeTicks( void )
+    {
+        uint32_t ulReturn;
+
+        traceENTER_ulTaskGetWakeTicks();
+
+        /* The count is wider than the PIC24 can read in one go. */
+        taskENTER_CRITICAL();
+        {
+            ulReturn = ulWakeTicks;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_ulTaskGetWakeTicks( ulReturn );
+
+        return ulReturn;
+    }
+
+#endif /* configUSE_TASK_DELAY_SLACK */
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_eTaskGetState == 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_xTaskAbortDelay == 1 ) )
 
     eTaskState eTaskGetState( TaskHandle_t xTask )
@@ -2510,8 +2733,12 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         eTaskState eReturn;
         List_t const * pxStateList;
         List_t const * pxEventList;
-        List_t const * pxDelayedList;
-        List_t const * pxOverflowedDelayedList;
+
+        #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+            List_t const * pxDelayedList;
+            List_t const * pxOverflowedDelayedList;
+        #endif
+
         const TCB_t * const pxTCB = xTask;
 
         traceENTER_eTaskGetState( xTask );
@@ -2531,8 +2758,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             {
                 pxStateList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
                 pxEventList = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
-                pxDelayedList = pxDelayedTaskList;
-                pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+
+                #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+                {
+                    pxDelayedList = pxDelayedTaskList;
+                    pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+                }
+                #endif
             }
             taskEXIT_CRITICAL();
 
@@ -2543,7 +2775,11 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * item is currently placed on. */
                 eReturn = eReady;
             }
-            else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                else if( ( pxStateList >= taskWHEEL_FIRST ) && ( pxStateList <= taskWHEEL_LAST ) )
+            #else
+                else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+            #endif
             {
                 /* The task being queried is referenced from one of the Blocked
                  * lists. */
@@ -4340,15 +4576,28 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
             } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY );
 
             /* Search the delayed lists. */
-            if( pxTCB == NULL )
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
             {
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
-            }
+                List_t * pxList;
 
-            if( pxTCB == NULL )
+                for( pxList = taskWHEEL_FIRST; ( pxList <= taskWHEEL_LAST ) && ( pxTCB == NULL ); pxList++ )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( pxList, pcNameToQuery );
+                }
+            }
+            #else
             {
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+                }
+
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+                }
             }
+            #endif /* configUSE_DELAYED_TASK_WHEEL */
 
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
@@ -4460,8 +4709,21 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
 
                 /* Fill in an TaskStatus_t structure with information on each
                  * task in the Blocked state. */
-                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
-                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
+                #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                {
+                    List_t * pxList;
+
+                    for( pxList = taskWHEEL_FIRST; pxList <= taskWHEEL_LAST; pxList++ )
+                    {
+                        uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), pxList, eBlocked ) );
+                    }
+                }
+                #else
+                {
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
+                }
+                #endif /* configUSE_DELAYED_TASK_WHEEL */
 
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
@@ -4589,6 +4851,14 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
             mtCOVERAGE_TEST_MARKER();
         }
 
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        {
+            /* The tick count skips the slot starts in between, so the tasks
+             * in those slots are moved down now.  None are due yet. */
+            prvWheelAdvance( xTickCount, ( TickType_t ) ( xTickCount + xTicksToJump ) );
+        }
+        #endif
+
         xTickCount += xTicksToJump;
 
         traceINCREASE_TICK_COUNT( xTicksToJump );
@@ -4726,8 +4996,13 @@ BaseType_t xTaskIncrementTick( void )
 {
     TCB_t * pxTCB;
     TickType_t xItemValue;
+    List_t * volatile pxDelayedList;
     BaseType_t xSwitchRequired = pdFALSE;
 
+    #if ( configUSE_TASK_DELAY_SLACK == 1 )
+        BaseType_t xTaskWoken = pdFALSE;
+    #endif
+
     traceENTER_xTaskIncrementTick();
 
     /* Called by the portable layer each time a tick interrupt occurs.
@@ -4758,22 +5033,50 @@ BaseType_t xTaskIncrementTick( void )
             mtCOVERAGE_TEST_MARKER();
         }
 
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        {
+            /* Tasks in a slot that starts at this tick move down a level,
+             * then every task in this tick's level 0 slot is due, with its
+             * item value equal to the tick count. */
+            prvWheelAdvance( ( TickType_t ) ( xConstTickCount - 1U ), xConstTickCount );
+            pxDelayedList = taskWHEEL_SLOT( 0U, ( UBaseType_t ) ( xConstTickCount & ( taskWHEEL_SLOTS - 1U ) ) );
+        }
+        #else
+        {
+            pxDelayedList = pxDelayedTaskList;
+        }
+        #endif
+
         /* See if this tick has made a timeout expire.  Tasks are stored in
          * the  queue in the order of their wake time - meaning once one task
          * has been found whose block time has not expired there is no need to
          * look any further down the list. */
-        if( xConstTickCount >= xNextTaskUnblockTime )
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            if( ( listLIST_IS_EMPTY( pxDelayedList ) == pdFALSE ) || ( xConstTickCount >= xNextTaskUnblockTime ) )
+        #else
+            if( xConstTickCount >= xNextTaskUnblockTime )
+        #endif
         {
             for( ; ; )
             {
-                if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+                if( listLIST_IS_EMPTY( pxDelayedList ) != pdFALSE )
                 {
-                    /* The delayed list is empty.  Set xNextTaskUnblockTime
-                     * to the maximum possible value so it is extremely
-                     * unlikely that the
-                     * if( xTickCount >= xNextTaskUnblockTime ) test will pass
-                     * next time through. */
-                    xNextTaskUnblockTime = portMAX_DELAY;
+                    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                    {
+                        /* Nothing more is due this tick, look for the next
+                         * wake time across the wheel. */
+                        prvResetNextTaskUnblockTime();
+                    }
+                    #else
+                    {
+                        /* The delayed list is empty.  Set xNextTaskUnblockTime
+                         * to the maximum possible value so it is extremely
+                         * unlikely that the
+                         * if( xTickCount >= xNextTaskUnblockTime ) test will pass
+                         * next time through. */
+                        xNextTaskUnblockTime = portMAX_DELAY;
+                    }
+                    #endif
                     break;
                 }
                 else
@@ -4785,7 +5088,7 @@ BaseType_t xTaskIncrementTick( void )
                     /* MISRA Ref 11.5.3 [Void pointer assignment] */
                     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                     /* coverity[misra_c_2012_rule_11_5_violation] */
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedList );
                     xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
 
                     if( xConstTickCount < xItemValue )
@@ -4821,6 +5124,12 @@ BaseType_t xTaskIncrementTick( void )
                      * list. */
                     prvAddTaskToReadyList( pxTCB );
 
+                    #if ( configUSE_TASK_DELAY_SLACK == 1 )
+                    {
+                        xTaskWoken = pdTRUE;
+                    }
+                    #endif
+
                     /* A task being unblocked cannot cause an immediate
                      * context switch if preemption is turned off. */
                     #if ( configUSE_PREEMPTION == 1 )
@@ -4855,6 +5164,20 @@ BaseType_t xTaskIncrementTick( void )
             }
         }
 
+        #if ( configUSE_TASK_DELAY_SLACK == 1 )
+        {
+            /* Count the tick once however many tasks it woke. */
+            if( xTaskWoken != pdFALSE )
+            {
+                ulWakeTicks++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif
+
         /* Tasks of equal priority to the currently running task will share
          * processing time (time slice) if preemption is on, and the application
          * writer has not explicitly turned time slicing off. */
@@ -5343,7 +5666,8 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
      * list.  It is safe to access the event list here because it is part of an
      * event group implementation - and interrupts don't access event groups
      * directly (instead they access them indirectly by pending function calls to
-     * the task level). */
+     * the task level, or with xEventGroupSetBitsFromISRDirect(), which leaves
+     * the list alone while the event group is locked by the calling task). */
     listINSERT_END( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
     prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
@@ -5556,6 +5880,89 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const TickType_t xItemValue )
+    {
+        TCB_t * pxUnblockedTCB;
+        BaseType_t xReturn;
+
+        traceENTER_xTaskRemoveFromUnorderedEventListFromISR( pxEventListItem, xItemValue );
+
+        /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION, from a task or
+         * an ISR.  It is used by the event groups implementation to unblock a
+         * task without suspending the scheduler, so the scheduler may or may
+         * not be suspended here, as with xTaskRemoveFromEventList(). */
+
+        /* Store the new item value in the event list. */
+        listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem );
+        configASSERT( pxUnblockedTCB );
+        listREMOVE_ITEM( pxEventListItem );
+
+        if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
+        {
+            listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
+            prvAddTaskToReadyList( pxUnblockedTCB );
+
+            #if ( configUSE_TICKLESS_IDLE != 0 )
+            {
+                /* See xTaskRemoveFromEventList(). */
+                prvResetNextTaskUnblockTime();
+            }
+            #endif
+        }
+        else
+        {
+            /* The delayed and ready lists cannot be accessed, so hold this task
+             * pending until the scheduler is resumed. */
+            listINSERT_END( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+        }
+
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+            {
+                /* Mark that a yield is pending in case the caller does not use
+                 * the return value. */
+                xReturn = pdTRUE;
+                xYieldPendings[ 0 ] = pdTRUE;
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+        }
+        #else /* #if ( configNUMBER_OF_CORES == 1 ) */
+        {
+            xReturn = pdFALSE;
+
+            #if ( configUSE_PREEMPTION == 1 )
+            {
+                prvYieldForTask( pxUnblockedTCB );
+
+                if( xYieldPendings[ portGET_CORE_ID() ] != pdFALSE )
+                {
+                    xReturn = pdTRUE;
+                }
+            }
+            #endif /* #if ( configUSE_PREEMPTION == 1 ) */
+        }
+        #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
+
+        traceRETURN_xTaskRemoveFromUnorderedEventListFromISR( xReturn );
+
+        return xReturn;
+    }
+
+#endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
     traceENTER_vTaskSetTimeOutState( pxTimeOut );
@@ -6073,8 +6480,22 @@ static void prvInitialiseTaskLists( void )
         vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
     }
 
-    vListInitialise( &xDelayedTaskList1 );
-    vListInitialise( &xDelayedTaskList2 );
+    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    {
+        List_t * pxList;
+
+        for( pxList = taskWHEEL_FIRST; pxList <= taskWHEEL_LAST; pxList++ )
+        {
+            vListInitialise( pxList );
+        }
+    }
+    #else
+    {
+        vListInitialise( &xDelayedTaskList1 );
+        vListInitialise( &xDelayedTaskList2 );
+    }
+    #endif
+
     vListInitialise( &xPendingReadyList );
 
     #if ( INCLUDE_vTaskDelete == 1 )
@@ -6089,10 +6510,14 @@ static void prvInitialiseTaskLists( void )
     }
     #endif /* INCLUDE_vTaskSuspend */
 
-    /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-     * using list2. */
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+    {
+        /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
+         * using list2. */
+        pxDelayedTaskList = &xDelayedTaskList1;
+        pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -6512,25 +6937,331 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
-static void prvResetNextTaskUnblockTime( void )
-{
-    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+    static void prvResetNextTaskUnblockTime( void )
     {
-        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-         * the maximum possible value so it is  extremely unlikely that the
-         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-         * there is an item in the delayed list. */
-        xNextTaskUnblockTime = portMAX_DELAY;
+        xNextTaskUnblockTime = prvWheelNextUnblockTime( xTickCount );
     }
-    else
+
+#else /* configUSE_DELAYED_TASK_WHEEL */
+
+    static void prvResetNextTaskUnblockTime( void )
     {
-        /* The new current delayed list is not empty, get the value of
-         * the item at the head of the delayed list.  This is the time at
-         * which the task at the head of the delayed list should be removed
-         * from the Blocked state. */
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+        {
+            /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+             * the maximum possible value so it is  extremely unlikely that the
+             * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+             * there is an item in the delayed list. */
+            xNextTaskUnblockTime = portMAX_DELAY;
+        }
+        else
+        {
+            /* The new current delayed list is not empty, get the value of
+             * the item at the head of the delayed list.  This is the time at
+             * which the task at the head of the delayed list should be removed
+             * from the Blocked state. */
+            xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        }
     }
-}
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* The number of slots in use on a level.  The top level only has the tick
+ * count bits left over from the levels below. */
+    #define taskWHEEL_LEVEL_SLOTS( uxShift )                                                    \
+    ( ( ( ( sizeof( TickType_t ) * 8U ) - ( uxShift ) ) < configDELAYED_TASK_WHEEL_BITS ) ?     \
+      ( ( UBaseType_t ) 1U << ( ( sizeof( TickType_t ) * 8U ) - ( uxShift ) ) ) : taskWHEEL_SLOTS )
+
+    static void prvWheelInsert( ListItem_t * pxItem,
+                                TickType_t xNow )
+    {
+        const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( pxItem );
+        TickType_t xDelay = ( TickType_t ) ( xTimeToWake - xNow );
+        UBaseType_t uxLevel = 0U;
+        UBaseType_t uxShift = 0U;
+
+        /* The level is the number of whole slot widths in the delay, the
+         * slot is the wake time's digit on that level. */
+        while( ( xDelay >> configDELAYED_TASK_WHEEL_BITS ) != ( TickType_t ) 0U )
+        {
+            xDelay >>= configDELAYED_TASK_WHEEL_BITS;
+            uxLevel++;
+            uxShift += configDELAYED_TASK_WHEEL_BITS;
+        }
+
+        listINSERT_END( taskWHEEL_SLOT( uxLevel, ( UBaseType_t ) ( xTimeToWake >> uxShift ) & ( taskWHEEL_SLOTS - 1U ) ), pxItem );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelAdvance( TickType_t xFrom,
+                                 TickType_t xTo )
+    {
+        const TickType_t xTicks = ( TickType_t ) ( xTo - xFrom );
+        TickType_t xLow;
+        TickType_t xStarts;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift;
+        UBaseType_t uxSlots;
+        UBaseType_t uxSlot;
+        List_t * pxList;
+        ListItem_t * pxItem;
+
+        /* Level 0 tasks never move, they are taken off when due. */
+        for( uxLevel = 1U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+        {
+            uxShift = uxLevel * configDELAYED_TASK_WHEEL_BITS;
+            xLow = ( TickType_t ) ( ( ( TickType_t ) 1U << uxShift ) - 1U );
+
+            /* Slot starts on this level in ( xFrom, xTo ].  There are never
+             * more on a higher level, so stop at the first level with none. */
+            xStarts = ( TickType_t ) ( ( xTicks >> uxShift ) + ( ( ( xFrom & xLow ) + ( xTicks & xLow ) ) >> uxShift ) );
+
+            if( xStarts == ( TickType_t ) 0U )
+            {
+                break;
+            }
+
+            /* A jump of a whole turn or more starts every slot on the level,
+             * once each is enough as nothing moves back up to it. */
+            uxSlots = taskWHEEL_LEVEL_SLOTS( uxShift );
+
+            if( xStarts > ( TickType_t ) uxSlots )
+            {
+                xStarts = ( TickType_t ) uxSlots;
+            }
+
+            uxSlot = ( UBaseType_t ) ( xFrom >> uxShift );
+
+            while( xStarts > ( TickType_t ) 0U )
+            {
+                xStarts--;
+                uxSlot++;
+                pxList = taskWHEEL_SLOT( uxLevel, uxSlot & ( uxSlots - 1U ) );
+
+                /* The remaining delay of each task is under one slot width
+                 * of this level, so it always goes to a lower level. */
+                while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+                {
+                    pxItem = listGET_HEAD_ENTRY( pxList );
+                    listREMOVE_ITEM( pxItem );
+                    prvWheelInsert( pxItem, xTo );
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvWheelNextUnblockTime( TickType_t xNow )
+    {
+        TickType_t xNearest = ( TickType_t ) 0U;
+        TickType_t xDelay;
+        BaseType_t xFound = pdFALSE;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift;
+        UBaseType_t uxSlots;
+        UBaseType_t uxSlot;
+        UBaseType_t uxNext;
+        List_t * pxList;
+        ListItem_t const * pxItem;
+
+        for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+        {
+            uxShift = uxLevel * configDELAYED_TASK_WHEEL_BITS;
+            uxSlots = taskWHEEL_LEVEL_SLOTS( uxShift );
+            uxSlot = ( UBaseType_t ) ( xNow >> uxShift );
+
+            /* The first slot in use after the current one holds the
+             * earliest wake time on this level.  A level 0 slot only holds
+             * tasks due at its own tick, higher slots are searched. */
+            for( uxNext = 1U; uxNext <= uxSlots; uxNext++ )
+            {
+                pxList = taskWHEEL_SLOT( uxLevel, ( uxSlot + uxNext ) & ( uxSlots - 1U ) );
+
+                if( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+                {
+                    for( pxItem = listGET_HEAD_ENTRY( pxList ); pxItem != listGET_END_MARKER( pxList ); pxItem = listGET_NEXT( pxItem ) )
+                    {
+                        xDelay = ( TickType_t ) ( listGET_LIST_ITEM_VALUE( pxItem ) - xNow );
+
+                        if( ( xFound == pdFALSE ) || ( xDelay < xNearest ) )
+                        {
+                            xNearest = xDelay;
+                            xFound = pdTRUE;
+                        }
+
+                        if( uxLevel == 0U )
+                        {
+                            break;
+                        }
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        if( xFound == pdFALSE )
+        {
+            return portMAX_DELAY;
+        }
+
+        /* A wake time past the tick wrap is picked up once the tick count
+         * has wrapped, see taskSWITCH_DELAYED_LISTS(). */
+        if( ( TickType_t ) ( xNow + xNearest ) < xNow )
+        {
+            return portMAX_DELAY;
+        }
+
+        return ( TickType_t ) ( xNow + xNearest );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelDelayCurrentTask( TickType_t xTimeToWake,
+                                          TickType_t xConstTickCount )
+    {
+        if( xTimeToWake == xConstTickCount )
+        {
+            /* This tick's level 0 slot has already been emptied.  The
+             * delayed list would wake the task on the next tick, so go in
+             * that tick's slot. */
+            xTimeToWake++;
+            listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
+        }
+
+        prvWheelInsert( &( pxCurrentTCB->xStateListItem ), xConstTickCount );
+
+        if( xTimeToWake < xConstTickCount )
+        {
+            traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+        }
+        else
+        {
+            traceMOVED_TASK_TO_DELAYED_LIST();
+
+            if( xTimeToWake < xNextTaskUnblockTime )
+            {
+                xNextTaskUnblockTime = xTimeToWake;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_DELAY_SLACK == 1 )
+
+    static TickType_t prvCoalesceWakeTime( TickType_t xTimeToWake,
+                                           TickType_t xSlack )
+    {
+        const TickType_t xConstTickCount = xTickCount;
+        const TickType_t xFirst = ( TickType_t ) ( xTimeToWake - xConstTickCount );
+        TickType_t xLast;
+        TickType_t xOffset;
+        TickType_t xEnd;
+        TickType_t xBit;
+
+        if( xSlack == ( TickType_t ) 0U )
+        {
+            return xTimeToWake;
+        }
+
+        /* The window is kept as offsets from the tick count, so it can cross
+         * the tick wrap.  It cannot go past the longest delay there is. */
+        xLast = ( TickType_t ) ( xFirst + xSlack );
+
+        if( xLast < xFirst )
+        {
+            xLast = portMAX_DELAY;
+        }
+
+        /* A tick another task already wakes on costs no extra wake-up. */
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        {
+            /* A level 0 slot holds only tasks due on its own tick, up to a
+             * turn of the level ahead.  Past that the next unblock time is
+             * all there is to go on. */
+            xEnd = ( xLast < ( TickType_t ) ( taskWHEEL_SLOTS - 1U ) ) ? xLast : ( TickType_t ) ( taskWHEEL_SLOTS - 1U );
+
+            for( xOffset = xFirst; xOffset <= xEnd; xOffset++ )
+            {
+                if( listLIST_IS_EMPTY( taskWHEEL_SLOT( 0U, ( UBaseType_t ) ( ( xConstTickCount + xOffset ) & ( taskWHEEL_SLOTS - 1U ) ) ) ) == pdFALSE )
+                {
+                    return ( TickType_t ) ( xConstTickCount + xOffset );
+                }
+            }
+
+            xOffset = ( TickType_t ) ( xNextTaskUnblockTime - xConstTickCount );
+
+            if( ( xNextTaskUnblockTime != portMAX_DELAY ) && ( xOffset >= xFirst ) && ( xOffset <= xLast ) )
+            {
+                return xNextTaskUnblockTime;
+            }
+        }
+        #else /* configUSE_DELAYED_TASK_WHEEL */
+        {
+            List_t * const pxLists[ 2 ] = { pxDelayedTaskList, pxOverflowDelayedTaskList };
+            ListItem_t const * pxItem;
+            UBaseType_t uxList;
+
+            /* The delayed list then the overflow list is every wake time in
+             * order, so stop at the first one past the window. */
+            for( uxList = 0U; uxList < 2U; uxList++ )
+            {
+                for( pxItem = listGET_HEAD_ENTRY( pxLists[ uxList ] ); pxItem != listGET_END_MARKER( pxLists[ uxList ] ); pxItem = listGET_NEXT( pxItem ) )
+                {
+                    xOffset = ( TickType_t ) ( listGET_LIST_ITEM_VALUE( pxItem ) - xConstTickCount );
+
+                    if( xOffset > xLast )
+                    {
+                        break;
+                    }
+
+                    if( xOffset >= xFirst )
+                    {
+                        return listGET_LIST_ITEM_VALUE( pxItem );
+                    }
+                }
+            }
+        }
+        #endif /* configUSE_DELAYED_TASK_WHEEL */
+
+        /* Otherwise take the tick on the coarsest power of two boundary, where
+         * other slack delays are likely to land too.  A window over the tick
+         * wrap holds tick 0. */
+        xEnd = ( TickType_t ) ( xConstTickCount + xLast );
+
+        if( xEnd < xTimeToWake )
+        {
+            return ( TickType_t ) 0U;
+        }
+
+        /* The highest bit the two ends differ in is the boundary, unless the
+         * window already starts on one at least as coarse. */
+        xBit = ( TickType_t ) ( xTimeToWake ^ xEnd );
+
+        while( ( xBit & ( TickType_t ) ( xBit - 1U ) ) != ( TickType_t ) 0U )
+        {
+            xBit &= ( TickType_t ) ( xBit - 1U );
+        }
+
+        if( ( xBit == ( TickType_t ) 0U ) || ( ( xTimeToWake & ( TickType_t ) ( xBit | ( xBit - 1U ) ) ) == ( TickType_t ) 0U ) )
+        {
+            return xTimeToWake;
+        }
+
+        return ( TickType_t ) ( xEnd & ( TickType_t ) ~( TickType_t ) ( xBit - 1U ) );
+    }
+
+#endif /* configUSE_TASK_DELAY_SLACK */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_RECURSIVE_MUTEXES == 1 ) ) || ( configNUMBER_OF_CORES > 1 )
@@ -8581,8 +9312,11 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 {
     TickType_t xTimeToWake;
     const TickType_t xConstTickCount = xTickCount;
-    List_t * const pxDelayedList = pxDelayedTaskList;
-    List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+
+    #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+        List_t * const pxDelayedList = pxDelayedTaskList;
+        List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+    #endif
 
     #if ( INCLUDE_xTaskAbortDelay == 1 )
     {
@@ -8625,32 +9359,40 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
             /* The list item will be inserted in wake time order. */
             listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-            if( xTimeToWake < xConstTickCount )
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
             {
-                /* Wake time has overflowed.  Place this item in the overflow
-                 * list. */
-                traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
-                vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+                prvWheelDelayCurrentTask( xTimeToWake, xConstTickCount );
             }
-            else
+            #else
             {
-                /* The wake time has not overflowed, so the current block list
-                 * is used. */
-                traceMOVED_TASK_TO_DELAYED_LIST();
-                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
-
-                /* If the task entering the blocked state was placed at the
-                 * head of the list of blocked tasks then xNextTaskUnblockTime
-                 * needs to be updated too. */
-                if( xTimeToWake < xNextTaskUnblockTime )
+                if( xTimeToWake < xConstTickCount )
                 {
-                    xNextTaskUnblockTime = xTimeToWake;
+                    /* Wake time has overflowed.  Place this item in the overflow
+                     * list. */
+                    traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+                    vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
                 }
                 else
                 {
-                    mtCOVERAGE_TEST_MARKER();
+                    /* The wake time has not overflowed, so the current block list
+                     * is used. */
+                    traceMOVED_TASK_TO_DELAYED_LIST();
+                    vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                    /* If the task entering the blocked state was placed at the
+                     * head of the list of blocked tasks then xNextTaskUnblockTime
+                     * needs to be updated too. */
+                    if( xTimeToWake < xNextTaskUnblockTime )
+                    {
+                        xNextTaskUnblockTime = xTimeToWake;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
                 }
             }
+            #endif /* configUSE_DELAYED_TASK_WHEEL */
         }
     }
     #else /* INCLUDE_vTaskSuspend */
@@ -8663,30 +9405,38 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         /* The list item will be inserted in wake time order. */
         listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-        if( xTimeToWake < xConstTickCount )
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
         {
-            traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
-            /* Wake time has overflowed.  Place this item in the overflow list. */
-            vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+            prvWheelDelayCurrentTask( xTimeToWake, xConstTickCount );
         }
-        else
+        #else
         {
-            traceMOVED_TASK_TO_DELAYED_LIST();
-            /* The wake time has not overflowed, so the current block list is used. */
-            vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
-
-            /* If the task entering the blocked state was placed at the head of the
-             * list of blocked tasks then xNextTaskUnblockTime needs to be updated
-             * too. */
-            if( xTimeToWake < xNextTaskUnblockTime )
+            if( xTimeToWake < xConstTickCount )
             {
-                xNextTaskUnblockTime = xTimeToWake;
+                traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+                /* Wake time has overflowed.  Place this item in the overflow list. */
+                vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
             }
             else
             {
-                mtCOVERAGE_TEST_MARKER();
+                traceMOVED_TASK_TO_DELAYED_LIST();
+                /* The wake time has not overflowed, so the current block list is used. */
+                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                /* If the task entering the blocked state was placed at the head of the
+                 * list of blocked tasks then xNextTaskUnblockTime needs to be updated
+                 * too. */
+                if( xTimeToWake < xNextTaskUnblockTime )
+                {
+                    xNextTaskUnblockTime = xTimeToWake;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
             }
         }
+        #endif /* configUSE_DELAYED_TASK_WHEEL */
 
         /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
         ( void ) xCanBlockIndefinitely;
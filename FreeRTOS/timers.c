@@ -134,6 +134,39 @@
         } u;
     } DaemonTaskMessage_t;
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/* Active timers are kept on a hierarchical timing wheel instead of a list
+ * sorted by expiry time, so starting, stopping or resetting a timer is O(1)
+ * however many are active.  Each level has tmrWHEEL_SLOTS slots, and a slot on
+ * level n covers 2^( n * configTIMER_WHEEL_BITS ) ticks.  A timer goes on the
+ * level its time to expiry (from xTimerWheelTime) falls in, in the slot its
+ * expiry time falls in.  When the timer service task reaches the start of a
+ * slot above level 0, the timers in it move down to the level their remaining
+ * time now falls in, and the timers in the level 0 slot of the current tick
+ * have expired.  Times are only ever taken from xTimerWheelTime, so the tick
+ * count wrapping needs no second list.  Only the timer service task is allowed
+ * to access the wheel. */
+        #define tmrWHEEL_SLOTS                    ( ( UBaseType_t ) 1U << configTIMER_WHEEL_BITS )
+        #define tmrWHEEL_LEVELS                   ( ( ( sizeof( TickType_t ) * 8U ) + configTIMER_WHEEL_BITS - 1U ) / configTIMER_WHEEL_BITS )
+        #define tmrWHEEL_SLOT( uxLevel, uxSlot )  ( &( xActiveTimerWheel[ ( ( uxLevel ) * tmrWHEEL_SLOTS ) + ( uxSlot ) ] ) )
+
+/* The number of slots in use on a level.  The top level only has the tick
+ * count bits left over from the levels below. */
+        #define tmrWHEEL_LEVEL_SLOTS( uxShift )                                             \
+    ( ( ( ( sizeof( TickType_t ) * 8U ) - ( uxShift ) ) < configTIMER_WHEEL_BITS ) ?        \
+      ( ( UBaseType_t ) 1U << ( ( sizeof( TickType_t ) * 8U ) - ( uxShift ) ) ) : tmrWHEEL_SLOTS )
+
+/* Expiry times are compared by their distance from the wheel time, which is
+ * never after either of them. */
+        #define tmrHAS_EXPIRED( xExpiryTime, xTimeNow ) \
+    ( ( TickType_t ) ( ( xExpiryTime ) - xTimerWheelTime ) <= ( TickType_t ) ( ( xTimeNow ) - xTimerWheelTime ) )
+
+    PRIVILEGED_DATA static List_t xActiveTimerWheel[ tmrWHEEL_LEVELS * tmrWHEEL_SLOTS ];
+    PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+
+    #else /* configUSE_TIMER_WHEEL */
+
 /* The list in which active timers are stored.  Timers are referenced in expire
  * time order, with the nearest expiry time at the front of the list.  Only the
  * timer service task is allowed to access these lists.
@@ -145,6 +178,10 @@
     PRIVILEGED_DATA static List_t * pxCurrentTimerList;
     PRIVILEGED_DATA static List_t * pxOverflowTimerList;
 
+        #define tmrHAS_EXPIRED( xExpiryTime, xTimeNow )    ( ( xExpiryTime ) <= ( xTimeNow ) )
+
+    #endif /* configUSE_TIMER_WHEEL */
+
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
     PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
@@ -195,11 +232,37 @@
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/*
+ * Put a timer on the wheel, from its list item value (the expiry time) and
+ * xTimerWheelTime.
+ */
+        static void prvTimerWheelInsert( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move xTimerWheelTime on to xTo, moving the timers out of every slot whose
+ * start it passes.  No timer may expire before xTo.
+ */
+        static void prvTimerWheelAdvance( TickType_t xTo ) PRIVILEGED_FUNCTION;
+
+/*
+ * The time the wheel next needs the timer service task, either the expiry
+ * time of the next timer or the start of the next slot to move timers out
+ * of, whichever is sooner.  Returns 0 and sets *pxWheelWasEmpty to pdTRUE if
+ * there are no active timers.
+ */
+        static TickType_t prvTimerWheelNextEvent( BaseType_t * const pxWheelWasEmpty ) PRIVILEGED_FUNCTION;
+
+    #else /* configUSE_TIMER_WHEEL */
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+    #endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -714,10 +777,44 @@
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
-        /* MISRA Ref 11.5.3 [Void pointer assignment] */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-        /* coverity[misra_c_2012_rule_11_5_violation] */
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+        #if ( configUSE_TIMER_WHEEL == 1 )
+            TickType_t xEventTime = xNextExpireTime;
+            BaseType_t xWheelWasEmpty;
+            List_t * pxExpiredList;
+            Timer_t * pxTimer;
+
+            /* Bring the wheel up to the expiry time.  If it was only the start
+             * of a slot, its timers have moved down the wheel, so go on to the
+             * next event if that is due too.  Commands received meanwhile must
+             * not be processed ahead of a timer that has already expired. */
+            for( ; ; )
+            {
+                prvTimerWheelAdvance( xEventTime );
+                pxExpiredList = tmrWHEEL_SLOT( 0U, ( UBaseType_t ) ( xEventTime & ( tmrWHEEL_SLOTS - 1U ) ) );
+
+                if( listLIST_IS_EMPTY( pxExpiredList ) == pdFALSE )
+                {
+                    break;
+                }
+
+                xEventTime = prvTimerWheelNextEvent( &xWheelWasEmpty );
+
+                if( ( xWheelWasEmpty != pdFALSE ) || ( tmrHAS_EXPIRED( xEventTime, xTimeNow ) == pdFALSE ) )
+                {
+                    return;
+                }
+            }
+
+            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxExpiredList );
+        #else
+            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+        #endif
 
         /* Remove the timer from the list of active timers.  A check has already
          * been performed to ensure the list is not empty. */
@@ -728,7 +825,11 @@
          * expiry time and re-insert the timer in the list of active timers. */
         if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
         {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            #if ( configUSE_TIMER_WHEEL == 1 )
+                prvReloadTimer( pxTimer, xEventTime, xTimeNow );
+            #else
+                prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            #endif
         }
         else
         {
@@ -793,7 +894,7 @@
             if( xTimerListsWereSwitched == pdFALSE )
             {
                 /* The tick count has not overflowed, has the timer expired? */
-                if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                if( ( xListWasEmpty == pdFALSE ) && ( tmrHAS_EXPIRED( xNextExpireTime, xTimeNow ) != pdFALSE ) )
                 {
                     ( void ) xTaskResumeAll();
                     prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
@@ -806,12 +907,16 @@
                      * received - whichever comes first.  The following line cannot
                      * be reached unless xNextExpireTime > xTimeNow, except in the
                      * case when the current timer list is empty. */
-                    if( xListWasEmpty != pdFALSE )
+                    #if ( configUSE_TIMER_WHEEL == 0 )
                     {
-                        /* The current timer list is empty - is the overflow list
-                         * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        if( xListWasEmpty != pdFALSE )
+                        {
+                            /* The current timer list is empty - is the overflow list
+                             * also empty? */
+                            xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        }
                     }
+                    #endif /* configUSE_TIMER_WHEEL */
 
                     vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
@@ -837,6 +942,17 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+    {
+        /* With no active timers the task blocks until a command arrives, there
+         * are no lists to switch when the tick count rolls over. */
+        return prvTimerWheelNextEvent( pxListWasEmpty );
+    }
+
+    #else /* configUSE_TIMER_WHEEL */
+
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
     {
         TickType_t xNextExpireTime;
@@ -862,8 +978,42 @@
 
         return xNextExpireTime;
     }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
+    {
+        TickType_t xTimeNow;
+        TickType_t xNextEvent;
+        BaseType_t xWheelWasEmpty;
+
+        xTimeNow = xTaskGetTickCount();
+
+        /* Times on the wheel are taken from xTimerWheelTime, so keep it at the
+         * time now unless the wheel still has something to process before
+         * then.  A new timer's expiry time is then always less than a whole
+         * tick count range away. */
+        xNextEvent = prvTimerWheelNextEvent( &xWheelWasEmpty );
+
+        if( ( xWheelWasEmpty != pdFALSE ) || ( tmrHAS_EXPIRED( xNextEvent, xTimeNow ) == pdFALSE ) )
+        {
+            prvTimerWheelAdvance( xTimeNow );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        *pxTimerListsWereSwitched = pdFALSE;
+
+        return xTimeNow;
+    }
+
+    #else /* configUSE_TIMER_WHEEL */
+
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
@@ -885,6 +1035,8 @@
 
         return xTimeNow;
     }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
@@ -897,35 +1049,53 @@
         listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
         listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
 
-        if( xNextExpiryTime <= xTimeNow )
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
-            /* Has the expiry time elapsed between the command to start/reset a
-             * timer was issued, and the time the command was processed? */
+            /* Has the expiry time passed since the command was issued?  Taken
+             * as a distance from the command time this also covers the tick
+             * count having overflowed since then. */
             if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks )
             {
-                /* The time between a command being issued and the command being
-                 * processed actually exceeds the timers period.  */
                 xProcessTimerNow = pdTRUE;
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                prvTimerWheelInsert( pxTimer );
             }
         }
-        else
+        #else /* configUSE_TIMER_WHEEL */
         {
-            if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+            if( xNextExpiryTime <= xTimeNow )
             {
-                /* If, since the command was issued, the tick count has overflowed
-                 * but the expiry time has not, then the timer must have already passed
-                 * its expiry time and should be processed immediately. */
-                xProcessTimerNow = pdTRUE;
+                /* Has the expiry time elapsed between the command to start/reset a
+                 * timer was issued, and the time the command was processed? */
+                if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks )
+                {
+                    /* The time between a command being issued and the command being
+                     * processed actually exceeds the timers period.  */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+                {
+                    /* If, since the command was issued, the tick count has overflowed
+                     * but the expiry time has not, then the timer must have already passed
+                     * its expiry time and should be processed immediately. */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
         }
+        #endif /* configUSE_TIMER_WHEEL */
 
         return xProcessTimerNow;
     }
@@ -1086,6 +1256,155 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+    static void prvTimerWheelInsert( Timer_t * const pxTimer )
+    {
+        const TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+        TickType_t xRemaining = ( TickType_t ) ( xExpiryTime - xTimerWheelTime );
+        UBaseType_t uxLevel = 0U;
+        UBaseType_t uxShift = 0U;
+
+        /* The level is the number of whole slot widths in the time remaining,
+         * the slot is the expiry time's digit on that level. */
+        while( ( xRemaining >> configTIMER_WHEEL_BITS ) != ( TickType_t ) 0U )
+        {
+            xRemaining >>= configTIMER_WHEEL_BITS;
+            uxLevel++;
+            uxShift += configTIMER_WHEEL_BITS;
+        }
+
+        listINSERT_END( tmrWHEEL_SLOT( uxLevel, ( UBaseType_t ) ( xExpiryTime >> uxShift ) & ( tmrWHEEL_SLOTS - 1U ) ), &( pxTimer->xTimerListItem ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTimerWheelAdvance( TickType_t xTo )
+    {
+        const TickType_t xFrom = xTimerWheelTime;
+        const TickType_t xTicks = ( TickType_t ) ( xTo - xFrom );
+        TickType_t xLow;
+        TickType_t xStarts;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift;
+        UBaseType_t uxSlots;
+        UBaseType_t uxSlot;
+        List_t * pxList;
+
+        xTimerWheelTime = xTo;
+
+        /* Level 0 timers never move, they are taken off when they expire. */
+        for( uxLevel = 1U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+        {
+            uxShift = uxLevel * configTIMER_WHEEL_BITS;
+            xLow = ( TickType_t ) ( ( ( TickType_t ) 1U << uxShift ) - 1U );
+
+            /* Slot starts on this level in ( xFrom, xTo ].  There are never
+             * more on a higher level, so stop at the first level with none. */
+            xStarts = ( TickType_t ) ( ( xTicks >> uxShift ) + ( ( ( xFrom & xLow ) + ( xTicks & xLow ) ) >> uxShift ) );
+
+            if( xStarts == ( TickType_t ) 0U )
+            {
+                break;
+            }
+
+            /* A move of a whole turn or more starts every slot on the level,
+             * once each is enough as nothing moves back up to it. */
+            uxSlots = tmrWHEEL_LEVEL_SLOTS( uxShift );
+
+            if( xStarts > ( TickType_t ) uxSlots )
+            {
+                xStarts = ( TickType_t ) uxSlots;
+            }
+
+            uxSlot = ( UBaseType_t ) ( xFrom >> uxShift );
+
+            while( xStarts > ( TickType_t ) 0U )
+            {
+                xStarts--;
+                uxSlot++;
+                pxList = tmrWHEEL_SLOT( uxLevel, uxSlot & ( uxSlots - 1U ) );
+
+                /* The time remaining on each timer is under one slot width of
+                 * this level, so it always goes to a lower level. */
+                while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+                {
+                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList );
+
+                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    prvTimerWheelInsert( pxTimer );
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvTimerWheelNextEvent( BaseType_t * const pxWheelWasEmpty )
+    {
+        const TickType_t xFrom = xTimerWheelTime;
+        TickType_t xNearest = portMAX_DELAY;
+        TickType_t xDistance;
+        TickType_t xLow;
+        BaseType_t xFound = pdFALSE;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift;
+        UBaseType_t uxSlots;
+        UBaseType_t uxSlot;
+        UBaseType_t uxNext;
+
+        /* A level 0 slot only holds timers expiring on its own tick, so the
+         * first one in use from the current tick on holds the next expiry. */
+        for( uxNext = 0U; uxNext < tmrWHEEL_SLOTS; uxNext++ )
+        {
+            if( listLIST_IS_EMPTY( tmrWHEEL_SLOT( 0U, ( ( UBaseType_t ) xFrom + uxNext ) & ( tmrWHEEL_SLOTS - 1U ) ) ) == pdFALSE )
+            {
+                xNearest = ( TickType_t ) uxNext;
+                xFound = pdTRUE;
+                break;
+            }
+        }
+
+        /* Above level 0 only the start of the first slot in use after the
+         * current one matters, no timer in it expires before then.  The
+         * current slot itself is only in use for timers a whole turn away. */
+        for( uxLevel = 1U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+        {
+            uxShift = uxLevel * configTIMER_WHEEL_BITS;
+            xLow = ( TickType_t ) ( ( ( TickType_t ) 1U << uxShift ) - 1U );
+            uxSlots = tmrWHEEL_LEVEL_SLOTS( uxShift );
+            uxSlot = ( UBaseType_t ) ( xFrom >> uxShift );
+
+            for( uxNext = 1U; uxNext <= uxSlots; uxNext++ )
+            {
+                if( listLIST_IS_EMPTY( tmrWHEEL_SLOT( uxLevel, ( uxSlot + uxNext ) & ( uxSlots - 1U ) ) ) == pdFALSE )
+                {
+                    xDistance = ( TickType_t ) ( ( ( TickType_t ) ( uxNext - 1U ) << uxShift ) + ( xLow - ( xFrom & xLow ) ) + 1U );
+
+                    if( ( xFound == pdFALSE ) || ( xDistance < xNearest ) )
+                    {
+                        xNearest = xDistance;
+                        xFound = pdTRUE;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        *pxWheelWasEmpty = ( xFound == pdFALSE ) ? pdTRUE : pdFALSE;
+
+        if( xFound == pdFALSE )
+        {
+            return ( TickType_t ) 0U;
+        }
+
+        return ( TickType_t ) ( xFrom + xNearest );
+    }
+
+    #else /* configUSE_TIMER_WHEEL */
+
     static void prvSwitchTimerLists( void )
     {
         TickType_t xNextExpireTime;
@@ -1109,6 +1428,8 @@
         pxCurrentTimerList = pxOverflowTimerList;
         pxOverflowTimerList = pxTemp;
     }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -1120,10 +1441,23 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    UBaseType_t uxList;
+
+                    for( uxList = 0U; uxList < ( tmrWHEEL_LEVELS * tmrWHEEL_SLOTS ); uxList++ )
+                    {
+                        vListInitialise( &( xActiveTimerWheel[ uxList ] ) );
+                    }
+                }
+                #else
+                {
+                    vListInitialise( &xActiveTimerList1 );
+                    vListInitialise( &xActiveTimerList2 );
+                    pxCurrentTimerList = &xActiveTimerList1;
+                    pxOverflowTimerList = &xActiveTimerList2;
+                }
+                #endif /* configUSE_TIMER_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
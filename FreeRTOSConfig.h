@@ -29,7 +29,14 @@
 
 //#include <p24FJ128GA010.h>
 
+/* This file is also included by portasm_PIC24.S, which only needs the
+definitions below. */
+#ifndef __ASSEMBLER__
  #include <xc.h>
+#endif
+
+/* Per task stack sizes, including the idle task's. */
+#include "stack_sizes.h"
 
 /*-----------------------------------------------------------
  * Application specific definitions.
@@ -49,19 +56,87 @@
 #define configTICK_RATE_HZ				( ( TickType_t ) 1000 )
 #define configCPU_CLOCK_HZ				( ( unsigned long ) 4000000 )  /* Fosc / 2 */
 #define configMAX_PRIORITIES			( 4 )
-#define configMINIMAL_STACK_SIZE		( 115 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) 5120 )
-#define configMAX_TASK_NAME_LEN			( 4 )
-#define configUSE_TRACE_FACILITY		0
+#define configMINIMAL_STACK_SIZE		( STACK_SIZE_IDLE )
+#define configMAX_TASK_NAME_LEN			( 16 )
+#define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION	1
 #define configIDLE_SHOULD_YIELD			1
-#define configCHECK_FOR_STACK_OVERFLOW  2
-#define configSUPPORT_DYNAMIC_ALLOCATION 1
+/* Stack overflow is caught by the SPLIM stack error trap on PIC24 parts, see
+portHAS_STACK_OVERFLOW_CHECKING, so the pattern check is not needed. */
+#define configCHECK_FOR_STACK_OVERFLOW  0
+
+/* Every task, stack and kernel object is a statically sized array, so RAM
+use is fixed at link time and there is no heap. */
+#define configSUPPORT_STATIC_ALLOCATION	1
+#define configSUPPORT_DYNAMIC_ALLOCATION 0
+
+/* Stop the tick while the idle task runs.  Timer 1 is stretched to the next
+task wake time and the core waits in Idle, and the tick count is corrected on
+wake.  Shorter idle periods are not worth the timer reprogramming. */
+/* Not with co-routines, the idle task would sleep through their delays. */
+#define configUSE_TICKLESS_IDLE					( configUSE_CO_ROUTINES == 0 )
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP	2
+
+/* Keep delayed tasks on a hierarchical timing wheel instead of a list sorted
+by wake time, so a delay costs the same however many tasks are delayed (see
+tools/delaybench).  With the few tasks here the sorted list stays short, and
+the wheel's 64 lists would take 640 bytes of RAM, so it is left off. */
+#define configUSE_DELAYED_TASK_WHEEL			0
+#define configDELAYED_TASK_WHEEL_BITS			4
+
+/* Provide vTaskDelayWithSlack() and xTaskDelayUntilWithSlack(), which may
+defer a wake-up by a few ticks to share a tick with other wake-ups.  The FSM
+polling states use it, and 'i' shows the ticks that woke a task during a
+countdown. */
+#define configUSE_TASK_DELAY_SLACK			1
+
+/* Provide xQueueSendMultiple(), xQueueReceiveMultiple() and their FromISR
+versions, which move several items in one critical section.  Only bench.c uses
+them so far, to compare against one item per call. */
+#define configUSE_QUEUE_BATCH				1
+
+/* Provide xStreamBufferSendAcquire(), xStreamBufferReceiveAcquire() and their
+commit calls, which let the writer and reader work in the stream buffer's own
+storage instead of copying through a buffer of their own.  Only bench.c uses
+them so far. */
+#define configUSE_STREAM_BUFFER_ZERO_COPY	1
+
+/* Provide the fast mutexes of fast_mutex.h, which take a free mutex with one
+compare and swap and keep priority inheritance.  The UART mutex is one, and
+bench.c compares them against a mutex type semaphore. */
+#define configUSE_FAST_MUTEXES				1
+
+/* Keep takes, waits, priority inheritance and the longest hold of every
+mutex and semaphore, for the console's 'm' command.  Times are in run time
+stats counts.  Adds a few words to each queue and a short critical section to
+the fast mutex take. */
+#define configUSE_MUTEX_STATS				1
+
+/* Let interrupts set event group bits with xEventGroupSetBitsFromISRDirect(),
+unblocking the waiting tasks in the interrupt itself, while no more than this
+many tasks wait on the group.  0 leaves it out, along with the lock it adds to
+every task-level event group call, so it stays 0 until an interrupt uses it.
+Then 4 covers the four state tasks waiting on stateEvents.  tools/eventcheck
+checks it on the host. */
+#define configEVENT_GROUP_ISR_MAX_WAITERS	0
 
-/* Co-routine definitions. */
-#define configUSE_CO_ROUTINES 		1
+/* Leave TBLPAG, CORCON, DSRPAG and DSWPAG out of the task context, saving 8
+cycles and 4 stack words on every switch.  Only valid while no task changes
+those registers, i.e. no table reads or __eds__/__psv__ pointers at task
+level.  Interrupts that change them restore them on exit as before. */
+#define configUSE_REDUCED_TASK_CONTEXT			1
+
+/* Co-routine definitions.  Set configUSE_CO_ROUTINES to 1 to run the four FSM
+states as co-routines of the idle task instead of four tasks, sharing the idle
+task's stack (see crFsm() in main.c).  The PB3 and RTCC countdown wakes are
+task notifications, so the 'r' RTCC mode is left out of that build. */
+#define configUSE_CO_ROUTINES 		0
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
 
+/* Named here so the console 'k' stack audit can pick the idle task out. */
+#define configIDLE_TASK_NAME			"IDLE"
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 
@@ -77,6 +152,65 @@ to exclude the API function. */
 
 #define configKERNEL_INTERRUPT_PRIORITY	0x01
 
+/* Critical sections raise the IPL to this level.  Interrupts at or below it
+(Timer 2 at 3, UART2 at 3 and 4) may call the FromISR API functions, anything
+above it is never masked by the kernel and must not use the API. */
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY	0x04
+
+/* Words of the single stack all interrupt handlers run on.  It has to hold
+the deepest nesting of the tick, Timer 2 and UART2 handlers, task stacks
+only need room for the first interrupt's PC, SR, W0 and W1. */
+#define configISR_STACK_SIZE			128
+
+/* Per task run time for the console stats command, counted by SCCP4 in the
+port.  The trace facility numbers each task, which indexes the console's
+context switch counts and the trace recorder's events. */
+#define configGENERATE_RUN_TIME_STATS	1
+#ifndef __ASSEMBLER__
+ #include "console.h"
+ #include "trace.h"
+#endif
+
+#if ( TRACE_ENABLE == 1 )
+
+	/* Scheduler, delay, queue and fast mutex events for the snapshot trace
+	recorder.  Semaphore takes and gives are queue receives and sends, priority
+	inheritance is recorded for both kinds of mutex.  traceISR_ENTER and
+	traceISR_EXIT are only called by the port's tick interrupt. */
+	#define traceTASK_SWITCHED_IN()							\
+		do													\
+		{													\
+			ConsoleCountSwitch( pxCurrentTCB->uxTCBNumber );\
+			TraceRecord( TRACE_EVT_SWITCH_IN, pxCurrentTCB->uxTCBNumber );\
+		} while( 0 )
+	#define traceTASK_CREATE( pxNewTCB )					TraceNameTask( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->pcTaskName )
+	#define traceMOVED_TASK_TO_READY_STATE( pxTCB )			TraceRecord( TRACE_EVT_READY, ( pxTCB )->uxTCBNumber )
+	#define traceTASK_DELAY()								TraceRecord( TRACE_EVT_DELAY, pxCurrentTCB->uxTCBNumber )
+	#define traceTASK_DELAY_UNTIL( xTimeToWake )			TraceRecord( TRACE_EVT_DELAY_UNTIL, pxCurrentTCB->uxTCBNumber )
+	#define traceQUEUE_SEND( pxQueue )						TraceRecord( TRACE_EVT_QUEUE_SEND, ( pxQueue )->uxQueueNumber )
+	#define traceQUEUE_SEND_FAILED( pxQueue )				TraceRecord( TRACE_EVT_QUEUE_SEND_FAILED, ( pxQueue )->uxQueueNumber )
+	#define traceQUEUE_RECEIVE( pxQueue )					TraceRecord( TRACE_EVT_QUEUE_RECEIVE, ( pxQueue )->uxQueueNumber )
+	#define traceQUEUE_RECEIVE_FAILED( pxQueue )			TraceRecord( TRACE_EVT_QUEUE_RECEIVE_FAILED, ( pxQueue )->uxQueueNumber )
+	#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )			TraceRecord( TRACE_EVT_QUEUE_BLOCK_SEND, ( pxQueue )->uxQueueNumber )
+	#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )		TraceRecord( TRACE_EVT_QUEUE_BLOCK_RECEIVE, ( pxQueue )->uxQueueNumber )
+	#define traceQUEUE_SEND_FROM_ISR( pxQueue )				TraceRecord( TRACE_EVT_QUEUE_SEND_ISR, ( pxQueue )->uxQueueNumber )
+	#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )			TraceRecord( TRACE_EVT_QUEUE_RECEIVE_ISR, ( pxQueue )->uxQueueNumber )
+	#define traceFAST_MUTEX_TAKE( pxMutex )					TraceRecord( TRACE_EVT_MUTEX_TAKE, ( pxMutex )->uxMutexNumber )
+	#define traceFAST_MUTEX_TAKE_FAILED( pxMutex )			TraceRecord( TRACE_EVT_MUTEX_TAKE_FAILED, ( pxMutex )->uxMutexNumber )
+	#define traceBLOCKING_ON_FAST_MUTEX( pxMutex )			TraceRecord( TRACE_EVT_MUTEX_BLOCK, ( pxMutex )->uxMutexNumber )
+	#define traceFAST_MUTEX_GIVE( pxMutex )					TraceRecord( TRACE_EVT_MUTEX_GIVE, ( pxMutex )->uxMutexNumber )
+	#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority )	TraceRecord( TRACE_EVT_PRIORITY_INHERIT, ( pxTCBOfMutexHolder )->uxTCBNumber )
+	#define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority )	TraceRecord( TRACE_EVT_PRIORITY_DISINHERIT, ( pxTCBOfMutexHolder )->uxTCBNumber )
+	#define traceISR_ENTER()								TraceRecord( TRACE_EVT_ISR_ENTER, TRACE_ISR_TICK )
+	#define traceISR_EXIT()									TraceRecord( TRACE_EVT_ISR_EXIT, TRACE_ISR_TICK )
+	#define traceISR_EXIT_TO_SCHEDULER()					traceISR_EXIT()
+
+#else
+
+	#define traceTASK_SWITCHED_IN()							ConsoleCountSwitch( pxCurrentTCB->uxTCBNumber )
+
+#endif /* TRACE_ENABLE */
+
 
 #ifndef SIZE_MAX
     #define SIZE_MAX    ( ( size_t ) -1 )
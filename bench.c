@@ -0,0 +1,535 @@
+/*
+ * File:   bench.c
+ *
+ * Cycle count benchmarks for the kernel port. The benchmark task runs at
+ * priority 1, below every FSM task, waits for the UI to settle, runs each
+ * case once, prints the results and then suspends itself.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "fast_mutex.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "uart.h"
+#include "bench.h"
+#include "stack_sizes.h"
+#include "wheel.h"
+
+#if BENCH_ENABLE
+
+#define BENCH_PRIORITY          1
+// Wait until the start up prompts are out of the way
+#define BENCH_START_DELAY_MS    2000
+
+// Uart mutex from main.c
+extern FastMutexHandle_t uart_sem;
+
+static TaskHandle_t benchTask;
+static TaskHandle_t partnerTask;
+static StaticTask_t benchTaskTCB;
+static StackType_t benchTaskStack[STACK_SIZE_BENCH];
+static StaticTask_t partnerTaskTCB;
+static StackType_t partnerTaskStack[STACK_SIZE_BENCHPEER];
+
+// Cycle count taken just before a task yields, read by the task that runs next
+static volatile uint16_t switchStart;
+// The partner only records once the benchmark task has started a run
+static volatile uint8_t switchArmed = 0;
+
+// Cost of reading the counter and recording a sample with no work in between
+static uint16_t benchOverhead = 0;
+
+static BenchStat_t yieldStat;
+
+// Timers already on the wheel for each run of the wheel benchmark
+#define BENCH_WHEEL_MAX 32
+static const uint8_t wheelSizes[] = { 1, 8, BENCH_WHEEL_MAX };
+static const char * const wheelStartNames[] = { "wheel start+stop, 1 timer", "wheel start+stop, 8 timers", "wheel start+stop, 32 timers" };
+static const char * const wheelNextNames[] = { "wheel next deadline, 1 timer", "wheel next deadline, 8 timers", "wheel next deadline, 32 timers" };
+
+static Wheel_t benchWheel;
+static WheelTimer_t benchTimers[BENCH_WHEEL_MAX + 1];
+
+#if configUSE_QUEUE_BATCH
+// Bytes moved through the queue per sample, one byte per item like a log or
+// a UART stream
+#define BENCH_QUEUE_ITEMS 32
+
+// What the partner task does, it reads the queue in the reader cases
+#define PARTNER_YIELD       0
+#define PARTNER_READ_ITEM   1
+#define PARTNER_READ_BATCH  2
+
+static volatile uint8_t partnerMode = PARTNER_YIELD;
+
+static StaticQueue_t benchQueueBuffer;
+static uint8_t benchQueueStorage[BENCH_QUEUE_ITEMS];
+static QueueHandle_t benchQueue;
+static uint8_t benchQueueData[BENCH_QUEUE_ITEMS];
+static uint8_t partnerQueueData[BENCH_QUEUE_ITEMS];
+#endif
+
+#if configUSE_STREAM_BUFFER_ZERO_COPY
+// Bytes produced and consumed per sample, in a buffer that is not a multiple
+// of it so every other sample wraps round the end of the storage area
+#define BENCH_STREAM_BYTES  32
+#define BENCH_STREAM_SIZE   48
+
+static StaticStreamBuffer_t benchStreamBuffer;
+static uint8_t benchStreamStorage[BENCH_STREAM_SIZE];
+static StreamBufferHandle_t benchStream;
+static uint8_t benchStreamData[BENCH_STREAM_BYTES];
+// Keeps the consumer loops from being optimised away
+static volatile uint8_t benchStreamSum;
+#endif
+
+#if configUSE_FAST_MUTEXES
+// A mutex type semaphore and a fast mutex of the bench's own, so the samples
+// are never held up by a task printing
+static StaticSemaphore_t benchSemBuffer;
+static SemaphoreHandle_t benchSem;
+static StaticFastMutex_t benchFastMutexBuffer;
+static FastMutexHandle_t benchFastMutex;
+#endif
+
+void BenchInitTimer(void)
+{
+    // Timer 3 from the instruction clock with a 1:1 prescaler
+    T3CONbits.TON = 0;
+    T3CONbits.TCS = 0;
+    T3CONbits.TCKPS = 0b00;
+    TMR3 = 0;
+    PR3 = 0xFFFF;
+
+    // Free running, no interrupt
+    IFS0bits.T3IF = 0;
+    IEC0bits.T3IE = 0;
+
+    T3CONbits.TON = 1;
+}
+
+void BenchReset(BenchStat_t *stat, const char *name)
+{
+    stat->name = name;
+    stat->min = 0xFFFF;
+    stat->max = 0;
+    stat->total = 0;
+    stat->count = 0;
+}
+
+void BenchRecord(BenchStat_t *stat, uint16_t cycles)
+{
+    // Remove the cost of the measurement itself
+    if (cycles > benchOverhead)
+    {
+        cycles -= benchOverhead;
+    }
+    else
+    {
+        cycles = 0;
+    }
+
+    if (cycles < stat->min)
+    {
+        stat->min = cycles;
+    }
+    if (cycles > stat->max)
+    {
+        stat->max = cycles;
+    }
+    stat->total += cycles;
+    stat->count++;
+}
+
+void BenchReport(const BenchStat_t *stat)
+{
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+
+    Disp2String("\n\r[bench] ");
+    Disp2String((char *)stat->name);
+    if (stat->count == 0)
+    {
+        Disp2String(": no samples");
+    }
+    else
+    {
+        Disp2String(": min ");
+        Disp2Dec(stat->min);
+        Disp2String(" avg ");
+        Disp2Dec(stat->total / stat->count);
+        Disp2String(" max ");
+        Disp2Dec(stat->max);
+        Disp2String(" cycles (n=");
+        Disp2Dec(stat->count);
+        Disp2String(")");
+    }
+
+    xFastMutexGive(uart_sem);
+}
+
+// Measure how long an empty timed section takes, so it can be taken off
+// every sample
+static void BenchCalibrate(void)
+{
+    BenchStat_t cal;
+    uint16_t i;
+    uint16_t start;
+
+    benchOverhead = 0;
+    BenchReset(&cal, "overhead");
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = BENCH_NOW();
+        BenchRecord(&cal, BENCH_NOW() - start);
+    }
+    benchOverhead = cal.min;
+}
+
+// Runs at the same priority as the benchmark task, so every taskYIELD() on
+// either side is a switch to the other task
+static void vBenchPartnerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;)
+    {
+#if configUSE_QUEUE_BATCH
+        if (partnerMode == PARTNER_READ_ITEM)
+        {
+            xQueueReceive(benchQueue, partnerQueueData, portMAX_DELAY);
+            continue;
+        }
+        if (partnerMode == PARTNER_READ_BATCH)
+        {
+            xQueueReceiveMultiple(benchQueue, partnerQueueData, BENCH_QUEUE_ITEMS, portMAX_DELAY);
+            continue;
+        }
+#endif
+        if (switchArmed)
+        {
+            BenchRecord(&yieldStat, BENCH_NOW() - switchStart);
+        }
+        taskYIELD();
+    }
+}
+
+// taskYIELD() from one task to another of the same priority, which covers
+// the full context save, vTaskSwitchContext() and the restore
+static void BenchYieldSwitch(void)
+{
+    uint16_t i;
+
+    BenchReset(&yieldStat, "yield switch");
+
+    switchArmed = 1;
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        switchStart = BENCH_NOW();
+        taskYIELD();
+    }
+    switchArmed = 0;
+
+    // Only this task needs the CPU from here on
+    vTaskSuspend(partnerTask);
+
+    BenchReport(&yieldStat);
+}
+
+// Starting and stopping one timer, and finding the deadline the named timer
+// task sleeps until, with more and more timers already running. Deadlines are
+// spread over a few turns of the wheel like a mix of short and long timers
+static void BenchWheel(void)
+{
+    BenchStat_t startStat;
+    BenchStat_t nextStat;
+    uint8_t size;
+    uint8_t i;
+    uint16_t n;
+    uint16_t start;
+    uint32_t deadline;
+
+    for (size = 0; size < sizeof(wheelSizes); size++)
+    {
+        WheelInit(&benchWheel, 0);
+        for (i = 0; i < wheelSizes[size]; i++)
+        {
+            WheelInsert(&benchWheel, &benchTimers[i], 1000 + (uint32_t) i * 3001);
+        }
+
+        BenchReset(&startStat, wheelStartNames[size]);
+        BenchReset(&nextStat, wheelNextNames[size]);
+
+        for (n = 0; n < BENCH_ITERATIONS; n++)
+        {
+            start = BENCH_NOW();
+            WheelInsert(&benchWheel, &benchTimers[BENCH_WHEEL_MAX], 500 + (uint32_t) n * 37);
+            WheelRemove(&benchWheel, &benchTimers[BENCH_WHEEL_MAX]);
+            BenchRecord(&startStat, BENCH_NOW() - start);
+
+            start = BENCH_NOW();
+            WheelNextDeadline(&benchWheel, &deadline);
+            BenchRecord(&nextStat, BENCH_NOW() - start);
+        }
+
+        BenchReport(&startStat);
+        BenchReport(&nextStat);
+    }
+}
+
+#if configUSE_QUEUE_BATCH
+// Moving BENCH_QUEUE_ITEMS bytes through a queue one item per call against
+// one batch call. First with nothing waiting, sending then receiving them
+// all, from a task and with the FromISR calls. Then to the partner task
+// blocked on the queue at a higher priority, which reads each item as it
+// arrives, so per item it is switched to once per byte
+static void BenchQueue(void)
+{
+    BenchStat_t itemStat;
+    BenchStat_t batchStat;
+    BaseType_t woken;
+    uint16_t n;
+    uint8_t i;
+    uint16_t start;
+
+    benchQueue = xQueueCreateStatic(BENCH_QUEUE_ITEMS, sizeof(uint8_t), benchQueueStorage, &benchQueueBuffer);
+
+    BenchReset(&itemStat, "queue 32 B send+receive, per item");
+    BenchReset(&batchStat, "queue 32 B send+receive, batch");
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        start = BENCH_NOW();
+        for (i = 0; i < BENCH_QUEUE_ITEMS; i++)
+        {
+            xQueueSend(benchQueue, &benchQueueData[i], 0);
+        }
+        for (i = 0; i < BENCH_QUEUE_ITEMS; i++)
+        {
+            xQueueReceive(benchQueue, &benchQueueData[i], 0);
+        }
+        BenchRecord(&itemStat, BENCH_NOW() - start);
+
+        start = BENCH_NOW();
+        xQueueSendMultiple(benchQueue, benchQueueData, BENCH_QUEUE_ITEMS, 0);
+        xQueueReceiveMultiple(benchQueue, benchQueueData, BENCH_QUEUE_ITEMS, 0);
+        BenchRecord(&batchStat, BENCH_NOW() - start);
+    }
+    BenchReport(&itemStat);
+    BenchReport(&batchStat);
+
+    BenchReset(&itemStat, "queue 32 B FromISR, per item");
+    BenchReset(&batchStat, "queue 32 B FromISR, batch");
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        woken = pdFALSE;
+        start = BENCH_NOW();
+        for (i = 0; i < BENCH_QUEUE_ITEMS; i++)
+        {
+            xQueueSendFromISR(benchQueue, &benchQueueData[i], &woken);
+        }
+        for (i = 0; i < BENCH_QUEUE_ITEMS; i++)
+        {
+            xQueueReceiveFromISR(benchQueue, &benchQueueData[i], &woken);
+        }
+        BenchRecord(&itemStat, BENCH_NOW() - start);
+
+        start = BENCH_NOW();
+        xQueueSendMultipleFromISR(benchQueue, benchQueueData, BENCH_QUEUE_ITEMS, &woken);
+        xQueueReceiveMultipleFromISR(benchQueue, benchQueueData, BENCH_QUEUE_ITEMS, &woken);
+        BenchRecord(&batchStat, BENCH_NOW() - start);
+    }
+    BenchReport(&itemStat);
+    BenchReport(&batchStat);
+
+    // The partner preempts as soon as it is resumed and blocks on the
+    // empty queue
+    partnerMode = PARTNER_READ_ITEM;
+    vTaskPrioritySet(partnerTask, BENCH_PRIORITY + 1);
+    vTaskResume(partnerTask);
+
+    BenchReset(&itemStat, "queue 32 B to reader, per item");
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        start = BENCH_NOW();
+        for (i = 0; i < BENCH_QUEUE_ITEMS; i++)
+        {
+            xQueueSend(benchQueue, &benchQueueData[i], portMAX_DELAY);
+        }
+        BenchRecord(&itemStat, BENCH_NOW() - start);
+    }
+
+    // One more item takes the partner round its loop to the batch read
+    partnerMode = PARTNER_READ_BATCH;
+    xQueueSend(benchQueue, &benchQueueData[0], portMAX_DELAY);
+
+    BenchReset(&batchStat, "queue 32 B to reader, batch");
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        start = BENCH_NOW();
+        xQueueSendMultiple(benchQueue, benchQueueData, BENCH_QUEUE_ITEMS, portMAX_DELAY);
+        BenchRecord(&batchStat, BENCH_NOW() - start);
+    }
+
+    vTaskSuspend(partnerTask);
+
+    BenchReport(&itemStat);
+    BenchReport(&batchStat);
+}
+#endif
+
+#if configUSE_STREAM_BUFFER_ZERO_COPY
+// A producer writing BENCH_STREAM_BYTES and a consumer adding them up,
+// through xStreamBufferSend() and xStreamBufferReceive() with a buffer of
+// their own on each side against writing and reading them in the stream
+// buffer's storage with the acquire and commit calls
+static void BenchStream(void)
+{
+    BenchStat_t copyStat;
+    BenchStat_t zeroStat;
+    uint8_t *span;
+    uint8_t sum;
+    uint16_t n;
+    size_t i;
+    size_t count;
+    size_t left;
+    uint16_t start;
+
+    benchStream = xStreamBufferCreateStatic(BENCH_STREAM_SIZE, 1, benchStreamStorage, &benchStreamBuffer);
+
+    BenchReset(&copyStat, "stream 32 B produce+consume, copy");
+    BenchReset(&zeroStat, "stream 32 B produce+consume, zero copy");
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        start = BENCH_NOW();
+        for (i = 0; i < BENCH_STREAM_BYTES; i++)
+        {
+            benchStreamData[i] = (uint8_t)i;
+        }
+        xStreamBufferSend(benchStream, benchStreamData, BENCH_STREAM_BYTES, 0);
+        count = xStreamBufferReceive(benchStream, benchStreamData, BENCH_STREAM_BYTES, 0);
+        sum = 0;
+        for (i = 0; i < count; i++)
+        {
+            sum += benchStreamData[i];
+        }
+        benchStreamSum = sum;
+        BenchRecord(&copyStat, BENCH_NOW() - start);
+
+        // Two spans whenever the bytes wrap round the end of the storage
+        start = BENCH_NOW();
+        for (left = BENCH_STREAM_BYTES; left > 0; left -= count)
+        {
+            count = xStreamBufferSendAcquire(benchStream, &span, 0);
+            if (count > left)
+            {
+                count = left;
+            }
+            for (i = 0; i < count; i++)
+            {
+                span[i] = (uint8_t)i;
+            }
+            vStreamBufferSendCommit(benchStream, count);
+        }
+        sum = 0;
+        while ((count = xStreamBufferReceiveAcquire(benchStream, &span, 0)) > 0)
+        {
+            for (i = 0; i < count; i++)
+            {
+                sum += span[i];
+            }
+            vStreamBufferReceiveCommit(benchStream, count);
+        }
+        benchStreamSum = sum;
+        BenchRecord(&zeroStat, BENCH_NOW() - start);
+    }
+    BenchReport(&copyStat);
+    BenchReport(&zeroStat);
+}
+#endif
+
+#if configUSE_FAST_MUTEXES
+// Taking and giving back a free mutex, as the UART mutex nearly always is,
+// through the queue behind xSemaphoreCreateMutexStatic() against a fast mutex
+static void BenchMutex(void)
+{
+    BenchStat_t semStat;
+    BenchStat_t fastStat;
+    uint16_t n;
+    uint16_t start;
+
+    benchSem = xSemaphoreCreateMutexStatic(&benchSemBuffer);
+    benchFastMutex = xFastMutexCreateStatic(&benchFastMutexBuffer);
+
+    BenchReset(&semStat, "mutex take+give, semaphore");
+    BenchReset(&fastStat, "mutex take+give, fast mutex");
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        start = BENCH_NOW();
+        xSemaphoreTake(benchSem, 0);
+        xSemaphoreGive(benchSem);
+        BenchRecord(&semStat, BENCH_NOW() - start);
+
+        start = BENCH_NOW();
+        xFastMutexTake(benchFastMutex, 0);
+        xFastMutexGive(benchFastMutex);
+        BenchRecord(&fastStat, BENCH_NOW() - start);
+    }
+    BenchReport(&semStat);
+    BenchReport(&fastStat);
+}
+#endif
+
+static void vBenchTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    vTaskDelay(pdMS_TO_TICKS(BENCH_START_DELAY_MS));
+
+    BenchCalibrate();
+
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+    Disp2String("\n\r[bench] task selection: ");
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION
+    Disp2String("port optimised (ff1l)");
+#else
+    Disp2String("generic");
+#endif
+#if configUSE_REDUCED_TASK_CONTEXT
+    Disp2String(", reduced context");
+#else
+    Disp2String(", full context");
+#endif
+    Disp2String(", overhead ");
+    Disp2Dec(benchOverhead);
+    Disp2String(" cycles");
+    xFastMutexGive(uart_sem);
+
+    BenchYieldSwitch();
+
+    BenchWheel();
+
+#if configUSE_QUEUE_BATCH
+    BenchQueue();
+#endif
+
+#if configUSE_STREAM_BUFFER_ZERO_COPY
+    BenchStream();
+#endif
+
+#if configUSE_FAST_MUTEXES
+    BenchMutex();
+#endif
+
+    vTaskSuspend(NULL);
+}
+
+void BenchStart(void)
+{
+    BenchInitTimer();
+
+    benchTask = xTaskCreateStatic(vBenchTask, "Bench", STACK_SIZE_BENCH, NULL, BENCH_PRIORITY, benchTaskStack, &benchTaskTCB);
+    partnerTask = xTaskCreateStatic(vBenchPartnerTask, "BenchPeer", STACK_SIZE_BENCHPEER, NULL, BENCH_PRIORITY, partnerTaskStack, &partnerTaskTCB);
+}
+
+#endif // BENCH_ENABLE
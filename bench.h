@@ -0,0 +1,46 @@
+/* 
+ * File:   bench.h
+ *
+ * Cycle count benchmarks for the kernel port. Timer 3 runs at Fcy with no
+ * prescaler so TMR3 is a free running instruction cycle counter, and each
+ * benchmark case keeps min/max/average counts which are reported over UART2.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <xc.h>
+
+// Off in the firmware, the partner task spins at priority 1 and keeps the
+// idle task, and so tickless idle, from running. For a benchmark build add
+// BENCH_ENABLE=1 to the XC16 preprocessor macros of the project
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE 0
+#endif
+
+// How many samples each benchmark case takes
+#define BENCH_ITERATIONS 500
+
+// Read the cycle counter, differences are taken modulo 2^16 so a measured
+// section has to be shorter than 65536 cycles
+#define BENCH_NOW() (TMR3)
+
+typedef struct
+{
+    const char *name;
+    uint16_t min;
+    uint16_t max;
+    uint32_t total;
+    uint16_t count;
+} BenchStat_t;
+
+void BenchInitTimer(void);
+void BenchReset(BenchStat_t *stat, const char *name);
+void BenchRecord(BenchStat_t *stat, uint16_t cycles);
+void BenchReport(const BenchStat_t *stat);
+
+// Creates the benchmark tasks, call before vTaskStartScheduler()
+void BenchStart(void);
+
+#endif
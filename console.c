@@ -0,0 +1,458 @@
+/*
+ * File:   console.c
+ *
+ * UART2 console for kernel statistics. The console task runs at priority 1,
+ * below every FSM task, and sleeps on its task notification until the RX
+ * interrupt hands it a command character. The UART mutex is taken for one
+ * line at a time so FSM output is only ever held up by a single line.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fast_mutex.h"
+#include "uart.h"
+#include "console.h"
+#include "stack_sizes.h"
+#include "mempool.h"
+#include "multitimer.h"
+#include <ctype.h>
+#include <string.h>
+#include "trace.h"
+
+#define CONSOLE_PRIORITY    1
+
+// Head room added to the measured stack use by the stack audit
+#define STACK_AUDIT_MARGIN_PERCENT  25
+#define STACK_AUDIT_MARGIN_MIN      16
+
+// Words below the stack limit the stack error trap keeps back, never used
+// by the task but part of its allocation
+#ifdef portSTACK_LIMIT_PADDING
+#define STACK_LIMIT_PADDING portSTACK_LIMIT_PADDING
+#else
+#define STACK_LIMIT_PADDING 0
+#endif
+
+// Uart mutex from main.c
+extern FastMutexHandle_t uart_sem;
+
+volatile uint32_t consoleSwitchCount[CONSOLE_MAX_TASKS];
+
+static TaskHandle_t consoleTask = NULL;
+static StaticTask_t consoleTaskTCB;
+static StackType_t consoleTaskStack[STACK_SIZE_CONSOLE];
+
+// Kept off the console stack, one entry per task
+static TaskStatus_t taskStatus[CONSOLE_MAX_TASKS];
+
+// A '!' line is filled in by the RX interrupt while typing and belongs to
+// the console task once ready, until the task sets it back to idle
+#define CONSOLE_LINE_IDLE   0
+#define CONSOLE_LINE_TYPING 1
+#define CONSOLE_LINE_READY  2
+
+static char consoleLine[CONSOLE_LINE_LEN];
+static uint8_t consoleLineLength = 0;
+static volatile uint8_t consoleLineState = CONSOLE_LINE_IDLE;
+
+uint8_t ConsoleRxChar(uint8_t c)
+{
+    BaseType_t woken = pdFALSE;
+
+    // Nothing to hand the command to until the task exists
+    if (consoleTask == NULL)
+    {
+        return 0;
+    }
+
+    // Everything up to ENTER belongs to the line being typed
+    if (consoleLineState == CONSOLE_LINE_TYPING)
+    {
+        if (c == '\r' || c == '\n')
+        {
+            consoleLine[consoleLineLength] = '\0';
+            consoleLineState = CONSOLE_LINE_READY;
+            xTaskNotifyFromISR(consoleTask, CONSOLE_CMD_TIMER, eSetValueWithOverwrite, &woken);
+            portYIELD_FROM_ISR(woken);
+        }
+        else if (c == '\b' || c == 0x7F)
+        {
+            if (consoleLineLength > 0)
+            {
+                consoleLineLength--;
+            }
+        }
+        else if (consoleLineLength < CONSOLE_LINE_LEN - 1)
+        {
+            consoleLine[consoleLineLength++] = c;
+        }
+        return 1;
+    }
+
+    // A new line can only start once the last one has been taken, until
+    // then a '!' goes to the FSM like any other character
+    if (c == CONSOLE_CMD_TIMER && consoleLineState == CONSOLE_LINE_IDLE)
+    {
+        consoleLineLength = 0;
+        consoleLineState = CONSOLE_LINE_TYPING;
+        return 1;
+    }
+
+    switch (c)
+    {
+        case CONSOLE_CMD_STATS:
+        case CONSOLE_CMD_STACKS:
+        case CONSOLE_CMD_POOLS:
+#if TRACE_ENABLE
+        case CONSOLE_CMD_TRACE:
+#endif
+#if configUSE_MUTEX_STATS
+        case CONSOLE_CMD_MUTEXES:
+#endif
+            break;
+
+        default:
+            return 0;
+    }
+
+    // A command arriving while the last one prints replaces it
+    xTaskNotifyFromISR(consoleTask, c, eSetValueWithOverwrite, &woken);
+    portYIELD_FROM_ISR(woken);
+
+    return 1;
+}
+
+// Prints val right aligned in a field of the given width
+static void ConsolePrintDec(uint32_t val, uint8_t width)
+{
+    uint32_t v = val;
+    uint8_t digits = 1;
+
+    while (v >= 10)
+    {
+        v /= 10;
+        digits++;
+    }
+
+    while (width > digits)
+    {
+        XmitUART2(' ', 1);
+        width--;
+    }
+
+    Disp2Dec(val);
+}
+
+// Prints the share of the total run time taken by runTime, in whole percent
+static void ConsolePrintPercent(uint32_t runTime, uint32_t onePercent)
+{
+    if (onePercent == 0)
+    {
+        Disp2String("   -");
+        return;
+    }
+
+    ConsolePrintDec(runTime / onePercent, 3);
+    XmitUART2('%', 1);
+}
+
+// Prints a task name left aligned in a field of configMAX_TASK_NAME_LEN
+static void ConsolePrintName(const char *name)
+{
+    Disp2String((char *) name);
+    XmitUART2(' ', configMAX_TASK_NAME_LEN - strlen(name));
+}
+
+static void ConsoleLineStart(void)
+{
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+}
+
+static void ConsoleLineEnd(void)
+{
+    Disp2String("\n\r");
+    xFastMutexGive(uart_sem);
+}
+
+static void ConsolePrintStats(void)
+{
+    UBaseType_t count;
+    UBaseType_t i;
+    uint32_t totalRunTime;
+    uint32_t isrRunTime;
+    uint32_t onePercent;
+    uint32_t switches;
+
+    // Snapshot every task at once, the scheduler is suspended while it is
+    // taken so the figures add up to the total
+    count = uxTaskGetSystemState(taskStatus, CONSOLE_MAX_TASKS, &totalRunTime);
+
+    // Two words updated by the interrupt entry code
+    taskENTER_CRITICAL();
+    isrRunTime = ulPortISRRunTime;
+    taskEXIT_CRITICAL();
+
+    onePercent = totalRunTime / 100;
+
+    ConsoleLineStart();
+    Disp2String("\n\r[STATS] run time counts of Fcy/64 (16 us)");
+    ConsoleLineEnd();
+
+    if (count == 0)
+    {
+        ConsoleLineStart();
+        Disp2String("more tasks than CONSOLE_MAX_TASKS");
+        ConsoleLineEnd();
+        return;
+    }
+
+    ConsoleLineStart();
+    ConsolePrintName("task");
+    Disp2String("       time cpu  switches  free");
+    ConsoleLineEnd();
+
+    for (i = 0; i < count; i++)
+    {
+        switches = 0;
+        if (taskStatus[i].xTaskNumber < CONSOLE_MAX_TASKS)
+        {
+            switches = consoleSwitchCount[taskStatus[i].xTaskNumber];
+        }
+
+        ConsoleLineStart();
+        ConsolePrintName(taskStatus[i].pcTaskName);
+        ConsolePrintDec(taskStatus[i].ulRunTimeCounter, 11);
+        ConsolePrintPercent(taskStatus[i].ulRunTimeCounter, onePercent);
+        ConsolePrintDec(switches, 10);
+        ConsolePrintDec(taskStatus[i].usStackHighWaterMark, 6);
+        ConsoleLineEnd();
+    }
+
+    // Interrupt time is also part of the time of the task it interrupted
+    ConsoleLineStart();
+    ConsolePrintName("ISR");
+    ConsolePrintDec(isrRunTime, 11);
+    ConsolePrintPercent(isrRunTime, onePercent);
+    ConsoleLineEnd();
+
+    ConsoleLineStart();
+    ConsolePrintName("all");
+    ConsolePrintDec(totalRunTime, 11);
+    ConsoleLineEnd();
+}
+
+static void ConsolePrintStackAudit(void)
+{
+    UBaseType_t count;
+    UBaseType_t i;
+    uint16_t size;
+    uint16_t used;
+    uint16_t margin;
+    const char *name;
+
+    // The kernel fills each stack with a pattern when the task is created,
+    // so every sample is the worst case since reset
+    count = uxTaskGetSystemState(taskStatus, CONSOLE_MAX_TASKS, NULL);
+
+    ConsoleLineStart();
+    Disp2String("\n\r[STACKS] words, worst case since reset");
+    ConsoleLineEnd();
+
+    if (count == 0)
+    {
+        ConsoleLineStart();
+        Disp2String("more tasks than CONSOLE_MAX_TASKS");
+        ConsoleLineEnd();
+        return;
+    }
+
+    ConsoleLineStart();
+    ConsolePrintName("task");
+    Disp2String("  size  used  free");
+    ConsoleLineEnd();
+
+    for (i = 0; i < count; i++)
+    {
+        size = taskStatus[i].pxEndOfStack - taskStatus[i].pxStackBase + 1;
+        used = size - taskStatus[i].usStackHighWaterMark;
+
+        ConsoleLineStart();
+        ConsolePrintName(taskStatus[i].pcTaskName);
+        ConsolePrintDec(size, 6);
+        ConsolePrintDec(used, 6);
+        ConsolePrintDec(taskStatus[i].usStackHighWaterMark, 6);
+        ConsoleLineEnd();
+    }
+
+    // The same figures as stack_sizes.h lines, ready to paste. Only
+    // meaningful once every FSM state has been gone through
+    ConsoleLineStart();
+    Disp2String("// stack_sizes.h");
+    ConsoleLineEnd();
+
+    for (i = 0; i < count; i++)
+    {
+        size = taskStatus[i].pxEndOfStack - taskStatus[i].pxStackBase + 1;
+        used = size - taskStatus[i].usStackHighWaterMark;
+
+        margin = (uint16_t) (((uint32_t) used * STACK_AUDIT_MARGIN_PERCENT) / 100);
+        if (margin < STACK_AUDIT_MARGIN_MIN)
+        {
+            margin = STACK_AUDIT_MARGIN_MIN;
+        }
+
+        ConsoleLineStart();
+        name = taskStatus[i].pcTaskName;
+#if configUSE_CO_ROUTINES
+        // The idle stack is sized apart when it runs the FSM co-routines
+        if (strcmp(name, configIDLE_TASK_NAME) == 0)
+        {
+            name = "IDLE_COROUTINES";
+        }
+#endif
+
+        Disp2String("#define STACK_SIZE_");
+        for (; *name != '\0'; name++)
+        {
+            XmitUART2(toupper((unsigned char) *name), 1);
+        }
+        XmitUART2(' ', 1);
+        Disp2Dec(used + STACK_LIMIT_PADDING + margin);
+        ConsoleLineEnd();
+    }
+}
+
+static void ConsolePrintPools(void)
+{
+    uint8_t i;
+    const MemPool_t *pool;
+
+    ConsoleLineStart();
+    Disp2String("\n\r[POOLS] block bytes, blocks in use, most in use, failed takes, bad gives");
+    ConsoleLineEnd();
+
+    ConsoleLineStart();
+    ConsolePrintName("pool");
+    Disp2String(" bytes count  used  high  failed   bad");
+    ConsoleLineEnd();
+
+    for (i = 0; i < MemPoolClassCount(); i++)
+    {
+        pool = MemPoolClass(i);
+
+        // Counters are single words, no need to mask the interrupts
+        ConsoleLineStart();
+        ConsolePrintName(pool->name);
+        ConsolePrintDec(pool->blockSize, 6);
+        ConsolePrintDec(pool->blockCount, 6);
+        ConsolePrintDec(pool->used, 6);
+        ConsolePrintDec(pool->highWater, 6);
+        ConsolePrintDec(pool->failures, 8);
+        ConsolePrintDec(pool->badGives, 6);
+        ConsoleLineEnd();
+    }
+
+    // Frees of a block none of the pools owns
+    ConsoleLineStart();
+    Disp2String("foreign frees ");
+    ConsolePrintDec(MemPoolForeignFrees(), 0);
+    ConsoleLineEnd();
+}
+
+#if configUSE_MUTEX_STATS
+static void ConsolePrintMutex(const char *name, const MutexStats_t *stats)
+{
+    ConsoleLineStart();
+    ConsolePrintName(name);
+    ConsolePrintDec(stats->ulTakes, 8);
+    ConsolePrintDec(stats->ulContended, 7);
+    ConsolePrintDec(stats->ulInheritances, 8);
+    if (stats->ulContended != 0)
+    {
+        ConsolePrintDec(stats->ulTotalWait / stats->ulContended, 9);
+    }
+    else
+    {
+        Disp2String("        -");
+    }
+    ConsolePrintDec(stats->ulMaxWait, 9);
+    ConsolePrintDec(stats->ulMaxHold, 9);
+    XmitUART2(' ', 2);
+    Disp2String(stats->xMaxWaitHolder != NULL ? pcTaskGetName(stats->xMaxWaitHolder) : "-");
+    ConsoleLineEnd();
+}
+
+static void ConsolePrintMutexes(void)
+{
+    MutexStats_t stats;
+
+    // Copied out before printing, the UART mutex is taken for every line
+    vFastMutexGetStats(uart_sem, &stats);
+
+    ConsoleLineStart();
+    Disp2String("\n\r[MUTEXES] times in run time counts of Fcy/64 (16 us), since reset");
+    ConsoleLineEnd();
+
+    ConsoleLineStart();
+    ConsolePrintName("mutex");
+    Disp2String("   takes waited inherit avg wait max wait max hold  holder at max wait");
+    ConsoleLineEnd();
+
+    ConsolePrintMutex("uart", &stats);
+}
+#endif
+
+static void vConsoleTask(void *pvParameters)
+{
+    uint32_t command;
+
+    (void) pvParameters;
+
+    for (;;)
+    {
+        xTaskNotifyWait(0, 0, &command, portMAX_DELAY);
+
+        switch ((uint8_t) command)
+        {
+            case CONSOLE_CMD_STATS:
+                ConsolePrintStats();
+                break;
+
+            case CONSOLE_CMD_STACKS:
+                ConsolePrintStackAudit();
+                break;
+
+            case CONSOLE_CMD_POOLS:
+                ConsolePrintPools();
+                break;
+
+#if TRACE_ENABLE
+            case CONSOLE_CMD_TRACE:
+                TraceDump();
+                break;
+#endif
+
+#if configUSE_MUTEX_STATS
+            case CONSOLE_CMD_MUTEXES:
+                ConsolePrintMutexes();
+                break;
+#endif
+
+            default:
+                break;
+        }
+
+        // Checked on every wake, a command typed after ENTER may have
+        // replaced the '!' in the notification value
+        if (consoleLineState == CONSOLE_LINE_READY)
+        {
+            MultiTimerLine(consoleLine);
+            consoleLineState = CONSOLE_LINE_IDLE;
+        }
+    }
+}
+
+void ConsoleStart(void)
+{
+    consoleTask = xTaskCreateStatic(vConsoleTask, "Console", STACK_SIZE_CONSOLE, NULL, CONSOLE_PRIORITY, consoleTaskStack, &consoleTaskTCB);
+}
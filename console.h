@@ -0,0 +1,61 @@
+/*
+ * File:   console.h
+ *
+ * UART2 console for kernel statistics. Single character commands, and '!'
+ * lines for the named timers, are taken out of the receive stream by the
+ * UART2 RX interrupt and handed to a low priority console task, so printing
+ * never holds up the FSM tasks. The keys do not overlap with the FSM input
+ * (digits and ENTER in time entry, 'i', 'b' and 'r' in countdown).
+ *
+ * This header is also included by FreeRTOSConfig.h for the switch counter,
+ * so it must not include any FreeRTOS headers.
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdint.h>
+
+// Prints per task run time, CPU %, context switches and free stack
+#define CONSOLE_CMD_STATS 's'
+// Dumps the trace recorder buffer, see trace.h
+#define CONSOLE_CMD_TRACE 't'
+// Prints worst case stack use per task and stack_sizes.h lines from it
+#define CONSOLE_CMD_STACKS 'k'
+// Prints use, high water and failures of each memory pool size class
+#define CONSOLE_CMD_POOLS 'p'
+// Prints takes, waits, priority inheritance and hold times of the UART mutex,
+// only with configUSE_MUTEX_STATS
+#define CONSOLE_CMD_MUTEXES 'm'
+// Starts a line for the named timers, taken up to ENTER, see multitimer.h
+#define CONSOLE_CMD_TIMER '!'
+
+// Longest '!' line kept, the rest is dropped
+#define CONSOLE_LINE_LEN 24
+
+// Task numbers handed out by the trace facility start at 1, tasks with a
+// higher number than this are left out of the switch counts
+#define CONSOLE_MAX_TASKS 12
+
+// Context switches into each task, indexed by task number
+extern volatile uint32_t consoleSwitchCount[CONSOLE_MAX_TASKS];
+
+// Called by traceTASK_SWITCHED_IN() from the kernel
+#define ConsoleCountSwitch(taskNumber)                          \
+    do                                                          \
+    {                                                           \
+        if ((taskNumber) < CONSOLE_MAX_TASKS)                   \
+        {                                                       \
+            consoleSwitchCount[(taskNumber)]++;                 \
+        }                                                       \
+    } while (0)
+
+// Called from the UART2 RX interrupt with each received character. Returns 1
+// if the character was a console command and has been taken, 0 if it should
+// go to the FSM as before.
+uint8_t ConsoleRxChar(uint8_t c);
+
+// Creates the console task, call before vTaskStartScheduler()
+void ConsoleStart(void);
+
+#endif
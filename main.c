@@ -68,14 +68,22 @@
 #include "task.h"
 #include "uart.h"
 #include "ADC.h"
-#include "semphr.h"
+#include "fast_mutex.h"
+#include "event_groups.h"
+#include "croutine.h"
+#include "bench.h"
+#include "console.h"
+#include "trace.h"
+#include "stack_sizes.h"
+#include "mempool.h"
+#include "rtcc.h"
+#include "multitimer.h"
 #include <xc.h>
 #include <stdlib.h>
 #include <ctype.h>
 // For uint_32t
 #include <stdint.h>   
 
-#define TASK_STACK_SIZE 200
 #define TASK_PRIORITY 5
 
 // Pin defines
@@ -114,8 +122,21 @@ typedef enum {
     STATE_DONE
 } TimerState_t;
 
-// Default state is below
-static TimerState_t currentState = WAITING_ST;
+// The current state is published as an event group, one bit per state.
+// Each state task blocks on its own bit, so it only wakes on a transition,
+// and the ISR reads the same bits as the tasks do.
+#define STATE_BIT(state)    ((EventBits_t)1 << (state))
+#define STATE_BITS_ALL      (STATE_BIT(WAITING_ST) | STATE_BIT(STATE_TIME_ENTRY) | \
+                             STATE_BIT(STATE_COUNTDOWN) | STATE_BIT(STATE_PAUSED) | \
+                             STATE_BIT(STATE_DONE))
+
+// Extra bits next to the state bits
+// set while the countdown is paused
+#define EVT_PAUSE_BIT       ((EventBits_t)1 << 5)
+// set when the countdown was aborted with a PB3 long press
+#define EVT_ABORT_BIT       ((EventBits_t)1 << 6)
+
+static EventGroupHandle_t stateEvents;
 
 // Variables for the pwm counter
 volatile uint16_t pwmCounter = 0;
@@ -146,10 +167,6 @@ static uint16_t gMinutes = 0;
 static uint16_t gSeconds = 0;
 static uint8_t  countdownInitialised = 0;
 
-// extern variables from the uart.c file
-extern uint8_t received_char;
-extern uint8_t RXFlag;
-
 // these are for state timing
 static uint16_t doneBlinkCount = 0;
 static uint8_t  doneMessageShown = 0;
@@ -165,22 +182,106 @@ static uint8_t  led2BlinkPhase  = 1; // start LED2 "on" phase in countdown
 
 // button states and countdown
 
-// internal tick for countdown state
-#define COUNTDOWN_TICK_MS       100 
+// PB3, the UART keys and the ADC are polled at this period in countdown
+#define COUNTDOWN_POLL_MS       100 
 // this is approximately 1.2s long press for abort
 #define PB3_LONG_PRESS_MS       1200 
-#define PB3_LONG_PRESS_TICKS    (PB3_LONG_PRESS_MS / COUNTDOWN_TICK_MS)
+// PB3 is read this long after an edge wakes the countdown, once it settles
+#define PB3_DEBOUNCE_MS         20
 
 static uint8_t  countdownPaused      = 0;
-static uint16_t countdownTickCounter = 0;
-static uint16_t pb3HoldTicks         = 0;
+// PB3 was down at the last read, and the tick it went down
+static uint8_t  pb3Held              = 0;
+static uint32_t pb3PressStart        = 0;
+
+// Countdown timing, in ticks on the 32-bit count from CountdownNow()
+static uint32_t   countdownNow          = 0;
+static TickType_t countdownLastTick     = 0;
+// tick the countdown reaches 00:00, only valid while running
+static uint32_t   countdownDeadline     = 0;
+// ticks left, only valid while paused
+static uint32_t   countdownRemaining    = 0;
+static uint32_t   countdownNextPoll     = 0;
+// seconds on the display
+static uint16_t   countdownShownSeconds = 0;
+
+// The countdown runs from the tick by default, 'r' switches it to the RTCC.
+// In RTCC mode the task sleeps until the RTCC seconds alarm or a PB3 edge
+// instead of waking every poll, the keys and the ADC are read on each wake
+#define COUNTDOWN_NOTIFY_SECOND 0x01
+#define COUNTDOWN_NOTIFY_PB3    0x02
+
+static TaskHandle_t countdownTask       = NULL;
+static uint8_t    countdownUseRtcc      = 0;
+// RtccSeconds() and the seconds left when the RTCC last took over the count
+static uint32_t   countdownRtccBase     = 0;
+static uint16_t   countdownRtccSeconds  = 0;
+// times the countdown task woke up this countdown, shown with 'i' to compare
+// the two modes
+static uint16_t   countdownWakes        = 0;
+// most ticks the display came after its second was up, shown with 'i' to
+// compare the task and co-routine builds
+static uint16_t   countdownLateMax      = 0;
+#if (configUSE_TASK_DELAY_SLACK == 1)
+// kernel count of ticks that woke a task when this countdown began, the
+// ticks since are shown with 'i'
+static uint32_t   countdownWakeTicks    = 0;
+#endif
 
 // for i -> information mode
 static uint16_t lastAdcVal = 0;
 
 
 // Uart semaphore
-SemaphoreHandle_t uart_sem;
+FastMutexHandle_t uart_sem;
+static StaticFastMutex_t uartSemBuffer;
+
+// Everything the kernel needs is allocated here at compile time, there is
+// no heap. Stack sizes are in stack_sizes.h
+static StaticEventGroup_t stateEventsBuffer;
+
+// With co-routines the FSM runs on the idle task's stack instead, see
+// crFsm()
+#if configUSE_CO_ROUTINES
+#define IDLE_STACK_SIZE STACK_SIZE_IDLE_COROUTINES
+#else
+#define IDLE_STACK_SIZE STACK_SIZE_IDLE
+
+static StaticTask_t waitTaskTCB;
+static StackType_t waitTaskStack[STACK_SIZE_WAITTASK];
+static StaticTask_t timeEntryTaskTCB;
+static StackType_t timeEntryTaskStack[STACK_SIZE_TIMEENTRYTASK];
+static StaticTask_t countdownTaskTCB;
+static StackType_t countdownTaskStack[STACK_SIZE_COUNTDOWNTASK];
+static StaticTask_t doneTaskTCB;
+static StackType_t doneTaskStack[STACK_SIZE_DONETASK];
+#endif
+
+static StaticTask_t idleTaskTCB;
+static StackType_t idleTaskStack[IDLE_STACK_SIZE];
+
+
+// Move the FSM to a new state, clears the old state bit first so no task
+// ever sees two states active at once
+static void SetFsmState(TimerState_t newState)
+{
+    xEventGroupClearBits(stateEvents, STATE_BITS_ALL);
+    xEventGroupSetBits(stateEvents, STATE_BIT(newState));
+}
+
+// Check if the FSM is currently in the given state (task side only)
+static uint8_t IsFsmState(TimerState_t state)
+{
+    return (xEventGroupGetBits(stateEvents) & STATE_BIT(state)) != 0;
+}
+
+#if !configUSE_CO_ROUTINES
+// Block the calling task until the FSM enters the given state
+static void WaitForFsmState(TimerState_t state)
+{
+    xEventGroupWaitBits(stateEvents, STATE_BIT(state), pdFALSE, pdFALSE, portMAX_DELAY);
+}
+#endif
 
 
 void InitTimer2ForPWM(void)
@@ -212,6 +313,18 @@ void InitTimer2ForPWM(void)
 // FreeRTOS requirement due to IDLE 1 define up above
 void vApplicationIdleHook( void )
 {
+#if configUSE_CO_ROUTINES
+    // Runs each ready FSM co-routine once per pass of the idle loop
+    vCoRoutineSchedule();
+#endif
+}
+
+// Required by FreeRTOS with static allocation, the idle task's TCB and stack
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize )
+{
+    *ppxIdleTaskTCBBuffer = &idleTaskTCB;
+    *ppxIdleTaskStackBuffer = idleTaskStack;
+    *puxIdleTaskStackSize = IDLE_STACK_SIZE;
 }
 
 // Same as above, required by FreeRTOS
@@ -220,22 +333,31 @@ void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName )
 	( void ) pcTaskName;
 	( void ) pxTask;
 
-	/* Run time stack overflow checking is performed if
-	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook
-	function is called if a stack overflow is detected. */
+	/* Called from the SPLIM stack error trap in the port, on the trap
+	handler's own stack, as soon as a task pushes past its stack limit.
+	The return address of the trap is left in ulPortStackErrorAddress. */
 	taskDISABLE_INTERRUPTS();
 	for( ;; );
 }
 
+#if !configUSE_CO_ROUTINES
 // FreeRTOS task prototypes
 void vWaitingTask(void *pvParameters);
 void vTimeEntryTask(void *pvParameters);
 void vCountdownTask(void *pvParameters);
 void vDoneTask(void *pvParameters);
+#endif
+
+// Interrupt function, runs on the port's interrupt stack
+void T2InterruptHandler(void);
+portDEFINE_ISR(_T2Interrupt, T2InterruptHandler);
 
-// Interrupt function
-void __attribute__((interrupt, no_auto_psv)) _T2Interrupt(void)
+void T2InterruptHandler(void)
 {   
+#if TRACE_T2_ENABLE
+    TRACE_ISR_ENTER(TRACE_ISR_T2);
+#endif
+
     // Flag clear
     IFS0bits.T2IF = 0;
     
@@ -256,7 +378,7 @@ void __attribute__((interrupt, no_auto_psv)) _T2Interrupt(void)
     }
 
     // pulse LED2 regularly when waiting
-    if (currentState == WAITING_ST)
+    if (xEventGroupGetBitsFromISR(stateEvents) & STATE_BIT(WAITING_ST))
     {
         // Pulsing code
         pulseCounter++;
@@ -282,13 +404,53 @@ void __attribute__((interrupt, no_auto_psv)) _T2Interrupt(void)
             }
         }
     }
+
+#if TRACE_T2_ENABLE
+    TRACE_ISR_EXIT(TRACE_ISR_T2);
+#endif
+}
+
+// PB3 change notification, only enabled while the countdown runs from the RTCC
+void IOCInterruptHandler(void);
+portDEFINE_ISR(_IOCInterrupt, IOCInterruptHandler);
+
+void IOCInterruptHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    TRACE_ISR_ENTER(TRACE_ISR_IOC);
+
+    // PB3 is the only pin with change notification on
+    IOCFBbits.IOCFB9 = 0;
+    IFS1bits.IOCIF = 0;
+
+    xTaskNotifyFromISR(countdownTask, COUNTDOWN_NOTIFY_PB3, eSetBits, &woken);
+
+    TRACE_ISR_EXIT(TRACE_ISR_IOC);
+
+    portYIELD_FROM_ISR(woken);
 }
 
+// Takes the UART mutex. The co-routines run in the idle task, which must
+// never block, so there it spins until the mutex is free. The holder is
+// always a task above idle, so it runs while the idle task spins
+static void UartTake(void)
+{
+#if configUSE_CO_ROUTINES
+    while (xFastMutexTake(uart_sem, 0) != pdPASS)
+    {
+    }
+#else
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+#endif
+}
+
+
 // Print command for the time
 static void PrintTimeUART(uint16_t minutes, uint16_t seconds)
 {
     // Protect UART with the semaphore :)
-    xSemaphoreTake(uart_sem, portMAX_DELAY);
+    UartTake();
 
     // Show the time 
     Disp2String("\n\rTime remaining: ");
@@ -305,7 +467,7 @@ static void PrintTimeUART(uint16_t minutes, uint16_t seconds)
     XmitUART2((seconds % 10) + '0', 1);
     
     // release semaphore
-    xSemaphoreGive(uart_sem);
+    xFastMutexGive(uart_sem);
 }
 
 
@@ -353,347 +515,555 @@ static void PrintUIntDec(uint16_t val)
 }
 
 
-// Waiting task
-void vWaitingTask(void *pvParameters)
-{
-    (void) pvParameters;
+// Each FSM state is written as a step function that does one pass of its
+// state and returns the ticks to sleep before the next pass. The task build
+// runs each step in its own task, the co-routine build runs them as four
+// co-routines on the idle task's stack. Nothing in a step blocks, apart
+// from the UART mutex, see UartTake()
 
+// Waiting state
+
+// PB1 is debounced then waited on until released before TIME_ENTRY
+#define PB1_UP          0
+#define PB1_DEBOUNCE    1
+#define PB1_RELEASE     2
+
+static uint8_t pb1Stage = PB1_UP;
+
+static TickType_t WaitingStep(void)
+{
     // Print banner at startup
     static uint8_t bannerPrinted = 0;
     static uint8_t oncePrintedPB1Debug = 0;
 
-    for (;;)
+    // PB1 click detection simple debounce
+    if (pb1Stage == PB1_DEBOUNCE)
     {
-        if (currentState != WAITING_ST)
+        if (PB1_PORT == 0)
         {
-            // Just a regular yield 
-            vTaskDelay(pdMS_TO_TICKS(20));
-            continue;
-        }
+            UartTake();
+            Disp2String("\n\r[WAITING] PB1 press detected, moving to TIME_ENTRY.\n\r");
+            xFastMutexGive(uart_sem);
 
-        // Initial banner printing
-        if (!bannerPrinted)
+            // wait for release to prevent re input of button
+            pb1Stage = PB1_RELEASE;
+        }
+        else
         {
-            xSemaphoreTake(uart_sem, portMAX_DELAY);
-            Disp2String("\n----------------------Fancy Timer Project-----------------------\n\r");
-            Disp2String("\nAuthors: Jazeb, Mayuran and Anas (Group 13)\n\n\r");
-            Disp2String("The Current State of the FSM is: WAITING. LED2 should be pulsing\n");
-            Disp2String("To move forward, please press PB1 to begin setting a countdown time.\n");
-            xSemaphoreGive(uart_sem);
-
-            bannerPrinted = 1;
+            pb1Stage = PB1_UP;
         }
+        return pdMS_TO_TICKS(10);
+    }
 
-        // LEDs for WAITING state
-        LED0_LAT = 0;
-        LED1_LAT = 0;
-        // LED2 pulsing is handled in Timer2 interrupt service routine
-
-        // Show the waiting message only once each time we return to WAITING
-        if (!waitingPromptShown)
+    if (pb1Stage == PB1_RELEASE)
+    {
+        if (PB1_PORT == 0)
         {
-            xSemaphoreTake(uart_sem, portMAX_DELAY);
-            Disp2String("\n\r[WAITING] Press PB1 to begin setting a countdown time.\n\r");
-            xSemaphoreGive(uart_sem);
-
-            waitingPromptShown = 1;
+            return pdMS_TO_TICKS(10);
         }
 
-        // Debug print - only for button testing
-        /*
-        if (!oncePrintedPB1Debug)
-        {
-            xSemaphoreTake(uart_sem, portMAX_DELAY);
-            if (PB1_PORT)
-                Disp2String("\n\r[DEBUG] PB1 at reset: 1 (HIGH)\n\r");
-            else
-                Disp2String("\n\r[DEBUG] PB1 at reset: 0 (LOW)\n\r");
-            xSemaphoreGive(uart_sem);
+        pb1Stage = PB1_UP;
+        waitingPromptShown = 0;   // so the waiting prompt shows again next time
+        SetFsmState(STATE_TIME_ENTRY);
+        return pdMS_TO_TICKS(10);
+    }
 
-            oncePrintedPB1Debug = 1;
-        }
-        */
+    // Initial banner printing
+    if (!bannerPrinted)
+    {
+        UartTake();
+        Disp2String("\n----------------------Fancy Timer Project-----------------------\n\r");
+        Disp2String("\nAuthors: Jazeb, Mayuran and Anas (Group 13)\n\n\r");
+        Disp2String("The Current State of the FSM is: WAITING. LED2 should be pulsing\n");
+        Disp2String("To move forward, please press PB1 to begin setting a countdown time.\n");
+        xFastMutexGive(uart_sem);
+
+        bannerPrinted = 1;
+    }
 
-        // PB1 click detection simple debounce
-        if (PB1_PORT == 0)  // button pressed is active low
-        {
-            vTaskDelay(pdMS_TO_TICKS(50));  // debounce time
+    // LEDs for WAITING state
+    LED0_LAT = 0;
+    LED1_LAT = 0;
+    // LED2 pulsing is handled in Timer2 interrupt service routine
 
-            if (PB1_PORT == 0)
-            {
-                xSemaphoreTake(uart_sem, portMAX_DELAY);
-                Disp2String("\n\r[WAITING] PB1 press detected, moving to TIME_ENTRY.\n\r");
-                xSemaphoreGive(uart_sem);
+    // Show the waiting message only once each time we return to WAITING
+    if (!waitingPromptShown)
+    {
+        UartTake();
+        Disp2String("\n\r[WAITING] Press PB1 to begin setting a countdown time.\n\r");
+        xFastMutexGive(uart_sem);
 
-                // wait for release to prevent re input of button
-                while (PB1_PORT == 0)
-                {
-                    vTaskDelay(pdMS_TO_TICKS(10));
-                }
+        waitingPromptShown = 1;
+    }
 
-                waitingPromptShown = 0;   // so the waiting prompt shows again next time
-                currentState = STATE_TIME_ENTRY;
-            }
-        }
+    // Debug print - only for button testing
+    /*
+    if (!oncePrintedPB1Debug)
+    {
+        UartTake();
+        if (PB1_PORT)
+            Disp2String("\n\r[DEBUG] PB1 at reset: 1 (HIGH)\n\r");
+        else
+            Disp2String("\n\r[DEBUG] PB1 at reset: 0 (LOW)\n\r");
+        xFastMutexGive(uart_sem);
+
+        oncePrintedPB1Debug = 1;
+    }
+    */
 
-        // Run quickly for responsiveness
-        vTaskDelay(pdMS_TO_TICKS(10));
+    if (PB1_PORT == 0)  // button pressed is active low
+    {
+        pb1Stage = PB1_DEBOUNCE;
+        return pdMS_TO_TICKS(50);  // debounce time
     }
+
+    // Run quickly for responsiveness
+    return pdMS_TO_TICKS(10);
 }
 
 
 // Time Entry State
-void vTimeEntryTask(void *pvParameters)
-{
-    (void) pvParameters;
-
-    // Input characters buffer 
-    char inputBuf[8];
 
-    for (;;)
+// The prompt, then the typed time up to ENTER, then the PB2+PB3 combo
+#define TIME_ENTRY_PROMPT   0
+#define TIME_ENTRY_TYPING   1
+#define TIME_ENTRY_COMBO    2
+
+// Received characters are polled at this period while typing
+#define TIME_ENTRY_POLL_MS      5
+// Approx 1s long press
+#define COMBO_LONG_PRESS_MS     1000
+#define COMBO_TICK_MS           20
+#define COMBO_LONG_PRESS_TICKS  (COMBO_LONG_PRESS_MS / COMBO_TICK_MS)
+
+static uint8_t  timeEntryPhase  = TIME_ENTRY_PROMPT;
+// Input characters buffer
+static char     timeEntryBuf[8];
+static uint8_t  timeEntryLength = 0;
+static uint16_t comboHoldTicks  = 0;
+static uint8_t  comboActive     = 0;
+
+// Sets gMinutes and gSeconds from what was typed
+static void TimeEntryParse(const char *inputBuf)
+{
+    // This is to extract digits only
+    char digits[5] = {0};
+    int di = 0;
+    for (int i = 0; inputBuf[i] != '\0' && di < 4; i++)
     {
-        if (currentState != STATE_TIME_ENTRY)
+        if (isdigit((unsigned char)inputBuf[i]))
         {
-            vTaskDelay(pdMS_TO_TICKS(20));
-            continue;
+            digits[di++] = inputBuf[i];
         }
+    }
+
+    int mm = 0;
+    int ss = 0;
+
+    if (di == 4)
+    {
+        // MMSS
+        mm = (digits[0]-'0')*10 + (digits[1]-'0');
+        ss = (digits[2]-'0')*10 + (digits[3]-'0');
+    }
+    else if (di == 3)
+    {
+        // M SS
+        mm = (digits[0]-'0');
+        ss = (digits[1]-'0')*10 + (digits[2]-'0');
+    }
+    else if (di == 2)
+    {
+        // treat as seconds only
+        mm = 0;
+        ss = (digits[0]-'0')*10 + (digits[1]-'0');
+    }
+    else
+    {
+        // if invalid -> default 00:10
+        mm = 0;
+        ss = 10;
+    }
+    // 60 seconds in a minute
+    if (ss > 59) ss = 59;
 
+    gMinutes = (uint16_t)mm;
+    gSeconds = (uint16_t)ss;
+}
+
+static TickType_t TimeEntryStep(void)
+{
+    if (timeEntryPhase == TIME_ENTRY_PROMPT)
+    {
         // Stop LED2 pulsing when entering time
         dutyTicks = 0;
         LED2_LAT  = 0;
 
         LED0_LAT = 0;
         LED1_LAT = 0;
-        
+
         // this is so the WAITING message runs again next time we enter that state
-        waitingPromptShown = 0; 
+        waitingPromptShown = 0;
 
-        xSemaphoreTake(uart_sem, portMAX_DELAY);
+        UartTake();
         Disp2String("\n\r[TIME ENTRY] Please enter time as MMSS (e.g., 0130 for 1min 30s), then press ENTER:\n\r> ");
-        xSemaphoreGive(uart_sem);
+        xFastMutexGive(uart_sem);
+
+        // Anything typed before the prompt was not meant for it
+        RingFlush(&uartRxRing);
 
-        // Blocking receives and then echoes characters back
-        RecvUart(inputBuf, sizeof(inputBuf));
-        inputBuf[sizeof(inputBuf)-1] = '\0';
+        timeEntryLength = 0;
+        timeEntryPhase  = TIME_ENTRY_TYPING;
+        return pdMS_TO_TICKS(TIME_ENTRY_POLL_MS);
+    }
 
-        // This is to extract digits only 
-        char digits[5] = {0};
-        int di = 0;
-        for (int i = 0; inputBuf[i] != '\0' && di < 4; i++)
+    if (timeEntryPhase == TIME_ENTRY_TYPING)
+    {
+        // Takes one received character per pass and echoes it back, like
+        // RecvUart() but without holding the CPU until ENTER
+        uint8_t rx;
+        if (!RingGet(&uartRxRing, &rx))
         {
-            if (isdigit((unsigned char)inputBuf[i]))
-            {
-                digits[di++] = inputBuf[i];
-            }
+            return pdMS_TO_TICKS(TIME_ENTRY_POLL_MS);
         }
 
-        int mm = 0;
-        int ss = 0;
+        char c = (char) rx;
+        uint8_t done = (c == 0x0D);
 
-        if (di == 4)
-        {
-            // MMSS
-            mm = (digits[0]-'0')*10 + (digits[1]-'0');
-            ss = (digits[2]-'0')*10 + (digits[3]-'0');
-        }
-        else if (di == 3)
-        {
-            // M SS
-            mm = (digits[0]-'0');
-            ss = (digits[1]-'0')*10 + (digits[2]-'0');
-        }
-        else if (di == 2)
+        // only store alphanumeric characters
+        if (c >= 32 && c <= 126)
         {
-            // treat as seconds only
-            mm = 0;
-            ss = (digits[0]-'0')*10 + (digits[1]-'0');
+            if (timeEntryLength > sizeof(timeEntryBuf) - 2)
+            {
+                UartTake();
+                Disp2String("\ntoo long\n\r");
+                xFastMutexGive(uart_sem);
+                done = 1;
+            }
+            else
+            {
+                timeEntryBuf[timeEntryLength++] = c;
+                UartTake();
+                XmitUART2(c, 1); // loop back display
+                xFastMutexGive(uart_sem);
+                U2STAbits.OERR = 0;
+            }
         }
-        else
+
+        if (!done)
         {
-            // if invalid -> default 00:10
-            mm = 0;
-            ss = 10;
+            return pdMS_TO_TICKS(TIME_ENTRY_POLL_MS);
         }
-        // 60 seconds in a minute
-        if (ss > 59) ss = 59;
 
-        gMinutes = (uint16_t)mm;
-        gSeconds = (uint16_t)ss;
+        timeEntryBuf[timeEntryLength] = '\0';
+        TimeEntryParse(timeEntryBuf);
 
-        xSemaphoreTake(uart_sem, portMAX_DELAY);
+        UartTake();
         Disp2String("\n\r[TIME ENTRY] Time set.\n\r");
         Disp2String("[TIME ENTRY] Click PB2 and PB3 together to start.\n\r");
         Disp2String("[TIME ENTRY] Long press PB2+PB3 to reset and re-enter time.\n\r");
-        xSemaphoreGive(uart_sem);
+        xFastMutexGive(uart_sem);
+
+        // Wait here for PB2+PB3 short or long press
+        comboHoldTicks = 0;
+        comboActive    = 0;
+        timeEntryPhase = TIME_ENTRY_COMBO;
+        return pdMS_TO_TICKS(COMBO_TICK_MS);
+    }
 
-        // Wait here for PB2+PB3 short or long press 
-        uint16_t comboHoldTicks = 0;
-        uint8_t  comboActive    = 0;
-        // Approx 1s long press
-        const uint16_t COMBO_LONG_PRESS_MS    = 1000; 
-        const uint16_t COMBO_TICK_MS          = 20;
-        const uint16_t COMBO_LONG_PRESS_TICKS = (COMBO_LONG_PRESS_MS / COMBO_TICK_MS);
+    // 1 = released, 0 = pressed. (pullup button )
+    uint8_t p2 = PB2_PORT;
+    uint8_t p3 = PB3_PORT;
 
-        for (;;)
+    if ((p2 == 0) && (p3 == 0))
+    {
+        // both pressed
+        if (!comboActive)
+        {
+            comboActive    = 1;
+            comboHoldTicks = 0;
+        }
+        else if (comboHoldTicks < 0xFFFF)
+        {
+            comboHoldTicks++;
+        }
+    }
+    else
+    {
+        if (comboActive)
         {
-            // If other tasks changed the state then break
-            if (currentState != STATE_TIME_ENTRY)
+            // both were pressed and atleast one is released
+            if (comboHoldTicks >= COMBO_LONG_PRESS_TICKS)
             {
-                break;
+                // Long press is to reset timer
+                UartTake();
+                Disp2String("\n\r[TIME ENTRY] Long press PB2+PB3 detected. Resetting time.\n\r");
+                xFastMutexGive(uart_sem);
+
+                gMinutes = 0;
+                gSeconds = 0;
+                // stay in STATE_TIME_ENTRY, the prompt is shown again
             }
-            // 1 = released, 0 = pressed. (pullup button )
-            uint8_t p2 = PB2_PORT; 
-            uint8_t p3 = PB3_PORT;
-
-            if ((p2 == 0) && (p3 == 0))
+            else if (comboHoldTicks > 0)
             {
-                // both pressed
-                if (!comboActive)
-                {
-                    comboActive    = 1;
-                    comboHoldTicks = 0;
-                }
-                else if (comboHoldTicks < 0xFFFF)
-                {
-                    comboHoldTicks++;
-                }
+                // Short click starts the countdown
+                UartTake();
+                Disp2String("\n\r[TIME ENTRY] Starting countdown.\n\r");
+                xFastMutexGive(uart_sem);
+
+                countdownInitialised = 0;
+                SetFsmState(STATE_COUNTDOWN);
             }
-            else
-            {
-                if (comboActive)
-                {
-                    // both were pressed and atleast one is released
-                    if (comboHoldTicks >= COMBO_LONG_PRESS_TICKS)
-                    {
-                        // Long press is to reset timer
-                        xSemaphoreTake(uart_sem, portMAX_DELAY);
-                        Disp2String("\n\r[TIME ENTRY] Long press PB2+PB3 detected. Resetting time.\n\r");
-                        xSemaphoreGive(uart_sem);
 
-                        gMinutes = 0;
-                        gSeconds = 0;
-                        // stay in STATE_TIME_ENTRY, the outer loop will ask for it again 
-                    }
-                    else if (comboHoldTicks > 0)
-                    {
-                        // Short click starts the countdown
-                        xSemaphoreTake(uart_sem, portMAX_DELAY);
-                        Disp2String("\n\r[TIME ENTRY] Starting countdown.\n\r");
-                        xSemaphoreGive(uart_sem);
+            // If it is still TIME_ENTRY we re ask, if it is in the COUNTDOWN we just idle
+            timeEntryPhase = TIME_ENTRY_PROMPT;
+            return 0;
+        }
 
-                        countdownInitialised = 0;
-                        currentState         = STATE_COUNTDOWN;
-                    }
+        // no active combo
+        comboActive    = 0;
+        comboHoldTicks = 0;
+    }
 
-                    break;  // exit inner loop 
-                }
+    return pdMS_TO_TICKS(COMBO_TICK_MS);
+}
 
-                // no active combo
-                comboActive    = 0;
-                comboHoldTicks = 0;
-            }
 
-            vTaskDelay(pdMS_TO_TICKS(COMBO_TICK_MS));
-        }
+// Countdown state
+// Ticks since the countdown task started, widened to 32 bits so a 99:59
+// countdown fits. Has to be called at least once per 16-bit tick wrap
+// (65 s), the countdown polls far more often than that
+static uint32_t CountdownNow(void)
+{
+    TickType_t tick = xTaskGetTickCount();
+
+    countdownNow += (TickType_t)(tick - countdownLastTick);
+    countdownLastTick = tick;
+
+    return countdownNow;
+}
+
+// Whole seconds shown for a remaining time, rounded up so the display only
+// reads 00:00 once the time is really up
+static uint16_t CountdownSeconds(uint32_t remaining)
+{
+    return (uint16_t)((remaining + configTICK_RATE_HZ - 1) / configTICK_RATE_HZ);
+}
+
+// Ticks left of a running countdown. The RTCC only counts whole seconds, so
+// there the part of the current second is dropped
+static uint32_t CountdownTimeLeft(uint32_t now)
+{
+    if (countdownUseRtcc)
+    {
+        return (uint32_t)countdownShownSeconds * configTICK_RATE_HZ;
+    }
 
-        // Outer for(;;) repeats and if state is in TIME_ENTRY we re ask, if it is in the COUNTDOWN we just idle
+    if ((int32_t)(countdownDeadline - now) > 0)
+    {
+        return countdownDeadline - now;
     }
+    return 0;
 }
 
+// Carries on from countdownRemaining ticks left. The next RTCC alarm can
+// come at any point in the first second, so the RTCC mode can lose up to a
+// second here
+static void CountdownResume(uint32_t now)
+{
+    countdownDeadline    = now + countdownRemaining;
+    countdownRtccBase    = RtccSeconds();
+    countdownRtccSeconds = CountdownSeconds(countdownRemaining);
+}
 
-// Countdown task (periodic task which means it repeats)
-void vCountdownTask(void *pvParameters)
+// RTCC mode has the seconds alarm and the PB3 edge interrupt on, tick mode
+// has both off
+static void CountdownTimingSource(uint8_t useRtcc)
 {
-    (void) pvParameters;
+    IEC1bits.IOCIE = 0;
+    IOCFBbits.IOCFB9 = 0;
+    IFS1bits.IOCIF = 0;
+
+    if (useRtcc)
+    {
+        RtccAlarmStart(countdownTask, COUNTDOWN_NOTIFY_SECOND);
+        IEC1bits.IOCIE = 1;
+    }
+    else
+    {
+        RtccAlarmStop();
+    }
+}
 
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+// Initialize once when we first enter COUNTDOWN
+static void CountdownBegin(void)
+{
+    uint32_t now;
 
-    for (;;)
+    LED0_LAT = 0;
+    LED1_LAT = 1;  // start with LED1 on for 1 Hz blink
+    LED2_LAT = 0;  // LED2 brightness via dutyTicks + ADC
+
+    // reset the pulsing state for LED2 now LED2 will be driven by ADC logic
+    pulseCounter = 0;
+    dutyStep     = 1;
+
+    // The whole countdown is one absolute deadline, everything shown
+    // is worked out from the time left until it. The 32-bit count
+    // restarts from here, the task may have waited in other states
+    // for longer than a tick wrap
+    countdownLastTick     = xTaskGetTickCount();
+    now                   = CountdownNow();
+    countdownRemaining    = ((uint32_t)gMinutes * 60 + gSeconds) * configTICK_RATE_HZ;
+    countdownDeadline     = now + countdownRemaining;
+    countdownNextPoll     = now + pdMS_TO_TICKS(COUNTDOWN_POLL_MS);
+    countdownShownSeconds = CountdownSeconds(countdownRemaining);
+    CountdownResume(now);
+    countdownWakes        = 0;
+    countdownLateMax      = 0;
+#if (configUSE_TASK_DELAY_SLACK == 1)
+    countdownWakeTicks    = ulTaskGetWakeTicks();
+#endif
+    countdownPaused       = 0;
+    xEventGroupClearBits(stateEvents, EVT_PAUSE_BIT | EVT_ABORT_BIT);
+    pb3Held               = 0;
+    // start LED2 in the on phase
+    led2BlinkPhase        = 1;
+    // default is blinking
+    led2BlinkMode         = 1;
+    // start with simple time display
+    showExtraInfo         = 0;
+
+    UartTake();
+    Disp2String("\n\r[COUNTDOWN] Countdown started.\n\r");
+    Disp2String("[COUNTDOWN] Click PB3 to pause/resume. Long press PB3 to abort.\n\r");
+    Disp2String("[COUNTDOWN] Type 'i' to toggle extra info, 'b' to toggle LED2 blink/solid.\n\r");
+#if !configUSE_CO_ROUTINES
+    Disp2String("[COUNTDOWN] Type 'r' to switch between tick and RTCC timing.\n\r");
+#endif
+    xFastMutexGive(uart_sem);
+
+    CountdownTimingSource(countdownUseRtcc);
+
+    countdownInitialised = 1;
+}
+
+// when we leave COUNTDOWN, ensure next attempt goes back to initialization
+static void CountdownLeave(void)
+{
+    countdownInitialised = 0;
+    CountdownTimingSource(0);
+}
+
+// Ticks until the next input poll, or until the shown seconds change if
+// that comes first. Tick mode only
+static TickType_t CountdownSleepTicks(void)
+{
+    uint32_t now  = CountdownNow();
+    uint32_t wake = countdownNextPoll;
+
+    if (!countdownPaused && countdownShownSeconds > 0)
     {
-        if (currentState != STATE_COUNTDOWN)
+        // The display goes down by one once the time left drops to the
+        // next whole second
+        uint32_t change = countdownDeadline - (uint32_t)(countdownShownSeconds - 1) * configTICK_RATE_HZ;
+        if ((int32_t)(change - wake) < 0)
         {
-            // when we leave COUNTDOWN, ensure next attempt goes back to initialization 
-            countdownInitialised = 0;
-            vTaskDelay(pdMS_TO_TICKS(20));
-            continue;
+            wake = change;
         }
+    }
 
-        // Initialize once when we first enter COUNTDOWN
-        if (!countdownInitialised)
-        {
-            LED0_LAT = 0;
-            LED1_LAT = 1;  // start with LED1 on for 1 Hz blink
-            LED2_LAT = 0;  // LED2 brightness via dutyTicks + ADC
+    if ((int32_t)(wake - now) > 0)
+    {
+        return (TickType_t)(wake - now);
+    }
+    return 0;
+}
 
-            // reset the pulsing state for LED2 now LED2 will be driven by ADC logic
-            pulseCounter = 0;
-            dutyStep     = 1;
+// Everything the countdown does once it wakes up. In tick mode PB3, the
+// UART keys and the ADC are only polled once the poll period is up, the RTCC
+// mode polls them on every wake
+static void CountdownWake(uint8_t poll)
+{
+    uint32_t now;
+    uint16_t seconds;
+
+    now = CountdownNow();
+    countdownWakes++;
 
-            xLastWakeTime         = xTaskGetTickCount();
-            countdownTickCounter  = 0;
-            countdownPaused       = 0;
-            pb3HoldTicks          = 0;
-            // start LED2 in the on phase
-            led2BlinkPhase        = 1;
-            // default is blinking
-            led2BlinkMode         = 1;
-            // start with simple time display
-            showExtraInfo         = 0;   
-
-            xSemaphoreTake(uart_sem, portMAX_DELAY);
-            Disp2String("\n\r[COUNTDOWN] Countdown started.\n\r");
-            Disp2String("[COUNTDOWN] Click PB3 to pause/resume. Long press PB3 to abort.\n\r");
-            Disp2String("[COUNTDOWN] Type 'i' to toggle extra info, 'b' to toggle LED2 blink/solid.\n\r");
-            xSemaphoreGive(uart_sem);
-
-            countdownInitialised = 1;
+    // PB3, the UART keys and the ADC are polled every 100 ms
+    if (!poll && (int32_t)(now - countdownNextPoll) >= 0)
+    {
+        countdownNextPoll += pdMS_TO_TICKS(COUNTDOWN_POLL_MS);
+        if ((int32_t)(countdownNextPoll - now) <= 0)
+        {
+            // Fell behind by more than a period, poll again a period from now
+            countdownNextPoll = now + pdMS_TO_TICKS(COUNTDOWN_POLL_MS);
         }
+        poll = 1;
+    }
 
-        // Periodic tick 100 ms
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(COUNTDOWN_TICK_MS));
+    if (poll)
+    {
+        // PB3 is for pause/resume (short click) and abort is a (long press)
+        {
 
-        // PB3 is for pause/resume (short click) and abort is a (long press) 
-        {   
-            
             uint8_t pb3 = PB3_PORT;
 
             if (pb3 == 0)
             {
-                // button held down
-                if (pb3HoldTicks < 0xFFFF)
+                // button held down, timed from the first read that saw it
+                if (!pb3Held)
                 {
-                    pb3HoldTicks++;
+                    pb3Held       = 1;
+                    pb3PressStart = now;
                 }
             }
             else
             {
                 // button released
-                if (pb3HoldTicks > 0)
+                if (pb3Held)
                 {
-                    if (pb3HoldTicks >= PB3_LONG_PRESS_TICKS)
+                    pb3Held = 0;
+
+                    if (now - pb3PressStart >= pdMS_TO_TICKS(PB3_LONG_PRESS_MS))
                     {
                         // Long press sends it back to 0:00 and then it will go to DONE
                         gMinutes = 0;
                         gSeconds = 0;
 
-                        xSemaphoreTake(uart_sem, portMAX_DELAY);
+                        UartTake();
                         Disp2String("\n\r[COUNTDOWN] Long press PB3 detected. Aborting timer to 00:00.\n\r");
-                        xSemaphoreGive(uart_sem);
+                        xFastMutexGive(uart_sem);
 
                         countdownInitialised = 0;
                         doneBlinkCount       = 0;
                         doneMessageShown     = 0;
-                        currentState         = STATE_DONE;
+                        countdownPaused      = 0;
+                        xEventGroupClearBits(stateEvents, EVT_PAUSE_BIT);
+                        xEventGroupSetBits(stateEvents, EVT_ABORT_BIT);
+                        SetFsmState(STATE_DONE);
 
-                        pb3HoldTicks = 0;
-                        continue; //in the next one it will be state done and next logic
+                        return; //in the next one it will be state done and next logic
                     }
                     else
                     {
-                        // Short click is for toggle pause/resume
+                        // Short click is for toggle pause/resume. Pausing
+                        // keeps the time left, resuming sets a new deadline
+                        // that far from now, so the sub-second phase is kept
                         countdownPaused ^= 1;
+                        if (countdownPaused)
+                        {
+                            countdownRemaining = CountdownTimeLeft(now);
+                            xEventGroupSetBits(stateEvents, EVT_PAUSE_BIT);
+                        }
+                        else
+                        {
+                            CountdownResume(now);
+                            xEventGroupClearBits(stateEvents, EVT_PAUSE_BIT);
+                        }
 
-                        xSemaphoreTake(uart_sem, portMAX_DELAY);
+                        UartTake();
                         if (countdownPaused)
                         {
                             Disp2String("\n\r[COUNTDOWN] Paused.\n\r");
@@ -702,20 +1072,17 @@ void vCountdownTask(void *pvParameters)
                         {
                             Disp2String("\n\r[COUNTDOWN] Resumed.\n\r");
                         }
-                        xSemaphoreGive(uart_sem);
+                        xFastMutexGive(uart_sem);
                     }
-
-                    pb3HoldTicks = 0;
                 }
             }
         }
 
-        // Handle the i and b uart commands
-        if (RXFlag)
+        // Handle the i, b and r uart commands
+        uint8_t rx;
+        if (RingGet(&uartRxRing, &rx))
         {
-            char c = received_char;
-            // clear this flag so we can see the next char
-            RXFlag = 0;     
+            char c = (char) rx;
 
             if (c == 'i')
             {
@@ -727,7 +1094,7 @@ void vCountdownTask(void *pvParameters)
                 // toggle LED2 mode either blink or solid
                 led2BlinkMode ^= 1;
 
-                xSemaphoreTake(uart_sem, portMAX_DELAY);
+                UartTake();
                 if (led2BlinkMode)
                 {
                     Disp2String("\n\r[COUNTDOWN] LED2 set to BLINK mode.\n\r");
@@ -736,11 +1103,40 @@ void vCountdownTask(void *pvParameters)
                 {
                     Disp2String("\n\r[COUNTDOWN] LED2 set to SOLID mode.\n\r");
                 }
-                xSemaphoreGive(uart_sem);
+                xFastMutexGive(uart_sem);
+            }
+#if !configUSE_CO_ROUTINES
+            // The RTCC mode waits on task notifications, so it needs the
+            // countdown to be a task
+            else if (c == 'r')
+            {
+                // Hand the time left over to the other timing source
+                if (!countdownPaused)
+                {
+                    countdownRemaining = CountdownTimeLeft(now);
+                }
+                countdownUseRtcc ^= 1;
+                CountdownTimingSource(countdownUseRtcc);
+                if (!countdownPaused)
+                {
+                    CountdownResume(now);
+                }
+
+                UartTake();
+                if (countdownUseRtcc)
+                {
+                    Disp2String("\n\r[COUNTDOWN] Timing from the RTCC seconds alarm.\n\r");
+                }
+                else
+                {
+                    Disp2String("\n\r[COUNTDOWN] Timing from the kernel tick.\n\r");
+                }
+                xFastMutexGive(uart_sem);
             }
+#endif
         }
 
-        // Here ADC reads 
+        // Here ADC reads
         {
             uint16_t adcVal = do_ADC();   // 0..1023 from AN5
             lastAdcVal = adcVal;
@@ -770,149 +1166,157 @@ void vCountdownTask(void *pvParameters)
                 dutyTicks = led2DutyFromADC;
             }
         }
+    }
 
-        // Increments countdown tick counter
-        countdownTickCounter++;
-        if (countdownTickCounter >= (1000 / COUNTDOWN_TICK_MS))
-        {
-            countdownTickCounter = 0;
+    // Nothing to show while paused, the time left is frozen
+    if (countdownPaused)
+    {
+        return;
+    }
 
-            // Only decrement and blink when not paused
-            if (!countdownPaused)
-            {
-                // Decrement time
-                if (gMinutes == 0 && gSeconds == 0)
-                {
-                    // already at zero, go to DONE
-                    currentState     = STATE_DONE;
-                    doneBlinkCount   = 0;
-                    doneMessageShown = 0;
-                }
-                else
-                {
-                    if (gSeconds == 0)
-                    {
-                        if (gMinutes > 0)
-                        {
-                            gMinutes--;
-                            gSeconds = 59;
-                        }
-                    }
-                    else
-                    {
-                        gSeconds--;
-                    }
+    // Time left from the deadline or from the RTCC seconds since it took
+    // over, so the count never drifts with how late the task runs
+    if (countdownUseRtcc)
+    {
+        uint32_t elapsed = RtccSeconds() - countdownRtccBase;
+        seconds = (elapsed < countdownRtccSeconds) ? (uint16_t)(countdownRtccSeconds - elapsed) : 0;
+    }
+    else
+    {
+        seconds = CountdownSeconds(CountdownTimeLeft(now));
+    }
 
-                    // Blink LED1 at 1 Hz approximately (slightly faster) toggle every second
-                    LED1_LAT ^= 1;  // 1s on / 1s off
+    // Only a change of the shown seconds needs any work, except a
+    // countdown that started at zero still has to reach DONE
+    if (seconds == countdownShownSeconds && seconds != 0)
+    {
+        return;
+    }
+    countdownShownSeconds = seconds;
 
-                    // LED2 blink phase toggle once each second if in blink mode
-                    if (led2BlinkMode)
-                    {
-                        led2BlinkPhase ^= 1;
-                    }
-                }
-            }
+    // How long after the time left reached this second the display caught
+    // up, to compare the task and co-routine builds
+    if (!countdownUseRtcc)
+    {
+        uint32_t late = now - (countdownDeadline - (uint32_t)seconds * configTICK_RATE_HZ);
+        if ((int32_t)late > 0 && late > countdownLateMax)
+        {
+            countdownLateMax = (uint16_t)late;
+        }
+    }
 
-            // Print time (simple/extended)
-            if (!showExtraInfo)
-            {
-                // simple time view
-                PrintTimeUART(gMinutes, gSeconds);
-            }
-            else
-            {
-                // extended view with time, ADC, duty and the mode
-                xSemaphoreTake(uart_sem, portMAX_DELAY);
-                Disp2String("\n\rTime remaining (extended): ");
-                xSemaphoreGive(uart_sem);
+    gMinutes = seconds / 60;
+    gSeconds = seconds % 60;
 
-                PrintTimeUART(gMinutes, gSeconds);
+    // Blink LED1 at 1 Hz, toggled each time a second goes by
+    LED1_LAT ^= 1;  // 1s on / 1s off
 
-                xSemaphoreTake(uart_sem, portMAX_DELAY);
-                Disp2String(" | ADC = ");
-                PrintUIntDec(lastAdcVal);
+    // LED2 blink phase toggle once each second if in blink mode
+    if (led2BlinkMode)
+    {
+        led2BlinkPhase ^= 1;
+    }
 
-                Disp2String(" | LED2 dutyTicks = ");
-                PrintUIntDec(led2DutyFromADC);
+    // Print time (simple/extended)
+    if (!showExtraInfo)
+    {
+        // simple time view
+        PrintTimeUART(gMinutes, gSeconds);
+    }
+    else
+    {
+        // extended view with time, ADC, duty and the mode
+        UartTake();
+        Disp2String("\n\rTime remaining (extended): ");
+        xFastMutexGive(uart_sem);
 
-                Disp2String(" | LED2 mode = ");
-                if (led2BlinkMode)
-                {
-                    Disp2String("BLINK");
-                }
-                else
-                {
-                    Disp2String("SOLID");
-                }
+        PrintTimeUART(gMinutes, gSeconds);
 
-                xSemaphoreGive(uart_sem);
-            }
+        UartTake();
+        Disp2String(" | ADC = ");
+        PrintUIntDec(lastAdcVal);
 
-            // If it has reached 0
-            if (!countdownPaused && gMinutes == 0 && gSeconds == 0)
-            {
-                currentState     = STATE_DONE;
-                doneBlinkCount   = 0;
-                doneMessageShown = 0;
-            }
+        Disp2String(" | LED2 dutyTicks = ");
+        PrintUIntDec(led2DutyFromADC);
+
+        Disp2String(" | LED2 mode = ");
+        if (led2BlinkMode)
+        {
+            Disp2String("BLINK");
+        }
+        else
+        {
+            Disp2String("SOLID");
+        }
+
+        Disp2String(" | timing = ");
+        if (countdownUseRtcc)
+        {
+            Disp2String("RTCC");
         }
+        else
+        {
+            Disp2String("TICK");
+        }
+
+        Disp2String(" | wakes = ");
+        PrintUIntDec(countdownWakes);
+
+        Disp2String(" | late max = ");
+        PrintUIntDec(countdownLateMax);
+
+#if (configUSE_TASK_DELAY_SLACK == 1)
+        Disp2String(" | wake ticks = ");
+        PrintUIntDec((uint16_t)(ulTaskGetWakeTicks() - countdownWakeTicks));
+#endif
+
+        xFastMutexGive(uart_sem);
     }
-}
 
+    // If it has reached 0
+    if (seconds == 0)
+    {
+        doneBlinkCount   = 0;
+        doneMessageShown = 0;
+        SetFsmState(STATE_DONE);
+    }
+}
 
 // Done state
-void vDoneTask(void *pvParameters)
+static TickType_t DoneStep(void)
 {
-    (void) pvParameters;
+    // After the timer has finished, the terminal messages that the countdown is done,
+    // and LED0 and LED1 blink rapidly in an alternating fashion.
+    // LED2 should remain solidly on. After 5 seconds it will return to WAITING.
 
-    for (;;)
+    if (!doneMessageShown)
     {
-        if (currentState != STATE_DONE)
+        // the abort bit tells us if we got here from a PB3 long press
+        EventBits_t bits = xEventGroupClearBits(stateEvents, EVT_ABORT_BIT);
+
+        UartTake();
+        if (bits & EVT_ABORT_BIT)
         {
-            vTaskDelay(pdMS_TO_TICKS(20));
-            continue;
+            Disp2String("\n\r[DONE] Countdown aborted! Timer set to 00:00.\n\r");
         }
-
-        // After the timer has finished, the terminal messages that the countdown is done,
-        // and LED0 and LED1 blink rapidly in an alternating fashion.
-        // LED2 should remain solidly on. After 5 seconds it will return to WAITING.
-
-        if (!doneMessageShown)
+        else
         {
-            xSemaphoreTake(uart_sem, portMAX_DELAY);
             Disp2String("\n\r[DONE] Countdown complete! Timer reached 00:00.\n\r");
-            xSemaphoreGive(uart_sem);
-
-            doneMessageShown = 1;
-            doneBlinkCount   = 0;
-
-            LED0_LAT = 1;
-            LED1_LAT = 0;
-
-            // LED2 is solid, brightness from ADC via the PWM
-            led2BlinkMode = 0;  // sets it to solid mode
         }
+        xFastMutexGive(uart_sem);
 
-        // Alternate LED0 and LED1 quickly approx 100ms period
-        LED0_LAT ^= 1;
-        LED1_LAT = !LED0_LAT;
-
-        // LED2 brightness still controlled by potentiometer when solid during this phase
-        {
-            uint16_t adcVal = do_ADC();
-            lastAdcVal = adcVal;
-            led2DutyFromADC = (uint32_t)adcVal * DUTY_MAX_TICKS / 1023u;
-            if (led2DutyFromADC > DUTY_MAX_TICKS)
-            {
-                led2DutyFromADC = DUTY_MAX_TICKS;
-            }
+        doneMessageShown = 1;
+        doneBlinkCount   = 0;
 
-            // In DONE, LED2 should be solid at the ADC brightness
-            dutyTicks = led2DutyFromADC;
-        }
+        LED0_LAT = 1;
+        LED1_LAT = 0;
 
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // LED2 is solid, brightness from ADC via the PWM
+        led2BlinkMode = 0;  // sets it to solid mode
+    }
+    else
+    {
+        // One more 100 ms blink period has gone by
         doneBlinkCount++;
 
         // formula for the time is 100ms * 50 = 5s
@@ -933,12 +1337,227 @@ void vDoneTask(void *pvParameters)
             pulseCounter = 0;
 
             waitingPromptShown = 0;
-            currentState       = WAITING_ST;
+            SetFsmState(WAITING_ST);
+            return 0;
+        }
+    }
+
+    // Alternate LED0 and LED1 quickly approx 100ms period
+    LED0_LAT ^= 1;
+    LED1_LAT = !LED0_LAT;
+
+    // LED2 brightness still controlled by potentiometer when solid during this phase
+    {
+        uint16_t adcVal = do_ADC();
+        lastAdcVal = adcVal;
+        led2DutyFromADC = (uint32_t)adcVal * DUTY_MAX_TICKS / 1023u;
+        if (led2DutyFromADC > DUTY_MAX_TICKS)
+        {
+            led2DutyFromADC = DUTY_MAX_TICKS;
         }
+
+        // In DONE, LED2 should be solid at the ADC brightness
+        dutyTicks = led2DutyFromADC;
     }
+
+    return pdMS_TO_TICKS(100);
 }
 
 
+#if configUSE_CO_ROUTINES
+
+// The states the co-routines run, one each, picked by uxIndex
+static const TimerState_t fsmCoRoutineStates[] = { WAITING_ST, STATE_TIME_ENTRY, STATE_COUNTDOWN, STATE_DONE };
+
+#define FSM_CO_ROUTINES (sizeof(fsmCoRoutineStates) / sizeof(fsmCoRoutineStates[0]))
+
+// A state that is not current is checked again after this long
+#define FSM_CO_ROUTINE_IDLE_MS  10
+
+static CRCB_t fsmCoRoutineCRCB[FSM_CO_ROUTINES];
+
+// Tick mode countdown as a step
+static TickType_t CountdownStep(void)
+{
+    if (!countdownInitialised)
+    {
+        CountdownBegin();
+    }
+    else
+    {
+        CountdownWake(0);
+    }
+
+    return CountdownSleepTicks();
+}
+
+// A co-routine has no stack of its own, locals are lost at every crDELAY,
+// so all state lives in the statics of the step functions
+static void crFsm(CoRoutineHandle_t xHandle, UBaseType_t uxIndex)
+{
+    TickType_t wait;
+
+    crSTART(xHandle);
+
+    for (;;)
+    {
+        TimerState_t state = fsmCoRoutineStates[uxIndex];
+
+        if (!IsFsmState(state))
+        {
+            if (state == STATE_TIME_ENTRY)
+            {
+                timeEntryPhase = TIME_ENTRY_PROMPT;
+            }
+            else if (state == STATE_COUNTDOWN && countdownInitialised)
+            {
+                CountdownLeave();
+            }
+            wait = pdMS_TO_TICKS(FSM_CO_ROUTINE_IDLE_MS);
+        }
+        else if (state == WAITING_ST)
+        {
+            wait = WaitingStep();
+        }
+        else if (state == STATE_TIME_ENTRY)
+        {
+            wait = TimeEntryStep();
+        }
+        else if (state == STATE_COUNTDOWN)
+        {
+            wait = CountdownStep();
+        }
+        else
+        {
+            wait = DoneStep();
+        }
+
+        crDELAY(xHandle, wait);
+    }
+
+    crEND();
+}
+
+#else
+
+// The polling states may wake up to this much late, so their wake-ups can
+// share ticks with other tasks' and leave longer idle periods. The countdown
+// keeps exact delays, its display would drift. PB2+PB3 combo steps stretch
+// too, the long press can take up to 20% longer
+#if (configUSE_TASK_DELAY_SLACK == 1)
+#define FSM_POLL_SLACK_MS       4
+#define FsmPollDelay(ticks)     vTaskDelayWithSlack((ticks), pdMS_TO_TICKS(FSM_POLL_SLACK_MS))
+#else
+#define FsmPollDelay(ticks)     vTaskDelay(ticks)
+#endif
+
+// Waiting task
+void vWaitingTask(void *pvParameters)
+{
+    (void) pvParameters;
+
+    for (;;)
+    {
+        if (!IsFsmState(WAITING_ST))
+        {
+            // Sleep until the FSM comes back to WAITING
+            WaitForFsmState(WAITING_ST);
+            continue;
+        }
+
+        FsmPollDelay(WaitingStep());
+    }
+}
+
+
+// Time Entry task
+void vTimeEntryTask(void *pvParameters)
+{
+    (void) pvParameters;
+
+    for (;;)
+    {
+        if (!IsFsmState(STATE_TIME_ENTRY))
+        {
+            // Ask again from the prompt next time
+            timeEntryPhase = TIME_ENTRY_PROMPT;
+            WaitForFsmState(STATE_TIME_ENTRY);
+            continue;
+        }
+
+        FsmPollDelay(TimeEntryStep());
+    }
+}
+
+
+// Countdown task (periodic task which means it repeats)
+void vCountdownTask(void *pvParameters)
+{
+    (void) pvParameters;
+
+    uint32_t events;
+    TickType_t wait;
+
+    for (;;)
+    {
+        if (!IsFsmState(STATE_COUNTDOWN))
+        {
+            CountdownLeave();
+            WaitForFsmState(STATE_COUNTDOWN);
+            continue;
+        }
+
+        if (!countdownInitialised)
+        {
+            CountdownBegin();
+        }
+
+        if (countdownUseRtcc)
+        {
+            // Sleep until the next RTCC second or PB3 edge, the alarm runs
+            // while paused too so the keys are still seen within a second
+            xTaskNotifyWait(0, COUNTDOWN_NOTIFY_SECOND | COUNTDOWN_NOTIFY_PB3, &events, portMAX_DELAY);
+            if (events & COUNTDOWN_NOTIFY_PB3)
+            {
+                // Bounces in the meantime need no wake of their own
+                vTaskDelay(pdMS_TO_TICKS(PB3_DEBOUNCE_MS));
+                ulTaskNotifyValueClear(NULL, COUNTDOWN_NOTIFY_PB3);
+            }
+            CountdownWake(1);
+        }
+        else
+        {
+            wait = CountdownSleepTicks();
+            if (wait > 0)
+            {
+                vTaskDelay(wait);
+            }
+            CountdownWake(0);
+        }
+    }
+}
+
+
+// Done task
+void vDoneTask(void *pvParameters)
+{
+    (void) pvParameters;
+
+    for (;;)
+    {
+        if (!IsFsmState(STATE_DONE))
+        {
+            WaitForFsmState(STATE_DONE);
+            continue;
+        }
+
+        FsmPollDelay(DoneStep());
+    }
+}
+
+#endif // configUSE_CO_ROUTINES
+
+
 
 void prvHardwareSetup(void)
 {
@@ -974,17 +1593,33 @@ void prvHardwareSetup(void)
 
     // Initialize the timer 2 for LED pulsing and PWM
     InitTimer2ForPWM();
+
+    // PB3 edges on both directions for the RTCC countdown, the interrupt
+    // itself is only enabled while that mode runs
+    PADCONbits.IOCON = 1;
+    IOCPBbits.IOCPB9 = 1;
+    IOCNBbits.IOCNB9 = 1;
+    IPC4bits.IOCIP = 2;
+
+    // RTCC seconds for the RTCC countdown mode
+    RtccInit();
     
 }
 
 int main(void) {
     
+    // Before the hardware, the T2 interrupt that prvHardwareSetup() turns on
+    // reads stateEvents from its first tick
+    uart_sem = xFastMutexCreateStatic(&uartSemBuffer);
+#if TRACE_ENABLE
+    TraceNameFastMutex(uart_sem, "uart");
+#endif
+    stateEvents = xEventGroupCreateStatic(&stateEventsBuffer);
+
     prvHardwareSetup();
 
-    uart_sem = xSemaphoreCreateMutex();
-    
     // FSM initialization for ALL variables 
-    currentState          = WAITING_ST;
+    SetFsmState(WAITING_ST);
     waitingPromptShown    = 0;
     countdownInitialised  = 0;
     doneBlinkCount        = 0;
@@ -1003,22 +1638,41 @@ int main(void) {
     led2BlinkPhase        = 1;
 
     countdownPaused       = 0;
-    countdownTickCounter  = 0;
-    pb3HoldTicks          = 0;
+    pb3Held               = 0;
+    countdownUseRtcc      = 0;
     lastAdcVal            = 0;
 
+#if configUSE_CO_ROUTINES
+    // All four states as co-routines of the idle task, one per state
+    for (UBaseType_t i = 0; i < FSM_CO_ROUTINES; i++)
+    {
+        xCoRoutineCreateStatic(crFsm, 0, i, &fsmCoRoutineCRCB[i]);
+    }
+#else
     // Using multiple tasks for good FreeRTOS implementation
     // WAITING & PB1 
-    xTaskCreate( vWaitingTask, "WaitTask", TASK_STACK_SIZE, NULL, 2, NULL);
+    xTaskCreateStatic( vWaitingTask, "WaitTask", STACK_SIZE_WAITTASK, NULL, 2, waitTaskStack, &waitTaskTCB);
 
     // TIME ENTRY using UART with the PB2+PB3 combo (aperiodic)
-    xTaskCreate( vTimeEntryTask, "TimeEntryTask", TASK_STACK_SIZE, NULL, 2, NULL);
+    xTaskCreateStatic( vTimeEntryTask, "TimeEntryTask", STACK_SIZE_TIMEENTRYTASK, NULL, 2, timeEntryTaskStack, &timeEntryTaskTCB);
 
     // COUNTDOWN has the core timing with the ADC, PB3 pause/abort and "i"/"b" its a periodic function
-    xTaskCreate( vCountdownTask, "CountdownTask", TASK_STACK_SIZE, NULL, 3, NULL);
+    countdownTask = xTaskCreateStatic( vCountdownTask, "CountdownTask", STACK_SIZE_COUNTDOWNTASK, NULL, 3, countdownTaskStack, &countdownTaskTCB);
 
     // DONE state has LED2 as solid via the ADC and a timeout back to WAITING
-    xTaskCreate( vDoneTask, "DoneTask", TASK_STACK_SIZE, NULL, 2, NULL);
+    xTaskCreateStatic( vDoneTask, "DoneTask", STACK_SIZE_DONETASK, NULL, 2, doneTaskStack, &doneTaskTCB);
+#endif
+
+    // Kernel statistics on UART2, see console.h for the command keys
+    ConsoleStart();
+
+    // Named countdown timers driven from the console
+    MultiTimerStart();
+
+#if BENCH_ENABLE
+    // Cycle count benchmarks, run once at the lowest priority after start up
+    BenchStart();
+#endif
 
     vTaskStartScheduler();
     
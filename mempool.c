@@ -0,0 +1,203 @@
+/*
+ * File:   mempool.c
+ *
+ * Fixed block memory pools and the size classes over them. The free list is
+ * only touched with the API interrupts masked, a handful of instructions, so
+ * any task or API interrupt can take or give a block.
+ */
+
+#include "FreeRTOS.h"
+#include "mempool.h"
+
+// The application's size classes, smallest first, see MemPoolStart()
+static MemPool_t * const *poolClasses;
+static uint8_t poolClassCount;
+
+// MemPoolFree() calls with a block no class owns
+static uint16_t foreignFrees;
+
+void MemPoolInit(MemPool_t *pool)
+{
+    uint16_t i;
+    uint8_t *block;
+
+    for (i = 0; i < (uint16_t) (pool->blockCount + 15) / 16; i++)
+    {
+        pool->inUse[i] = 0;
+    }
+
+    // Chain every block onto the free list, lowest address first
+    pool->freeList = NULL;
+    for (i = pool->blockCount; i != 0; i--)
+    {
+        block = pool->storage + (uint16_t) (i - 1) * pool->blockSize;
+        *(void **) block = pool->freeList;
+        pool->freeList = block;
+    }
+
+    pool->used = 0;
+    pool->highWater = 0;
+    pool->failures = 0;
+    pool->badGives = 0;
+}
+
+// Index of the block at address, or blockCount if it is not the start of one
+// of the pool's blocks
+static uint16_t MemPoolIndex(const MemPool_t *pool, const uint8_t *address)
+{
+    uint16_t offset;
+
+    if (address < pool->storage)
+    {
+        return pool->blockCount;
+    }
+
+    offset = (uint16_t) (address - pool->storage);
+    if (offset >= (uint16_t) (pool->blockSize * pool->blockCount) ||
+        offset % pool->blockSize != 0)
+    {
+        return pool->blockCount;
+    }
+
+    return offset / pool->blockSize;
+}
+
+void *MemPoolTake(MemPool_t *pool)
+{
+    void *block;
+    uint16_t index;
+    UBaseType_t savedIPL;
+
+    savedIPL = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    block = pool->freeList;
+    if (block != NULL)
+    {
+        index = MemPoolIndex(pool, block);
+        pool->inUse[index / 16] |= (uint16_t) (1U << (index % 16));
+        pool->freeList = *(void **) block;
+        pool->used++;
+        if (pool->used > pool->highWater)
+        {
+            pool->highWater = pool->used;
+        }
+    }
+    else
+    {
+        pool->failures++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(savedIPL);
+
+    return block;
+}
+
+uint8_t MemPoolGive(MemPool_t *pool, void *block)
+{
+    uint16_t index = MemPoolIndex(pool, block);
+    uint16_t bit;
+    uint8_t given = 0;
+    UBaseType_t savedIPL;
+
+    savedIPL = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    // A foreign block or a second give would corrupt the free list
+    bit = (uint16_t) (1U << (index % 16));
+    if (index < pool->blockCount && (pool->inUse[index / 16] & bit) != 0)
+    {
+        pool->inUse[index / 16] &= (uint16_t) ~bit;
+        *(void **) block = pool->freeList;
+        pool->freeList = block;
+        pool->used--;
+        given = 1;
+    }
+    else
+    {
+        pool->badGives++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(savedIPL);
+
+    return given;
+}
+
+void *MemPoolAlloc(size_t size)
+{
+    uint8_t i;
+    void *block;
+
+    // A full class falls through to the next larger one, each empty class
+    // on the way counts a failure
+    for (i = 0; i < poolClassCount; i++)
+    {
+        if (poolClasses[i]->blockSize >= size)
+        {
+            block = MemPoolTake(poolClasses[i]);
+            if (block != NULL)
+            {
+                return block;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+uint8_t MemPoolFree(void *block)
+{
+    uint8_t i;
+    MemPool_t *pool;
+    uint8_t *address = block;
+    UBaseType_t savedIPL;
+
+    if (block == NULL)
+    {
+        return 1;
+    }
+
+    // The owner is the class whose storage holds the block
+    for (i = 0; i < poolClassCount; i++)
+    {
+        pool = poolClasses[i];
+        if (address >= pool->storage &&
+            address < pool->storage + (uint16_t) (pool->blockSize * pool->blockCount))
+        {
+            return MemPoolGive(pool, block);
+        }
+    }
+
+    // Not from any class
+    savedIPL = portSET_INTERRUPT_MASK_FROM_ISR();
+    foreignFrees++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(savedIPL);
+
+    return 0;
+}
+
+void MemPoolStart(MemPool_t * const *classes, uint8_t count)
+{
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        MemPoolInit(classes[i]);
+    }
+
+    poolClasses = classes;
+    poolClassCount = count;
+}
+
+uint8_t MemPoolClassCount(void)
+{
+    return poolClassCount;
+}
+
+const MemPool_t *MemPoolClass(uint8_t index)
+{
+    return poolClasses[index];
+}
+
+uint16_t MemPoolForeignFrees(void)
+{
+    return foreignFrees;
+}
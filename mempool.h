@@ -0,0 +1,84 @@
+/*
+ * File:   mempool.h
+ *
+ * Fixed block memory pools. Each pool is a statically sized array of equal
+ * blocks kept on a free list, so taking and giving a block is O(1), never
+ * fragments, and is safe from tasks and from interrupts at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY. Blocks are meant to be passed
+ * between tasks by pointer, the receiver gives the block back when done.
+ *
+ * MemPoolAlloc() picks the smallest size class with a free block that fits,
+ * MemPoolTake() takes from one pool only. The size classes are the
+ * application's own, defined with MEMPOOL_DEFINE() and handed to
+ * MemPoolStart(), so no RAM goes to pools nothing uses.
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct
+{
+    const char *name;
+    // Block size in bytes, a whole number of words
+    uint16_t blockSize;
+    uint16_t blockCount;
+    uint8_t *storage;
+    // One bit per block, set while the block is taken
+    uint16_t *inUse;
+
+    // First free block, each free block holds a pointer to the next
+    void *freeList;
+
+    // Blocks in use now and at most since reset, takes that found the pool
+    // empty, and gives of a block the pool does not own or that was already
+    // free, which are ignored
+    uint16_t used;
+    uint16_t highWater;
+    uint16_t failures;
+    uint16_t badGives;
+} MemPool_t;
+
+// Rounds a block size up to whole words, at least one pointer
+#define MEMPOOL_BLOCK_SIZE(size) \
+    ((((size) < sizeof(void *) ? sizeof(void *) : (size)) + 1) & ~1U)
+
+// Defines a pool and its storage at compile time, e.g.
+//   MEMPOOL_DEFINE(logPool, 40, 6);
+// makes a MemPool_t named logPool with 6 blocks of 40 bytes. The pool has to
+// go through MemPoolInit() before the first take
+#define MEMPOOL_DEFINE(pool, size, count)                                       \
+    static uint16_t pool##Storage[(MEMPOOL_BLOCK_SIZE(size) / 2) * (count)];    \
+    static uint16_t pool##InUse[((count) + 15) / 16];                           \
+    MemPool_t pool = { #pool, MEMPOOL_BLOCK_SIZE(size), (count), (uint8_t *) pool##Storage, \
+                       pool##InUse, NULL, 0, 0, 0, 0 }
+
+void MemPoolInit(MemPool_t *pool);
+void *MemPoolTake(MemPool_t *pool);
+// Returns 0, and counts a bad give, for a block that is not one of the
+// pool's or is already free
+uint8_t MemPoolGive(MemPool_t *pool, void *block);
+
+// Size classes. Returns NULL if no class has a block of at least size bytes
+// free
+void *MemPoolAlloc(size_t size);
+// Gives a block from MemPoolAlloc() back to the class it came from, returns
+// 0 if no class owns it or it is already free
+uint8_t MemPoolFree(void *block);
+
+// Sets up count size classes, smallest block first, e.g.
+//   MEMPOOL_DEFINE(logPool, 40, 6);
+//   static MemPool_t * const appPools[] = { &logPool };
+//   MemPoolStart(appPools, 1);
+// Call before vTaskStartScheduler(). Until then there are no classes
+void MemPoolStart(MemPool_t * const *classes, uint8_t count);
+
+// Number of size classes, and each one by index for reporting
+uint8_t MemPoolClassCount(void);
+const MemPool_t *MemPoolClass(uint8_t index);
+// MemPoolFree() calls with a block none of the classes owns
+uint16_t MemPoolForeignFrees(void);
+
+#endif
@@ -0,0 +1,432 @@
+/*
+ * File:   multitimer.c
+ *
+ * Named countdown timers on a timing wheel, see multitimer.h. The console
+ * task parses each '!' line into a command and queues it, the timer task
+ * is the only one that touches the timers or the wheel. Finding a timer by
+ * name walks the table, that only happens per typed command, never while
+ * timing.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "fast_mutex.h"
+#include "uart.h"
+#include "multitimer.h"
+#include "wheel.h"
+#include "stack_sizes.h"
+#include "trace.h"
+#include <string.h>
+
+#define MULTITIMER_PRIORITY     2
+#define MULTITIMER_QUEUE_LEN    4
+
+// Same limit as the FSM time entry, 99:59
+#define MULTITIMER_MAX_SECONDS  5999
+
+typedef enum
+{
+    MULTITIMER_FREE = 0,
+    MULTITIMER_RUNNING,
+    MULTITIMER_PAUSED
+} MultiTimerState_t;
+
+typedef struct
+{
+    // First, so a timer off the wheel is the MultiTimer_t itself
+    WheelTimer_t link;
+    char name[MULTITIMER_NAME_LEN + 1];
+    uint8_t state;
+    // Ticks left, only valid while paused
+    uint32_t remaining;
+} MultiTimer_t;
+
+typedef enum
+{
+    MULTITIMER_CMD_NEW,
+    MULTITIMER_CMD_PAUSE,
+    MULTITIMER_CMD_RESUME,
+    MULTITIMER_CMD_ABORT,
+    MULTITIMER_CMD_LIST,
+    // Not a command, the line did not parse
+    MULTITIMER_CMD_NONE
+} MultiTimerOp_t;
+
+typedef struct
+{
+    uint8_t op;
+    char name[MULTITIMER_NAME_LEN + 1];
+    uint32_t ticks;
+} MultiTimerCmd_t;
+
+// Uart mutex from main.c
+extern FastMutexHandle_t uart_sem;
+
+static MultiTimer_t timers[MULTITIMER_MAX];
+static Wheel_t wheel;
+
+static QueueHandle_t commandQueue = NULL;
+static StaticQueue_t commandQueueBuffer;
+static uint8_t commandQueueStorage[MULTITIMER_QUEUE_LEN * sizeof(MultiTimerCmd_t)];
+
+static StaticTask_t multiTimerTaskTCB;
+static StackType_t multiTimerTaskStack[STACK_SIZE_MULTITIMER];
+
+// Tick count widened to 32 bits, the task never sleeps longer than one turn
+// of the wheel while any timer runs
+static uint32_t multiTimerNow = 0;
+static TickType_t multiTimerLastTick = 0;
+
+static uint32_t MultiTimerNow(void)
+{
+    TickType_t tick = xTaskGetTickCount();
+
+    multiTimerNow += (TickType_t)(tick - multiTimerLastTick);
+    multiTimerLastTick = tick;
+
+    return multiTimerNow;
+}
+
+static void MultiTimerMessage(const char *name, const char *what)
+{
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+    Disp2String("\n\r[TIMER] ");
+    Disp2String((char *) name);
+    Disp2String((char *) what);
+    xFastMutexGive(uart_sem);
+}
+
+// Prints ticks as mm:ss, rounded up like the FSM countdown
+static void MultiTimerPrintTime(uint32_t ticks)
+{
+    uint16_t seconds = (uint16_t)((ticks + configTICK_RATE_HZ - 1) / configTICK_RATE_HZ);
+
+    if (seconds / 60 < 10)
+    {
+        XmitUART2('0', 1);
+    }
+    Disp2Dec(seconds / 60);
+    XmitUART2(':', 1);
+    if (seconds % 60 < 10)
+    {
+        XmitUART2('0', 1);
+    }
+    Disp2Dec(seconds % 60);
+}
+
+static MultiTimer_t *MultiTimerFind(const char *name)
+{
+    uint8_t i;
+
+    for (i = 0; i < MULTITIMER_MAX; i++)
+    {
+        if (timers[i].state != MULTITIMER_FREE && strcmp(timers[i].name, name) == 0)
+        {
+            return &timers[i];
+        }
+    }
+    return NULL;
+}
+
+static void MultiTimerList(uint32_t now)
+{
+    uint8_t i;
+    uint8_t count = 0;
+    uint32_t left;
+
+    for (i = 0; i < MULTITIMER_MAX; i++)
+    {
+        if (timers[i].state == MULTITIMER_FREE)
+        {
+            continue;
+        }
+
+        if (timers[i].state == MULTITIMER_PAUSED)
+        {
+            left = timers[i].remaining;
+        }
+        else if ((int32_t)(timers[i].link.deadline - now) > 0)
+        {
+            left = timers[i].link.deadline - now;
+        }
+        else
+        {
+            left = 0;
+        }
+
+        // One line at a time so the FSM output is not held up
+        xFastMutexTake(uart_sem, portMAX_DELAY);
+        Disp2String("\n\r[TIMER] ");
+        Disp2String(timers[i].name);
+        XmitUART2(' ', MULTITIMER_NAME_LEN + 1 - strlen(timers[i].name));
+        MultiTimerPrintTime(left);
+        if (timers[i].state == MULTITIMER_PAUSED)
+        {
+            Disp2String(" paused");
+        }
+        xFastMutexGive(uart_sem);
+
+        count++;
+    }
+
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+    Disp2String("\n\r[TIMER] ");
+    Disp2Dec(count);
+    Disp2String(" of ");
+    Disp2Dec(MULTITIMER_MAX);
+    Disp2String(" timers in use");
+    xFastMutexGive(uart_sem);
+}
+
+static void MultiTimerCommand(const MultiTimerCmd_t *cmd, uint32_t now)
+{
+    MultiTimer_t *timer;
+    uint8_t i;
+
+    if (cmd->op == MULTITIMER_CMD_LIST)
+    {
+        MultiTimerList(now);
+        return;
+    }
+
+    timer = MultiTimerFind(cmd->name);
+
+    switch (cmd->op)
+    {
+        case MULTITIMER_CMD_NEW:
+            if (timer != NULL)
+            {
+                MultiTimerMessage(cmd->name, " already exists");
+                return;
+            }
+            for (i = 0; i < MULTITIMER_MAX && timers[i].state != MULTITIMER_FREE; i++)
+            {
+            }
+            if (i == MULTITIMER_MAX)
+            {
+                MultiTimerMessage(cmd->name, " not started, every timer is in use");
+                return;
+            }
+            timer = &timers[i];
+            strcpy(timer->name, cmd->name);
+            timer->state = MULTITIMER_RUNNING;
+            WheelInsert(&wheel, &timer->link, now + cmd->ticks);
+            MultiTimerMessage(timer->name, " started");
+            break;
+
+        case MULTITIMER_CMD_PAUSE:
+            if (timer == NULL || timer->state != MULTITIMER_RUNNING)
+            {
+                MultiTimerMessage(cmd->name, " is not running");
+                return;
+            }
+            WheelRemove(&wheel, &timer->link);
+            timer->remaining = ((int32_t)(timer->link.deadline - now) > 0) ? timer->link.deadline - now : 0;
+            timer->state = MULTITIMER_PAUSED;
+            MultiTimerMessage(timer->name, " paused");
+            break;
+
+        case MULTITIMER_CMD_RESUME:
+            if (timer == NULL || timer->state != MULTITIMER_PAUSED)
+            {
+                MultiTimerMessage(cmd->name, " is not paused");
+                return;
+            }
+            timer->state = MULTITIMER_RUNNING;
+            WheelInsert(&wheel, &timer->link, now + timer->remaining);
+            MultiTimerMessage(timer->name, " resumed");
+            break;
+
+        case MULTITIMER_CMD_ABORT:
+            if (timer == NULL)
+            {
+                MultiTimerMessage(cmd->name, " does not exist");
+                return;
+            }
+            if (timer->state == MULTITIMER_RUNNING)
+            {
+                WheelRemove(&wheel, &timer->link);
+            }
+            timer->state = MULTITIMER_FREE;
+            MultiTimerMessage(timer->name, " aborted");
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void vMultiTimerTask(void *pvParameters)
+{
+    MultiTimerCmd_t cmd;
+    WheelTimer_t *expired;
+    uint32_t now;
+    uint32_t deadline;
+    TickType_t wait;
+
+    (void) pvParameters;
+
+    multiTimerLastTick = xTaskGetTickCount();
+    WheelInit(&wheel, MultiTimerNow());
+
+    for (;;)
+    {
+        now = MultiTimerNow();
+
+        while ((expired = WheelExpire(&wheel, now)) != NULL)
+        {
+            MultiTimer_t *timer = (MultiTimer_t *) expired;
+
+            timer->state = MULTITIMER_FREE;
+            MultiTimerMessage(timer->name, " done");
+        }
+
+        // One wake up for the earliest deadline, or none at all with no
+        // timer running. A command wakes the task early
+        wait = portMAX_DELAY;
+        if (WheelNextDeadline(&wheel, &deadline))
+        {
+            now = MultiTimerNow();
+            wait = ((int32_t)(deadline - now) > 0) ? (TickType_t)(deadline - now) : 0;
+        }
+
+        if (xQueueReceive(commandQueue, &cmd, wait) == pdPASS)
+        {
+            MultiTimerCommand(&cmd, MultiTimerNow());
+        }
+    }
+}
+
+// Copies the next space separated word of *line into word and moves *line
+// past it, returns the word's length before any cut
+static uint8_t MultiTimerWord(const char **line, char *word, uint8_t size)
+{
+    const char *p = *line;
+    uint8_t length = 0;
+
+    while (*p == ' ')
+    {
+        p++;
+    }
+    while (*p != ' ' && *p != '\0')
+    {
+        if (length < size - 1)
+        {
+            word[length] = *p;
+        }
+        length++;
+        p++;
+    }
+    word[length < size - 1 ? length : size - 1] = '\0';
+
+    *line = p;
+    return length;
+}
+
+// mm:ss or plain seconds, 0 if neither
+static uint16_t MultiTimerSeconds(const char *text)
+{
+    uint16_t value = 0;
+    uint16_t minutes = 0;
+    uint8_t colon = 0;
+
+    for (; *text != '\0'; text++)
+    {
+        if (*text == ':' && !colon)
+        {
+            minutes = value;
+            value = 0;
+            colon = 1;
+        }
+        else if (*text >= '0' && *text <= '9' && value <= MULTITIMER_MAX_SECONDS)
+        {
+            value = value * 10 + (*text - '0');
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    if (colon)
+    {
+        if (value > 59 || minutes > MULTITIMER_MAX_SECONDS / 60)
+        {
+            return 0;
+        }
+        value += minutes * 60;
+    }
+
+    return (value <= MULTITIMER_MAX_SECONDS) ? value : 0;
+}
+
+void MultiTimerLine(const char *line)
+{
+    MultiTimerCmd_t cmd;
+    char word[8];
+    char time[8];
+    uint16_t seconds = 0;
+
+    MultiTimerWord(&line, word, sizeof(word));
+    MultiTimerWord(&line, cmd.name, sizeof(cmd.name));
+    cmd.ticks = 0;
+
+    if (strcmp(word, "list") == 0)
+    {
+        cmd.op = MULTITIMER_CMD_LIST;
+    }
+    else if (cmd.name[0] == '\0')
+    {
+        cmd.op = MULTITIMER_CMD_NONE;
+    }
+    else if (strcmp(word, "new") == 0)
+    {
+        cmd.op = MULTITIMER_CMD_NEW;
+        MultiTimerWord(&line, time, sizeof(time));
+        seconds = MultiTimerSeconds(time);
+        cmd.ticks = (uint32_t) seconds * configTICK_RATE_HZ;
+        if (seconds == 0)
+        {
+            cmd.op = MULTITIMER_CMD_NONE;
+        }
+    }
+    else if (strcmp(word, "pause") == 0)
+    {
+        cmd.op = MULTITIMER_CMD_PAUSE;
+    }
+    else if (strcmp(word, "resume") == 0)
+    {
+        cmd.op = MULTITIMER_CMD_RESUME;
+    }
+    else if (strcmp(word, "abort") == 0)
+    {
+        cmd.op = MULTITIMER_CMD_ABORT;
+    }
+    else
+    {
+        cmd.op = MULTITIMER_CMD_NONE;
+    }
+
+    if (cmd.op == MULTITIMER_CMD_NONE)
+    {
+        xFastMutexTake(uart_sem, portMAX_DELAY);
+        Disp2String("\n\r[TIMER] !new <name> <mm:ss>, !pause|!resume|!abort <name>, !list");
+        xFastMutexGive(uart_sem);
+        return;
+    }
+
+    if (xQueueSend(commandQueue, &cmd, 0) != pdPASS)
+    {
+        MultiTimerMessage(cmd.name, " not done, the timer task is busy");
+    }
+}
+
+void MultiTimerStart(void)
+{
+    commandQueue = xQueueCreateStatic(MULTITIMER_QUEUE_LEN, sizeof(MultiTimerCmd_t), commandQueueStorage, &commandQueueBuffer);
+#if TRACE_ENABLE
+    TraceNameQueue(commandQueue, "timers");
+#endif
+    xTaskCreateStatic(vMultiTimerTask, "MultiTimer", STACK_SIZE_MULTITIMER, NULL, MULTITIMER_PRIORITY, multiTimerTaskStack, &multiTimerTaskTCB);
+}
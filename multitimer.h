@@ -0,0 +1,33 @@
+/*
+ * File:   multitimer.h
+ *
+ * Named countdown timers, up to MULTITIMER_MAX running at once alongside the
+ * FSM countdown. A single task owns every timer on a timing wheel (wheel.h)
+ * and sleeps until the earliest deadline, so starting or stopping a timer
+ * is O(1) and a running timer costs nothing until it is due.
+ *
+ * Timers are driven from the console with lines that start with '!':
+ *   !new <name> <mm:ss or seconds>
+ *   !pause <name>
+ *   !resume <name>
+ *   !abort <name>
+ *   !list
+ */
+
+#ifndef MULTITIMER_H
+#define MULTITIMER_H
+
+#include <stdint.h>
+
+#define MULTITIMER_MAX          32
+// Longer names are cut short
+#define MULTITIMER_NAME_LEN     8
+
+// Parses a console line, without its '!', and hands it to the timer task.
+// Called from the console task
+void MultiTimerLine(const char *line);
+
+// Creates the timer task, call before vTaskStartScheduler()
+void MultiTimerStart(void);
+
+#endif
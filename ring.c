@@ -0,0 +1,130 @@
+/*
+ * File:   ring.c
+ *
+ * Single producer, single consumer byte rings, see ring.h. The only ordering
+ * needed is that the bytes are in storage before head moves past them, and
+ * read out before tail does. The PIC24 is a single in-order core, so keeping
+ * the compiler from moving the storage accesses across the index update is
+ * all it takes.
+ */
+
+#include <string.h>
+
+#include "ring.h"
+
+// Stops the compiler moving memory accesses across it, no code
+#define RING_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+void RingInit(Ring_t *ring, uint8_t *storage, uint16_t size)
+{
+    ring->storage = storage;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+uint8_t RingPut(Ring_t *ring, uint8_t byte)
+{
+    uint16_t head = ring->head;
+
+    if ((uint16_t) (head - ring->tail) > ring->mask)
+    {
+        return 0;
+    }
+
+    ring->storage[head & ring->mask] = byte;
+    RING_BARRIER();
+    ring->head = head + 1;
+
+    return 1;
+}
+
+uint16_t RingWrite(Ring_t *ring, const uint8_t *data, uint16_t count)
+{
+    uint16_t head = ring->head;
+    uint16_t space = (uint16_t) (ring->mask + 1) - (uint16_t) (head - ring->tail);
+    uint16_t index = head & ring->mask;
+    uint16_t first;
+
+    if (count > space)
+    {
+        count = space;
+    }
+
+    // Up to the end of storage, then the rest from the start
+    first = (uint16_t) (ring->mask + 1) - index;
+    if (first > count)
+    {
+        first = count;
+    }
+    memcpy(&ring->storage[index], data, first);
+    memcpy(ring->storage, data + first, count - first);
+
+    RING_BARRIER();
+    ring->head = head + count;
+
+    return count;
+}
+
+uint8_t RingGet(Ring_t *ring, uint8_t *byte)
+{
+    uint16_t tail = ring->tail;
+
+    if (ring->head == tail)
+    {
+        return 0;
+    }
+
+    RING_BARRIER();
+    *byte = ring->storage[tail & ring->mask];
+    RING_BARRIER();
+    ring->tail = tail + 1;
+
+    return 1;
+}
+
+uint16_t RingRead(Ring_t *ring, uint8_t *data, uint16_t count)
+{
+    uint16_t tail = ring->tail;
+    uint16_t waiting = ring->head - tail;
+    uint16_t index = tail & ring->mask;
+    uint16_t first;
+
+    if (count > waiting)
+    {
+        count = waiting;
+    }
+
+    // Only read bytes once head is seen past them
+    RING_BARRIER();
+
+    first = (uint16_t) (ring->mask + 1) - index;
+    if (first > count)
+    {
+        first = count;
+    }
+    memcpy(data, &ring->storage[index], first);
+    memcpy(data + first, ring->storage, count - first);
+
+    RING_BARRIER();
+    ring->tail = tail + count;
+
+    return count;
+}
+
+void RingFlush(Ring_t *ring)
+{
+    ring->tail = ring->head;
+}
+
+uint16_t RingCount(const Ring_t *ring)
+{
+    uint16_t tail = ring->tail;
+
+    return ring->head - tail;
+}
+
+uint16_t RingSpace(const Ring_t *ring)
+{
+    return (uint16_t) (ring->mask + 1) - RingCount(ring);
+}
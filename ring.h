@@ -0,0 +1,64 @@
+/*
+ * File:   ring.h
+ *
+ * Single producer, single consumer byte rings for passing data from an
+ * interrupt to a task without a critical section. The producer only ever
+ * writes head and the consumer only ever writes tail, each a 16-bit word
+ * that the PIC24 loads and stores in one instruction, so neither side has to
+ * mask interrupts or lock out the other. There must be only one producer and
+ * one consumer at a time.
+ *
+ * The size is a power of two and the indices run freely, wrapping at 65536,
+ * so the byte count is head - tail and every byte of storage is used.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+
+// Largest ring, so that a full ring's count still fits in 16 bits
+#define RING_SIZE_MAX 32768U
+
+typedef struct
+{
+    uint8_t *storage;
+    // Size in bytes less one, the size is a power of two
+    uint16_t mask;
+
+    // Bytes written and read since the ring was set up, modulo 65536
+    volatile uint16_t head;
+    volatile uint16_t tail;
+} Ring_t;
+
+// Defines a ring and its storage at compile time, e.g.
+//   RING_DEFINE(rxRing, 16);
+// makes a Ring_t named rxRing that holds 16 bytes, ready to use. A size that
+// is not a power of two up to RING_SIZE_MAX fails to compile
+#define RING_DEFINE(ring, size)                                                 \
+    typedef char ring##SizeCheck[((size) != 0 && ((size) & ((size) - 1)) == 0  \
+                                  && (size) <= RING_SIZE_MAX) ? 1 : -1];        \
+    static uint8_t ring##Storage[(size)];                                       \
+    Ring_t ring = { ring##Storage, (size) - 1, 0, 0 }
+
+// Sets up a ring over storage of size bytes, a power of two. Only while
+// neither side is using it
+void RingInit(Ring_t *ring, uint8_t *storage, uint16_t size);
+
+// Producer side. RingPut() returns 0 if the ring is full, RingWrite() the
+// number of bytes that fit
+uint8_t RingPut(Ring_t *ring, uint8_t byte);
+uint16_t RingWrite(Ring_t *ring, const uint8_t *data, uint16_t count);
+
+// Consumer side. RingGet() returns 0 if the ring is empty, RingRead() the
+// number of bytes read. RingFlush() drops every byte waiting
+uint8_t RingGet(Ring_t *ring, uint8_t *byte);
+uint16_t RingRead(Ring_t *ring, uint8_t *data, uint16_t count);
+void RingFlush(Ring_t *ring);
+
+// Bytes waiting and room left. Either side may ask, the answer is only
+// exact for the side that calls it
+uint16_t RingCount(const Ring_t *ring);
+uint16_t RingSpace(const Ring_t *ring);
+
+#endif
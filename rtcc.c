@@ -0,0 +1,131 @@
+/*
+ * File:   rtcc.c
+ *
+ * RTCC set up and the seconds alarm, see rtcc.h. The prescaler turns the
+ * RTCC clock into the half second the time registers count from, so the
+ * calendar itself is only set to a valid date and never read.
+ */
+
+#include <xc.h>
+#include "rtcc.h"
+#include "trace.h"
+
+#if RTCC_CLOCK_SOSC
+#define RTCC_CLOCK_HZ   32768UL
+#define RTCC_CLKSEL     0b00
+#else
+#define RTCC_CLOCK_HZ   31000UL
+#define RTCC_CLKSEL     0b01
+#endif
+
+// The divider gives one count each half second
+#define RTCC_DIV        (RTCC_CLOCK_HZ / 2 - 1)
+
+// Alarm mask, match on every second
+#define RTCC_AMASK_EVERY_SECOND 0b0001
+
+static TaskHandle_t alarmTask = NULL;
+static uint32_t alarmBits = 0;
+static volatile uint32_t alarmSeconds = 0;
+
+// Clears WRLOCK. The NVMKEY writes and the clear have to be back to back,
+// so interrupts are held off over them
+static void RtccUnlock(void)
+{
+    __asm__ volatile("disi  #6\n"
+                     "mov   #NVMKEY, w1\n"
+                     "mov   #0x55, w2\n"
+                     "mov   w2, [w1]\n"
+                     "mov   #0xAA, w3\n"
+                     "mov   w3, [w1]\n"
+                     "bclr  RTCCON1L, #11\n"
+                     : : : "w1", "w2", "w3");
+}
+
+static void RtccLock(void)
+{
+    RTCCON1Lbits.WRLOCK = 1;
+}
+
+void RtccInit(void)
+{
+    RtccUnlock();
+
+    RTCCON1Lbits.RTCEN = 0;
+    RTCCON1H = 0;
+
+    RTCCON2Lbits.CLKSEL = RTCC_CLKSEL;
+    RTCCON2Lbits.PS = 0;
+    RTCCON2H = RTCC_DIV;
+
+    // 00:00:00 on Wednesday 2025-01-01, in BCD
+    TIMEH = 0x0000;
+    TIMEL = 0x0000;
+    DATEH = 0x2501;
+    DATEL = 0x0103;
+
+    RTCCON1Lbits.RTCEN = 1;
+
+    RtccLock();
+
+    IFS3bits.RTCIF = 0;
+    IPC15bits.RTCIP = RTCC_INTERRUPT_PRIORITY;
+    IEC3bits.RTCIE = 1;
+}
+
+void RtccAlarmStart(TaskHandle_t task, uint32_t bits)
+{
+    alarmTask = task;
+    alarmBits = bits;
+
+    // The alarm fields can only change with the alarm off. Chime keeps the
+    // alarm repeating once the repeat count runs out
+    RTCCON1Hbits.ALRMEN = 0;
+    RTCCON1Hbits.AMASK = RTCC_AMASK_EVERY_SECOND;
+    RTCCON1Hbits.ALMRPT = 0xFF;
+    RTCCON1Hbits.CHIME = 1;
+    RTCCON1Hbits.ALRMEN = 1;
+}
+
+void RtccAlarmStop(void)
+{
+    RTCCON1Hbits.ALRMEN = 0;
+    alarmTask = NULL;
+}
+
+uint32_t RtccSeconds(void)
+{
+    uint32_t seconds;
+    UBaseType_t savedIPL;
+
+    // Two words, read as one against the alarm interrupt
+    savedIPL = portSET_INTERRUPT_MASK_FROM_ISR();
+    seconds = alarmSeconds;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(savedIPL);
+
+    return seconds;
+}
+
+// Runs on the port's interrupt stack
+void RTCCInterruptHandler(void);
+portDEFINE_ISR(_RTCCInterrupt, RTCCInterruptHandler);
+
+void RTCCInterruptHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    TRACE_ISR_ENTER(TRACE_ISR_RTCC);
+
+    IFS3bits.RTCIF = 0;
+
+    alarmSeconds++;
+
+    if (alarmTask != NULL)
+    {
+        xTaskNotifyFromISR(alarmTask, alarmBits, eSetBits, &woken);
+    }
+
+    TRACE_ISR_EXIT(TRACE_ISR_RTCC);
+
+    portYIELD_FROM_ISR(woken);
+}
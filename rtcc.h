@@ -0,0 +1,44 @@
+/*
+ * File:   rtcc.h
+ *
+ * Real time clock/calendar driver. The RTCC counts seconds on its own clock,
+ * independent of the kernel tick, and its alarm is set to go off once every
+ * second. Each alarm interrupt counts one second and notifies the task that
+ * started the alarm, so a task can sleep until the next whole second without
+ * any tick based delay.
+ */
+
+#ifndef RTCC_H
+#define RTCC_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// 1 clocks the RTCC from the 32.768 kHz crystal on SOSC. The SOSC pins are
+// RA4 (PB1) and RB4 on this board and SOSCSEL is set to digital mode in
+// main.c, so the crystal needs a board change, PB1 moved off RA4 and
+// SOSCSEL = ON. 0 uses the internal LPRC, which needs no hardware but is
+// only good to a few percent
+#ifndef RTCC_CLOCK_SOSC
+#define RTCC_CLOCK_SOSC 0
+#endif
+
+// The alarm calls FreeRTOS from the interrupt, so at or below
+// configMAX_SYSCALL_INTERRUPT_PRIORITY. Nothing is late if a second is
+// noticed a little after the others
+#define RTCC_INTERRUPT_PRIORITY 2
+
+// Starts the clock at 00:00:00 with the alarm off, call once at start up
+void RtccInit(void);
+
+// Alarm every second, each one sets bits in the notification value of task.
+// A second that comes before the task has taken the last one is still
+// counted by RtccSeconds()
+void RtccAlarmStart(TaskHandle_t task, uint32_t bits);
+void RtccAlarmStop(void);
+
+// Alarms since RtccInit()
+uint32_t RtccSeconds(void);
+
+#endif
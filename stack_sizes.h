@@ -0,0 +1,41 @@
+/*
+ * File:   stack_sizes.h
+ *
+ * Stack size in words of every task, idle included. The console 'k' command
+ * prints the worst case use of each task and these lines with a margin
+ * added, so after running through every FSM state (and the benchmarks) the
+ * printed block can be pasted over the one below.
+ *
+ * PROVISIONAL: none of the values below has been measured yet. They are
+ * estimates until a 'k' run on the board replaces them, and any RAM
+ * figure worked out from them is only as good as the estimate.
+ *
+ * Included by FreeRTOSConfig.h, so defines only.
+ */
+
+#ifndef STACK_SIZES_H
+#define STACK_SIZES_H
+
+// FSM tasks, from main.c. Interrupts run on their own stack, so these only
+// have to cover the tasks themselves. Estimates, not yet measured
+#define STACK_SIZE_WAITTASK         150
+#define STACK_SIZE_TIMEENTRYTASK    150
+#define STACK_SIZE_COUNTDOWNTASK    150
+#define STACK_SIZE_DONETASK         150
+
+// Console and benchmark tasks
+#define STACK_SIZE_CONSOLE          200
+#define STACK_SIZE_BENCH            200
+// The partner only yields, records and reads the benchmark queue, it never
+// prints
+#define STACK_SIZE_BENCHPEER        100
+
+// Named timers, see multitimer.h
+#define STACK_SIZE_MULTITIMER       200
+
+// The idle task, used as configMINIMAL_STACK_SIZE
+#define STACK_SIZE_IDLE             100
+// The idle task when it also runs the FSM co-routines, configUSE_CO_ROUTINES
+#define STACK_SIZE_IDLE_COROUTINES  200
+
+#endif
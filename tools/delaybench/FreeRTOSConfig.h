@@ -0,0 +1,58 @@
+/*
+ * File:   FreeRTOSConfig.h
+ *
+ * Kernel configuration for the delaybench.c host build, which
+ * tools/ringbench/ringbench.c and tools/timerbench/timerbench.c share. Only
+ * what the delayed list touches matches the PIC24 build (16-bit ticks,
+ * preemption, time slicing), everything else is left at its smallest.
+ * configUSE_DELAYED_TASK_WHEEL and the other optional calls are given on the
+ * compiler command line.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define configUSE_PREEMPTION                        1
+#define configUSE_TIME_SLICING                      1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION     0
+#define configUSE_IDLE_HOOK                         0
+#define configUSE_TICK_HOOK                         0
+#define configTICK_RATE_HZ                          ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                        ( 4 )
+#define configMINIMAL_STACK_SIZE                    ( 64 )
+#define configMAX_TASK_NAME_LEN                     ( 8 )
+#define configUSE_16_BIT_TICKS                      1
+#define configUSE_TRACE_FACILITY                    1
+#define configUSE_MUTEXES                           0
+#ifndef configUSE_TIMERS
+#define configUSE_TIMERS                            0
+#endif
+#define configTIMER_TASK_PRIORITY                   3
+#define configTIMER_QUEUE_LENGTH                    64
+#define configTIMER_TASK_STACK_DEPTH                64
+#define configUSE_CO_ROUTINES                       0
+#define configUSE_TICKLESS_IDLE                     1
+#define configSUPPORT_STATIC_ALLOCATION             1
+#define configSUPPORT_DYNAMIC_ALLOCATION            0
+
+#define INCLUDE_vTaskDelay                          1
+#define INCLUDE_xTaskGetIdleTaskHandle              1
+#define INCLUDE_xTaskGetCurrentTaskHandle           1
+#define INCLUDE_xTaskGetSchedulerState              1
+
+// The benchmark only plays the tasks, there is no idle task to sleep in
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )
+
+#define configASSERT( x )                                                   \
+    do {                                                                    \
+        if( !( x ) )                                                        \
+        {                                                                   \
+            fprintf( stderr, "assert failed %s:%d\n", __FILE__, __LINE__ ); \
+            abort();                                                        \
+        }                                                                   \
+    } while( 0 )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,356 @@
+/*
+ * File:   delaybench.c
+ *
+ * Host benchmark of the kernel's delayed task list, the sorted list against
+ * the timing wheel (configUSE_DELAYED_TASK_WHEEL). It builds the real tasks.c
+ * and list.c against a host port (portmacro.h here) with no context switch:
+ * the benchmark plays whichever task is current, so each ready task calls
+ * vTaskDelay() with its own period and the next one runs, until only idle is
+ * left and the next tick is given.
+ *
+ * Build and run on Linux, once per delayed list:
+ *   gcc -O2 -I tools/delaybench -I FreeRTOS/include -o delaybench-list \
+ *       tools/delaybench/delaybench.c FreeRTOS/tasks.c FreeRTOS/list.c
+ *   gcc -O2 -DconfigUSE_DELAYED_TASK_WHEEL=1 -I tools/delaybench -I FreeRTOS/include \
+ *       -o delaybench-wheel tools/delaybench/delaybench.c FreeRTOS/tasks.c FreeRTOS/list.c
+ *   ./delaybench-list
+ *   ./delaybench-wheel
+ *
+ * Each run has 4, 32 and 256 tasks with periods of 1 to 100 ticks, over
+ * enough ticks for the 16-bit tick count to wrap. It prints the time taken by
+ * vTaskDelay() and by the tick (mean, 99th percentile and worst case), and
+ * checks that every task wakes on the tick it asked for. With -s, the time
+ * with every task delayed is skipped with vTaskStepTick() as tickless idle
+ * does, to check that path too. Times are not printed then.
+ *
+ * With -k <ticks>, built with -DconfigUSE_TASK_DELAY_SLACK=1, each task calls
+ * vTaskDelayWithSlack() with that slack instead, and must wake within it. The
+ * run prints the ticks that woke a task, from ulTaskGetWakeTicks(), to
+ * compare against a run with -k 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_TASKS_MAX     256
+#define BENCH_PERIOD_MAX    100
+#define BENCH_TICKS         100000UL
+#define BENCH_STACK         64
+
+static StaticTask_t benchTCB[BENCH_TASKS_MAX];
+static StackType_t  benchStack[BENCH_TASKS_MAX][BENCH_STACK];
+static StaticTask_t idleTCB;
+static StackType_t  idleStack[configMINIMAL_STACK_SIZE];
+
+static TickType_t   benchPeriod[BENCH_TASKS_MAX];
+// tick each task should next run on, once it has run once
+static TickType_t   benchWake[BENCH_TASKS_MAX];
+static uint8_t      benchStarted[BENCH_TASKS_MAX];
+static unsigned     benchTasks;
+static int          benchStep;
+static TickType_t   benchSlack;
+
+static unsigned long benchWakes;
+static unsigned long benchLate;
+static unsigned long benchSteps;
+
+// Nanoseconds per call, kept whole to sort for the percentile
+typedef struct
+{
+    uint32_t *ns;
+    size_t count;
+    size_t size;
+} BenchSamples_t;
+
+static BenchSamples_t delaySamples;
+static BenchSamples_t tickSamples;
+
+static uint64_t BenchNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void BenchRecord(BenchSamples_t *samples, uint64_t ns)
+{
+    if (samples->count == samples->size)
+    {
+        samples->size = samples->size ? samples->size * 2 : 4096;
+        samples->ns = realloc(samples->ns, samples->size * sizeof(samples->ns[0]));
+        if (samples->ns == NULL)
+        {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    samples->ns[samples->count++] = (uint32_t)ns;
+}
+
+static int BenchCompare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void BenchPrint(const char *name, BenchSamples_t *samples)
+{
+    uint64_t sum = 0;
+    size_t i;
+
+    if (samples->count == 0)
+    {
+        printf("  %s      -", name);
+        return;
+    }
+
+    qsort(samples->ns, samples->count, sizeof(samples->ns[0]), BenchCompare);
+    for (i = 0; i < samples->count; i++)
+    {
+        sum += samples->ns[i];
+    }
+
+    printf("  %s %6.0f %6u %7u", name, (double)sum / samples->count,
+           samples->ns[samples->count * 99 / 100], samples->ns[samples->count - 1]);
+}
+
+// Host port, see portmacro.h. A yield only picks the task the benchmark
+// plays next
+void vPortYield(void)
+{
+    vTaskSwitchContext();
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void)pxCode;
+    (void)pvParameters;
+
+    return pxTopOfStack;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &idleTCB;
+    *ppxIdleTaskStackBuffer = idleStack;
+    *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+// Never called, the benchmark plays every task
+static void BenchTask(void *pvParameters)
+{
+    (void)pvParameters;
+}
+
+// Every ready task checks it woke on time and delays for its period again,
+// until only idle is left
+static void BenchRunTasks(void)
+{
+    TaskHandle_t task;
+    UBaseType_t i;
+    TickType_t now;
+    uint64_t start;
+
+    while ((task = xTaskGetCurrentTaskHandle()) != xTaskGetIdleTaskHandle())
+    {
+        i = uxTaskGetTaskNumber(task);
+        now = xTaskGetTickCount();
+
+        if (benchStarted[i])
+        {
+            benchWakes++;
+            if ((TickType_t)(now - benchWake[i]) > benchSlack)
+            {
+                benchLate++;
+            }
+        }
+        benchStarted[i] = 1;
+        benchWake[i] = (TickType_t)(now + benchPeriod[i]);
+
+        start = BenchNowNs();
+#if (configUSE_TASK_DELAY_SLACK == 1)
+        vTaskDelayWithSlack(benchPeriod[i], benchSlack);
+#else
+        vTaskDelay(benchPeriod[i]);
+#endif
+        BenchRecord(&delaySamples, BenchNowNs() - start);
+    }
+}
+
+// Skips part or all of the time until the next task wakes, as the tickless
+// idle of the port does. Never past the tick wrap, the kernel does not sleep
+// beyond it either. Returns the ticks skipped
+static TickType_t BenchSkipIdle(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t soonest = (TickType_t)(portMAX_DELAY - now);
+    TickType_t jump;
+    unsigned i;
+
+    for (i = 0; i < benchTasks; i++)
+    {
+        // Inside its slack the task may wake on any tick
+        if ((TickType_t)(now - benchWake[i]) <= benchSlack)
+        {
+            return 0;
+        }
+        if ((TickType_t)(benchWake[i] - now) < soonest)
+        {
+            soonest = (TickType_t)(benchWake[i] - now);
+        }
+    }
+
+    if (soonest < 2)
+    {
+        return 0;
+    }
+
+    // Woken early by an interrupt as often as not
+    jump = (rand() & 1) ? soonest : (TickType_t)(1 + rand() % soonest);
+
+    vTaskSuspendAll();
+    vTaskStepTick(jump);
+    (void)xTaskResumeAll();
+    benchSteps++;
+
+    return jump;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    unsigned long ticks = 0;
+    uint64_t start;
+
+    for (;;)
+    {
+        BenchRunTasks();
+        if (ticks >= BENCH_TICKS)
+        {
+            break;
+        }
+
+        if (benchStep)
+        {
+            TickType_t jumped = BenchSkipIdle();
+            if (jumped > 0)
+            {
+                ticks += jumped;
+                continue;
+            }
+        }
+
+        start = BenchNowNs();
+        (void)xTaskIncrementTick();
+        BenchRecord(&tickSamples, BenchNowNs() - start);
+        ticks++;
+
+        // As the tick interrupt would, switch to a task it woke
+        vTaskSwitchContext();
+    }
+
+    printf("%5u", benchTasks);
+#if (configUSE_TASK_DELAY_SLACK == 1)
+    printf("  %6lu wake ticks", (unsigned long)ulTaskGetWakeTicks());
+#endif
+    if (benchStep)
+    {
+        printf("  %8lu wakes, %lu late, %lu skips", benchWakes, benchLate, benchSteps);
+    }
+    else
+    {
+        BenchPrint("|", &delaySamples);
+        BenchPrint("|", &tickSamples);
+        printf("  | %lu late", benchLate);
+    }
+    printf("\n");
+
+    exit(benchLate != 0 ? 1 : 0);
+}
+
+// Runs in its own process, the kernel cannot be started twice
+static void BenchRun(unsigned tasks)
+{
+    TaskHandle_t handle;
+    unsigned i;
+
+    benchTasks = tasks;
+    srand(tasks);
+
+    for (i = 0; i < tasks; i++)
+    {
+        benchPeriod[i] = (TickType_t)(1 + rand() % BENCH_PERIOD_MAX);
+        handle = xTaskCreateStatic(BenchTask, "Bench", BENCH_STACK, NULL, 1, benchStack[i], &benchTCB[i]);
+        vTaskSetTaskNumber(handle, i);
+    }
+
+    vTaskStartScheduler();
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    static const unsigned counts[] = { 4, 32, 256 };
+    unsigned i;
+    int status;
+    int failed = 0;
+    pid_t pid;
+
+    for (i = 1; i < (unsigned)argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0)
+        {
+            benchStep = 1;
+        }
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < (unsigned)argc)
+        {
+            benchSlack = (TickType_t)atoi(argv[++i]);
+        }
+    }
+
+    printf("%s, %lu ticks%s, %u ticks slack\n",
+           configUSE_DELAYED_TASK_WHEEL ? "Timing wheel" : "Sorted delayed list",
+           BENCH_TICKS, benchStep ? ", idle skipped with vTaskStepTick()" : "",
+           (unsigned)benchSlack);
+    if (!benchStep)
+    {
+        printf("tasks  | vTaskDelay() ns mean p99 max | tick ns mean p99 max\n");
+    }
+
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        fflush(stdout);
+        pid = fork();
+        if (pid < 0)
+        {
+            perror("fork");
+            return 2;
+        }
+        if (pid == 0)
+        {
+            BenchRun(counts[i]);
+        }
+
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            printf("%5u tasks failed\n", counts[i]);
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,57 @@
+/*
+ * File:   portmacro.h
+ *
+ * Host port for delaybench.c and tools/ringbench. There is no context switch,
+ * the benchmark plays the part of whichever task is current, so a yield just
+ * picks the next task and critical sections have nothing to mask.
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define portCHAR        char
+#define portFLOAT       float
+#define portDOUBLE      double
+#define portLONG        long
+#define portSHORT       short
+#define portSTACK_TYPE  uintptr_t
+#define portBASE_TYPE   long
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+// 16-bit ticks like the PIC24 build, so the wheel has the same levels
+#if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+    typedef uint16_t TickType_t;
+    #define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+    typedef uint32_t TickType_t;
+    #define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#endif
+#define portTICK_TYPE_IS_ATOMIC 1
+#define portPOINTER_SIZE_TYPE   uintptr_t
+
+#define portBYTE_ALIGNMENT          8
+#define portSTACK_GROWTH            ( -1 )
+#define portTICK_PERIOD_MS          ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portENTER_CRITICAL()
+#define portEXIT_CRITICAL()
+#define portSET_INTERRUPT_MASK_FROM_ISR()                   0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask )    ( void ) ( uxSavedMask )
+
+extern void vPortYield( void );
+#define portYIELD()                 vPortYield()
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+#define portNOP()
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,329 @@
+/*
+ * File:   eventcheck.c
+ *
+ * Host check of xEventGroupSetBitsFromISRDirect() against the task side of
+ * the event group, in particular the lock that makes an interrupt leave its
+ * bits for the task that has the group locked. It includes the real tasks.c
+ * and event_groups.c, built against the host port of tools/delaybench, and
+ * plays both the tasks and the interrupt. The interrupt comes from the main
+ * loop, with the scheduler running, and from trace hooks placed where a task
+ * has the group locked: while it sets bits, just after it puts itself on the
+ * waiting list, and between the tasks it unblocks.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -fno-strict-aliasing -DconfigEVENT_GROUP_ISR_MAX_WAITERS=4 \
+ *       -DINCLUDE_eTaskGetState=1 -I tools/delaybench -I FreeRTOS/include \
+ *       -I FreeRTOS -o eventcheck tools/eventcheck/eventcheck.c FreeRTOS/list.c
+ *   ./eventcheck [seed]
+ *
+ * -fno-strict-aliasing is needed with tasks.c in the same file, as for
+ * tools/queuecheck.
+ *
+ * CHECK_TASKS tasks wait on random bits, any or all of them, while tasks and
+ * the interrupt set and clear random bits. After every step the group must
+ * hold exactly the bits set and not cleared since, no task may still wait
+ * for bits that are all there, and nothing may be left locked. A task that
+ * wakes must find its bits in its event list item. The interrupt must only
+ * be refused with more than configEVENT_GROUP_ISR_MAX_WAITERS tasks waiting.
+ * The waits never clear on exit, so the bits stay easy to follow.
+ */
+
+#include <setjmp.h>
+
+// The interrupt can come at each of these, all with the group locked
+static void CheckInterrupt(int fromHook);
+
+#define traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet )                           CheckInterrupt( 1 )
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor )                CheckInterrupt( 1 )
+#define traceENTER_vTaskRemoveFromUnorderedEventList( pxEventListItem, xItemValue )     CheckInterrupt( 1 )
+
+#include "tasks.c"
+#include "event_groups.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS == 0 )
+#error Build with -DconfigEVENT_GROUP_ISR_MAX_WAITERS=<n>, see the top of the file
+#endif
+
+#define CHECK_TASKS     8
+#define CHECK_STEPS     2000000UL
+#define CHECK_STACK     64
+// Usable bits of a 16-bit EventBits_t
+#define CHECK_BITS      8
+
+static StaticTask_t checkTCB[CHECK_TASKS + 1];
+static StackType_t  checkStack[CHECK_TASKS + 1][CHECK_STACK];
+static TaskHandle_t checkTasks[CHECK_TASKS + 1];
+static StaticTask_t idleTCB;
+static StackType_t  idleStack[configMINIMAL_STACK_SIZE];
+
+static StaticEventGroup_t checkGroupBuffer;
+static EventGroupHandle_t checkGroup;
+
+// What each task waits for, indexed by task number, 0 being idle
+static EventBits_t checkWaitBits[CHECK_TASKS + 1];
+static BaseType_t  checkWaitAll[CHECK_TASKS + 1];
+static uint8_t     checkWaiting[CHECK_TASKS + 1];
+
+// Bits the group should hold
+static EventBits_t checkBits;
+
+// A task blocking in xEventGroupWaitBits() comes back here from its yield,
+// the rest of the call is played by CheckWoken() once it runs again
+static jmp_buf checkBlocked;
+static int checkInWait;
+static int checkInInterrupt;
+
+static unsigned long checkSetDirect;
+static unsigned long checkSetLocked;
+static unsigned long checkRefused;
+static unsigned long checkWakes;
+static unsigned long checkStep;
+
+static void CheckFail(const char *what)
+{
+    printf("step %lu: %s\n", checkStep, what);
+    exit(1);
+}
+
+// Host port, see tools/delaybench/portmacro.h
+void vPortYield(void)
+{
+    vTaskSwitchContext();
+
+    if (checkInWait)
+    {
+        checkInWait = 0;
+        longjmp(checkBlocked, 1);
+    }
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void)pxCode;
+    (void)pvParameters;
+
+    return pxTopOfStack;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &idleTCB;
+    *ppxIdleTaskStackBuffer = idleStack;
+    *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+// Never called, the check plays every task
+static void CheckTask(void *pvParameters)
+{
+    (void)pvParameters;
+}
+
+static EventBits_t CheckRandomBits(void)
+{
+    EventBits_t bits = 0;
+    int count = 1 + rand() % 3;
+
+    while (count-- > 0)
+    {
+        bits |= (EventBits_t)(1U << (rand() % CHECK_BITS));
+    }
+
+    return bits;
+}
+
+static int CheckMet(EventBits_t bits, EventBits_t waitBits, BaseType_t waitAll)
+{
+    return waitAll ? (bits & waitBits) == waitBits : (bits & waitBits) != 0;
+}
+
+static void CheckInterrupt(int fromHook)
+{
+    EventGroup_t *group = checkGroup;
+    BaseType_t woken = pdFALSE;
+    EventBits_t bits;
+    uint8_t locked;
+
+    // Interrupts don't nest here, and come at a hook only some of the time
+    if (checkInInterrupt || (fromHook && (rand() & 1)))
+    {
+        return;
+    }
+    checkInInterrupt = 1;
+
+    bits = CheckRandomBits();
+    locked = group->ucLocked;
+
+    if (xEventGroupSetBitsFromISRDirect(checkGroup, bits, &woken) == pdPASS)
+    {
+        checkBits |= bits;
+        if (locked)
+        {
+            checkSetLocked++;
+        }
+        else
+        {
+            checkSetDirect++;
+        }
+    }
+    else
+    {
+        if (locked || listCURRENT_LIST_LENGTH(&group->xTasksWaitingForBits) <= configEVENT_GROUP_ISR_MAX_WAITERS)
+        {
+            CheckFail("interrupt refused with few tasks waiting");
+        }
+        checkRefused++;
+    }
+
+    // With the scheduler suspended the switch waits for xTaskResumeAll()
+    if (woken && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+    {
+        vTaskSwitchContext();
+    }
+
+    checkInInterrupt = 0;
+}
+
+// The end of xEventGroupWaitBits() for a task that blocked and now runs
+static void CheckWoken(unsigned i)
+{
+    EventBits_t value = uxTaskResetEventItemValue();
+
+    if ((value & eventUNBLOCKED_DUE_TO_BIT_SET) == 0)
+    {
+        CheckFail("task running again without being unblocked by its bits");
+    }
+    if (!CheckMet(value & ~eventEVENT_BITS_CONTROL_BYTES, checkWaitBits[i], checkWaitAll[i]))
+    {
+        CheckFail("task unblocked without the bits it waits for");
+    }
+
+    checkWaiting[i] = 0;
+    checkWakes++;
+}
+
+static void CheckWait(unsigned i)
+{
+    EventBits_t value;
+
+    checkWaitBits[i] = CheckRandomBits();
+    checkWaitAll[i] = rand() & 1;
+    checkWaiting[i] = 1;
+
+    checkInWait = 1;
+    if (setjmp(checkBlocked) == 0)
+    {
+        value = xEventGroupWaitBits(checkGroup, checkWaitBits[i], pdFALSE, checkWaitAll[i], portMAX_DELAY);
+
+        // Returned at once, so the bits were there already
+        checkInWait = 0;
+        checkWaiting[i] = 0;
+        if (!CheckMet(value, checkWaitBits[i], checkWaitAll[i]))
+        {
+            CheckFail("wait returned without its bits");
+        }
+    }
+}
+
+static void CheckInvariants(void)
+{
+    const EventGroup_t *group = checkGroup;
+    unsigned i;
+
+    if (group->ucLocked != 0 || group->uxBitsSetWhileLocked != 0)
+    {
+        CheckFail("group left locked");
+    }
+    if (xEventGroupGetBits(checkGroup) != checkBits)
+    {
+        CheckFail("group bits differ from the bits set");
+    }
+
+    for (i = 1; i <= CHECK_TASKS; i++)
+    {
+        if (checkWaiting[i] && eTaskGetState(checkTasks[i]) == eBlocked &&
+            CheckMet(checkBits, checkWaitBits[i], checkWaitAll[i]))
+        {
+            CheckFail("task still waiting for bits that are set");
+        }
+    }
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    TaskHandle_t task;
+    EventBits_t bits;
+    unsigned i;
+
+    for (checkStep = 0; checkStep < CHECK_STEPS; checkStep++)
+    {
+        task = xTaskGetCurrentTaskHandle();
+        i = (task == xTaskGetIdleTaskHandle()) ? 0 : (unsigned)uxTaskGetTaskNumber(task);
+
+        if (i != 0 && checkWaiting[i])
+        {
+            CheckWoken(i);
+        }
+        else
+        {
+            switch (rand() % 4)
+            {
+                case 0:
+                    bits = CheckRandomBits();
+                    checkBits |= bits;
+                    (void)xEventGroupSetBits(checkGroup, bits);
+                    break;
+
+                case 1:
+                    bits = CheckRandomBits();
+                    checkBits &= (EventBits_t)~bits;
+                    (void)xEventGroupClearBits(checkGroup, bits);
+                    break;
+
+                case 2:
+                    // Idle never blocks
+                    if (i != 0)
+                    {
+                        CheckWait(i);
+                    }
+                    break;
+
+                default:
+                    CheckInterrupt(0);
+                    break;
+            }
+        }
+
+        CheckInvariants();
+    }
+
+    printf("%lu steps: %lu wakes, interrupt sets %lu direct, %lu left for the task, %lu refused\n",
+           checkStep, checkWakes, checkSetDirect, checkSetLocked, checkRefused);
+
+    exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned i;
+
+    srand(argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 1U);
+
+    checkGroup = xEventGroupCreateStatic(&checkGroupBuffer);
+
+    for (i = 1; i <= CHECK_TASKS; i++)
+    {
+        checkTasks[i] = xTaskCreateStatic(CheckTask, "Check", CHECK_STACK, NULL, 1, checkStack[i], &checkTCB[i]);
+        vTaskSetTaskNumber(checkTasks[i], i);
+    }
+
+    vTaskStartScheduler();
+
+    return 2;
+}
@@ -0,0 +1,377 @@
+/*
+ * File:   poolcheck.c
+ *
+ * Host check of the memory pools (mempool.c) against a model of which
+ * blocks are taken: MemPoolTake() and MemPoolGive() on one pool, and
+ * MemPoolAlloc() and MemPoolFree() over the size classes, along with the
+ * gives the pools must refuse.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -I tools/delaybench -I FreeRTOS/include -I . \
+ *       -o poolcheck tools/poolcheck/poolcheck.c mempool.c
+ *   ./poolcheck [seed]
+ *
+ * Only the interrupt mask macros come from the host port of tools/delaybench.
+ * A pointer is 8 bytes here, so that is the smallest block, and blocks of
+ * other sizes leave the free list pointers unaligned, which x86 allows.
+ *
+ * Three size classes, and a pool that is not one of them, have blocks taken
+ * and given at random, directly and by size, until they run dry and past.
+ * Between the good gives come bad ones: blocks already given back, addresses
+ * inside a taken block, blocks given to a pool that does not own them, and
+ * frees of memory no class owns. Each must return 0 and count against the
+ * pool, or as a foreign free, and leave the pool as it was. Every block taken
+ * is filled with a pattern, which must still be there when it is given back.
+ * After every step each pool's counters must match the model, and its free
+ * list must hold exactly the blocks the model has free.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "mempool.h"
+
+#define CHECK_STEPS     1000000UL
+#define CHECK_CLASSES   3
+// The size classes and the pool outside them
+#define CHECK_POOLS     (CHECK_CLASSES + 1)
+#define CHECK_BLOCKS    8
+// Asked of MemPoolAlloc(), more than the largest class holds
+#define CHECK_SIZE_MAX  48
+
+MEMPOOL_DEFINE(smallPool, 3, 5);
+MEMPOOL_DEFINE(mediumPool, 10, 4);
+MEMPOOL_DEFINE(largePool, 40, 3);
+MEMPOOL_DEFINE(otherPool, 16, 8);
+
+static MemPool_t * const checkClasses[CHECK_CLASSES] = { &smallPool, &mediumPool, &largePool };
+static MemPool_t * const checkPools[CHECK_POOLS] = { &smallPool, &mediumPool, &largePool, &otherPool };
+
+// Memory that no pool owns, for the foreign frees
+static uint16_t checkForeign[8];
+
+// The model: which blocks are taken, and what each pool has counted
+static uint8_t modelTaken[CHECK_POOLS][CHECK_BLOCKS];
+static uint16_t modelUsed[CHECK_POOLS];
+static uint16_t modelHighWater[CHECK_POOLS];
+static uint16_t modelFailures[CHECK_POOLS];
+static uint16_t modelBadGives[CHECK_POOLS];
+static uint16_t modelForeignFrees;
+
+static unsigned long checkStep;
+static unsigned long checkTakes;
+static unsigned long checkBadGives;
+
+static void CheckFail(const char *what)
+{
+    printf("step %lu: %s\n", checkStep, what);
+    exit(1);
+}
+
+static uint8_t *CheckBlock(unsigned p, unsigned b)
+{
+    return checkPools[p]->storage + b * checkPools[p]->blockSize;
+}
+
+// A pattern no other block shares
+static uint8_t CheckPattern(unsigned p, unsigned b, unsigned offset)
+{
+    return (uint8_t)(p * 64 + b * 8 + offset);
+}
+
+// Finds the pool and block index a pointer from a take belongs to
+static void CheckTaken(void *block, unsigned expected)
+{
+    uint8_t *address = block;
+    unsigned p;
+    unsigned b;
+    unsigned j;
+
+    for (p = 0; p < CHECK_POOLS; p++)
+    {
+        for (b = 0; b < checkPools[p]->blockCount; b++)
+        {
+            if (address == CheckBlock(p, b))
+            {
+                if (p != expected)
+                {
+                    CheckFail("took a block from the wrong pool");
+                }
+                if (modelTaken[p][b])
+                {
+                    CheckFail("took a block that is already taken");
+                }
+
+                modelTaken[p][b] = 1;
+                modelUsed[p]++;
+                if (modelUsed[p] > modelHighWater[p])
+                {
+                    modelHighWater[p] = modelUsed[p];
+                }
+                for (j = 0; j < checkPools[p]->blockSize; j++)
+                {
+                    address[j] = CheckPattern(p, b, j);
+                }
+                checkTakes++;
+                return;
+            }
+        }
+    }
+
+    CheckFail("took something that is not a block");
+}
+
+static void CheckTake(void)
+{
+    unsigned p = (unsigned)rand() % CHECK_POOLS;
+    void *block = MemPoolTake(checkPools[p]);
+
+    if (modelUsed[p] == checkPools[p]->blockCount)
+    {
+        if (block != NULL)
+        {
+            CheckFail("took a block from an empty pool");
+        }
+        modelFailures[p]++;
+        return;
+    }
+
+    if (block == NULL)
+    {
+        CheckFail("no block from a pool with blocks free");
+    }
+    CheckTaken(block, p);
+}
+
+static void CheckAlloc(void)
+{
+    size_t size = (size_t)rand() % (CHECK_SIZE_MAX + 1);
+    void *block = MemPoolAlloc(size);
+    unsigned p;
+
+    // The smallest class that fits and has a block free, every empty class
+    // that fits on the way counting a failure
+    for (p = 0; p < CHECK_CLASSES; p++)
+    {
+        if (checkClasses[p]->blockSize >= size)
+        {
+            if (modelUsed[p] < checkClasses[p]->blockCount)
+            {
+                break;
+            }
+            modelFailures[p]++;
+        }
+    }
+
+    if (p == CHECK_CLASSES)
+    {
+        if (block != NULL)
+        {
+            CheckFail("allocated with no class free that fits");
+        }
+        return;
+    }
+
+    if (block == NULL)
+    {
+        CheckFail("no block allocated with a class free that fits");
+    }
+    CheckTaken(block, p);
+}
+
+// Gives back a taken block, to its pool or through MemPoolFree()
+static void CheckGive(void)
+{
+    unsigned p = (unsigned)rand() % CHECK_POOLS;
+    unsigned b = (unsigned)rand() % checkPools[p]->blockCount;
+    uint8_t *block = CheckBlock(p, b);
+    uint8_t given;
+    unsigned j;
+
+    if (!modelTaken[p][b])
+    {
+        return;
+    }
+
+    for (j = 0; j < checkPools[p]->blockSize; j++)
+    {
+        if (block[j] != CheckPattern(p, b, j))
+        {
+            CheckFail("a taken block changed");
+        }
+    }
+
+    // The pool outside the classes is only given back directly
+    if (p < CHECK_CLASSES && (rand() & 1))
+    {
+        given = MemPoolFree(block);
+    }
+    else
+    {
+        given = MemPoolGive(checkPools[p], block);
+    }
+    if (!given)
+    {
+        CheckFail("a taken block was refused");
+    }
+
+    modelTaken[p][b] = 0;
+    modelUsed[p]--;
+}
+
+static void CheckRefused(uint8_t given)
+{
+    if (given)
+    {
+        CheckFail("a bad give was taken");
+    }
+    checkBadGives++;
+}
+
+static void CheckBadGive(void)
+{
+    unsigned p = (unsigned)rand() % CHECK_POOLS;
+    unsigned b = (unsigned)rand() % checkPools[p]->blockCount;
+    unsigned q;
+    uint8_t *block = CheckBlock(p, b);
+    uint8_t *address;
+    int toClass = p < CHECK_CLASSES && (rand() & 1);
+
+    switch (rand() % 4)
+    {
+        case 0:
+            // Double free, a block that is already free
+            if (modelTaken[p][b])
+            {
+                return;
+            }
+            CheckRefused(toClass ? MemPoolFree(block) : MemPoolGive(checkPools[p], block));
+            modelBadGives[p]++;
+            break;
+
+        case 1:
+            // Misaligned, inside a block or past the end of the pool
+            address = block + 1 + (unsigned)rand() % (checkPools[p]->blockSize - 1);
+            if (rand() % 8 == 0)
+            {
+                address = CheckBlock(p, checkPools[p]->blockCount);
+            }
+            CheckRefused(toClass && address < CheckBlock(p, checkPools[p]->blockCount) ?
+                         MemPoolFree(address) : MemPoolGive(checkPools[p], address));
+            modelBadGives[p]++;
+            break;
+
+        case 2:
+            // A block given to a pool that does not own it
+            q = (p + 1 + (unsigned)rand() % (CHECK_POOLS - 1)) % CHECK_POOLS;
+            CheckRefused(MemPoolGive(checkPools[q], block));
+            modelBadGives[q]++;
+            break;
+
+        default:
+            // Memory no class owns, the other pool's blocks included
+            address = (rand() & 1) ? (uint8_t *)&checkForeign[rand() % 8]
+                                   : CheckBlock(CHECK_CLASSES, b % otherPool.blockCount);
+            CheckRefused(MemPoolFree(address));
+            modelForeignFrees++;
+            break;
+    }
+}
+
+static void CheckPools(void)
+{
+    const MemPool_t *pool;
+    uint8_t onList[CHECK_BLOCKS];
+    uint8_t *block;
+    unsigned p;
+    unsigned b;
+    unsigned listed;
+
+    for (p = 0; p < CHECK_POOLS; p++)
+    {
+        pool = checkPools[p];
+
+        if (pool->used != modelUsed[p] || pool->highWater != modelHighWater[p] ||
+            pool->failures != modelFailures[p] || pool->badGives != modelBadGives[p])
+        {
+            CheckFail("pool counters differ from the model");
+        }
+
+        for (b = 0; b < CHECK_BLOCKS; b++)
+        {
+            onList[b] = 0;
+        }
+
+        // Every free block once, and nothing else, on the free list
+        listed = 0;
+        for (block = pool->freeList; block != NULL; block = *(void **)block)
+        {
+            for (b = 0; b < pool->blockCount && block != CheckBlock(p, b); b++)
+            {
+            }
+            if (b == pool->blockCount || modelTaken[p][b] || onList[b] || ++listed > pool->blockCount)
+            {
+                CheckFail("free list differs from the free blocks");
+            }
+            onList[b] = 1;
+        }
+        if (listed != (unsigned)(pool->blockCount - modelUsed[p]))
+        {
+            CheckFail("a free block is missing from the free list");
+        }
+    }
+
+    if (MemPoolForeignFrees() != modelForeignFrees)
+    {
+        CheckFail("foreign frees differ from the model");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    srand(argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 1U);
+
+    MemPoolInit(&otherPool);
+    MemPoolStart(checkClasses, CHECK_CLASSES);
+
+    if (MemPoolClassCount() != CHECK_CLASSES || MemPoolClass(1) != &mediumPool)
+    {
+        CheckFail("classes differ from the ones started");
+    }
+    if (MemPoolFree(NULL) != 1)
+    {
+        CheckFail("freeing NULL was refused");
+    }
+
+    for (checkStep = 0; checkStep < CHECK_STEPS; checkStep++)
+    {
+        switch (rand() % 8)
+        {
+            case 0:
+            case 1:
+                CheckTake();
+                break;
+
+            case 2:
+            case 3:
+                CheckAlloc();
+                break;
+
+            case 4:
+            case 5:
+                CheckGive();
+                break;
+
+            default:
+                CheckBadGive();
+                break;
+        }
+
+        CheckPools();
+    }
+
+    printf("%lu steps: %lu blocks taken, %lu bad gives refused\n", checkStep, checkTakes, checkBadGives);
+
+    return 0;
+}
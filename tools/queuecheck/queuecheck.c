@@ -0,0 +1,638 @@
+/*
+ * File:   queuecheck.c
+ *
+ * Host check of the batch queue calls (configUSE_QUEUE_BATCH) against a
+ * model of the queue: xQueueSendMultiple(), xQueueReceiveMultiple() and
+ * their FromISR versions, mixed with the single-item calls. It includes the
+ * real tasks.c and queue.c, built against the host port of tools/delaybench,
+ * and plays both the tasks and the interrupt. The interrupt comes from the
+ * main loop, with the scheduler running, and from the trace hooks a task
+ * passes with the queue locked, just before it blocks on it, so FromISR
+ * calls also find the queue locked and leave the wakes to the task.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -fno-strict-aliasing -DconfigUSE_QUEUE_BATCH=1 -DconfigUSE_QUEUE_SETS=1 \
+ *       -DINCLUDE_eTaskGetState=1 -I tools/delaybench -I FreeRTOS/include \
+ *       -I FreeRTOS -o queuecheck tools/queuecheck/queuecheck.c FreeRTOS/list.c
+ *   ./queuecheck [seed]
+ *
+ * -fno-strict-aliasing is needed with tasks.c in the same file: the list
+ * ends are MiniListItem_t read through ListItem_t pointers, and GCC at -O2
+ * otherwise reorders the accesses.
+ *
+ * Each item size 1-3 and queue length 1-7 gets CHECK_STEPS random calls,
+ * once on a queue of its own and once on a queue in a queue set, where every
+ * receive first takes a handle from the set per item. Each combination runs
+ * in a child process, so each starts with a fresh kernel. CHECK_TASKS tasks
+ * at two priorities send and receive batches of up to CHECK_COUNT_MAX items,
+ * more than the queue holds, some blocking until they can. Every item
+ * received must be the one the model has at the front. After every step the
+ * queue, and the set, must hold as many items as the model, neither may be
+ * left locked, and no task may still be blocked while there are items (or
+ * spaces) for it that no task already woken will take.
+ */
+
+#include <setjmp.h>
+
+// The interrupt can come at each of these, with the queue or set locked
+static void CheckHookInterrupt(void);
+
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )      CheckHookInterrupt()
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )   CheckHookInterrupt()
+
+// Set once a call has copied its items, any switch after that only returns
+static int checkCopied;
+
+#define traceQUEUE_SEND( pxQueue )                  ( checkCopied = 1 )
+#define traceQUEUE_RECEIVE( pxQueue )               ( checkCopied = 1 )
+
+#include "tasks.c"
+#include "queue.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#if ( configUSE_QUEUE_BATCH != 1 ) || ( configUSE_QUEUE_SETS != 1 )
+#error Build with -DconfigUSE_QUEUE_BATCH=1 -DconfigUSE_QUEUE_SETS=1, see the top of the file
+#endif
+
+#define CHECK_TASKS         4
+#define CHECK_STEPS         20000UL
+#define CHECK_STACK         64
+#define CHECK_LENGTH_MAX    7
+#define CHECK_SIZE_MAX      3
+#define CHECK_COUNT_MAX     ( CHECK_LENGTH_MAX + 2 )
+
+typedef enum
+{
+    OP_SEND,
+    OP_SEND_FRONT,
+    OP_SEND_MULTIPLE,
+    OP_RECEIVE,
+    OP_RECEIVE_MULTIPLE,
+    OP_KINDS
+} CheckOpKind_t;
+
+typedef struct
+{
+    CheckOpKind_t kind;
+    UBaseType_t count;
+    TickType_t block;
+    uint8_t items[CHECK_COUNT_MAX * CHECK_SIZE_MAX];
+} CheckOp_t;
+
+static StaticTask_t checkTCB[CHECK_TASKS + 1];
+static StackType_t  checkStack[CHECK_TASKS + 1][CHECK_STACK];
+static TaskHandle_t checkTasks[CHECK_TASKS + 1];
+static StaticTask_t idleTCB;
+static StackType_t  idleStack[configMINIMAL_STACK_SIZE];
+
+static StaticQueue_t checkQueueBuffer;
+static uint8_t checkQueueStorage[CHECK_LENGTH_MAX * CHECK_SIZE_MAX];
+static QueueHandle_t checkQueue;
+static StaticQueue_t checkSetBuffer;
+static uint8_t checkSetStorage[CHECK_LENGTH_MAX * sizeof(QueueSetMemberHandle_t)];
+static QueueSetHandle_t checkSet;
+
+static UBaseType_t checkLength;
+static UBaseType_t checkSize;
+
+// The model, the items the queue holds from the front
+static uint8_t modelItems[CHECK_LENGTH_MAX][CHECK_SIZE_MAX];
+static UBaseType_t modelCount;
+static uint8_t modelNext;
+
+// The call a task is in, indexed by task number, 0 being idle. A task that
+// blocks, or is switched out before it copies, comes back here from its
+// yield and makes the same call again once it runs, as the loop in the
+// call itself would
+static CheckOp_t checkPendingOp[CHECK_TASKS + 1];
+static uint8_t checkPending[CHECK_TASKS + 1];
+static jmp_buf checkSwitched;
+static int checkInCall;
+static int checkInInterrupt;
+
+static unsigned long checkStep;
+static unsigned long checkBatches;
+static unsigned long checkWrapped;
+static unsigned long checkLocked;
+static unsigned long checkBlocks;
+
+static void CheckFail(const char *what)
+{
+    printf("size %u, length %u%s, step %lu: %s\n", (unsigned)checkSize, (unsigned)checkLength,
+           checkSet != NULL ? " in a set" : "", checkStep, what);
+    exit(1);
+}
+
+// Host port, see tools/delaybench/portmacro.h
+void vPortYield(void)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+    vTaskSwitchContext();
+
+    if (checkInCall && !checkCopied && xTaskGetCurrentTaskHandle() != task)
+    {
+        checkInCall = 0;
+        checkBlocks++;
+        longjmp(checkSwitched, 1);
+    }
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void)pxCode;
+    (void)pvParameters;
+
+    return pxTopOfStack;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &idleTCB;
+    *ppxIdleTaskStackBuffer = idleStack;
+    *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+// Never called, the check plays every task
+static void CheckTask(void *pvParameters)
+{
+    (void)pvParameters;
+}
+
+static int CheckIsSend(CheckOpKind_t kind)
+{
+    return kind == OP_SEND || kind == OP_SEND_FRONT || kind == OP_SEND_MULTIPLE;
+}
+
+static void CheckNewOp(CheckOp_t *op, int fromInterrupt)
+{
+    UBaseType_t i;
+
+    op->kind = (CheckOpKind_t)(rand() % OP_KINDS);
+    // The FromISR calls can't send to the front here
+    if (fromInterrupt && op->kind == OP_SEND_FRONT)
+    {
+        op->kind = OP_SEND;
+    }
+    op->count = (op->kind == OP_SEND_MULTIPLE || op->kind == OP_RECEIVE_MULTIPLE) ? 1 + rand() % CHECK_COUNT_MAX : 1;
+    op->block = (rand() & 1) ? portMAX_DELAY : 0;
+
+    for (i = 0; i < op->count * checkSize; i++)
+    {
+        op->items[i] = modelNext++;
+    }
+}
+
+// Batches that fill or empty the queue up to the end of its storage and go
+// on from the start
+static void CheckCountWrap(UBaseType_t moved, const int8_t *from)
+{
+    const Queue_t *queue = checkQueue;
+
+    if (moved > 1)
+    {
+        checkBatches++;
+        if (from + moved * checkSize > queue->u.xQueue.pcTail)
+        {
+            checkWrapped++;
+        }
+    }
+}
+
+static const int8_t *CheckNextRead(void)
+{
+    const Queue_t *queue = checkQueue;
+    const int8_t *from = queue->u.xQueue.pcReadFrom + checkSize;
+
+    return from >= queue->u.xQueue.pcTail ? queue->pcHead : from;
+}
+
+static void CheckSent(const CheckOp_t *op, UBaseType_t moved)
+{
+    UBaseType_t i;
+
+    if (moved > op->count || modelCount + moved > checkLength)
+    {
+        CheckFail("sent more items than asked for or than fit");
+    }
+    if (moved < op->count && modelCount + moved < checkLength)
+    {
+        CheckFail("sent fewer items than fit");
+    }
+
+    if (op->kind == OP_SEND_FRONT && moved == 1)
+    {
+        memmove(modelItems[1], modelItems[0], modelCount * sizeof(modelItems[0]));
+        memcpy(modelItems[0], op->items, checkSize);
+    }
+    else
+    {
+        for (i = 0; i < moved; i++)
+        {
+            memcpy(modelItems[modelCount + i], &op->items[i * checkSize], checkSize);
+        }
+    }
+    modelCount += moved;
+}
+
+static void CheckReceived(const CheckOp_t *op, const uint8_t *buffer, UBaseType_t moved, UBaseType_t available)
+{
+    UBaseType_t i;
+
+    if (moved > op->count || moved > modelCount)
+    {
+        CheckFail("received more items than asked for or than there were");
+    }
+    if (moved < op->count && moved < available)
+    {
+        CheckFail("received fewer items than there were");
+    }
+
+    for (i = 0; i < moved; i++)
+    {
+        if (memcmp(&buffer[i * checkSize], modelItems[i], checkSize) != 0)
+        {
+            CheckFail("received an item out of order or changed");
+        }
+    }
+
+    memmove(modelItems[0], modelItems[moved], (modelCount - moved) * sizeof(modelItems[0]));
+    modelCount -= moved;
+}
+
+// With a set, every item taken from the queue needs a handle taken from the
+// set first. Returns how many handles were taken, up to count
+static UBaseType_t CheckTakeFromSet(UBaseType_t count, TickType_t block, int fromInterrupt)
+{
+    UBaseType_t taken = 0;
+    QueueSetMemberHandle_t member;
+
+    while (taken < count)
+    {
+        if (fromInterrupt)
+        {
+            member = xQueueSelectFromSetFromISR(checkSet);
+        }
+        else
+        {
+            checkCopied = 0;
+            member = xQueueSelectFromSet(checkSet, taken == 0 ? block : 0);
+        }
+
+        if (member == NULL)
+        {
+            break;
+        }
+        if (member != checkQueue)
+        {
+            CheckFail("the set gave another member");
+        }
+        taken++;
+    }
+
+    return taken;
+}
+
+static void CheckTaskCall(unsigned task, const CheckOp_t *op)
+{
+    uint8_t buffer[CHECK_COUNT_MAX * CHECK_SIZE_MAX];
+    UBaseType_t moved = 0;
+    UBaseType_t available = 0;
+    const int8_t *from;
+
+    from = CheckIsSend(op->kind) ? ((const Queue_t *)checkQueue)->pcWriteTo : CheckNextRead();
+
+    switch (op->kind)
+    {
+        case OP_SEND:
+            moved = xQueueSend(checkQueue, op->items, op->block) == pdPASS;
+            break;
+
+        case OP_SEND_FRONT:
+            moved = xQueueSendToFront(checkQueue, op->items, op->block) == pdPASS;
+            break;
+
+        case OP_SEND_MULTIPLE:
+            moved = (UBaseType_t)xQueueSendMultiple(checkQueue, op->items, op->count, op->block);
+            break;
+
+        default:
+            if (checkSet != NULL)
+            {
+                // The set may have been the one blocked on, the copy from the
+                // queue below never blocks
+                available = CheckTakeFromSet(op->count, op->block, 0);
+                if (available == 0)
+                {
+                    break;
+                }
+                from = CheckNextRead();
+            }
+            checkCopied = 0;
+
+            if (op->kind == OP_RECEIVE)
+            {
+                moved = xQueueReceive(checkQueue, buffer, checkSet != NULL ? 0 : op->block) == pdPASS;
+            }
+            else
+            {
+                moved = (UBaseType_t)xQueueReceiveMultiple(checkQueue, buffer, checkSet != NULL ? available : op->count, checkSet != NULL ? 0 : op->block);
+            }
+
+            if (checkSet != NULL && moved != available)
+            {
+                CheckFail("queue held fewer items than the set had handles");
+            }
+            break;
+    }
+
+    checkInCall = 0;
+    checkPending[task] = 0;
+
+    if (moved == 0 && op->block != 0)
+    {
+        CheckFail("call gave up without its block time running out");
+    }
+
+    CheckCountWrap(moved, from);
+    if (CheckIsSend(op->kind))
+    {
+        CheckSent(op, moved);
+    }
+    else
+    {
+        // Interrupts at the hooks come before the copy, so the model
+        // holds what the queue did then
+        CheckReceived(op, buffer, moved, checkSet != NULL ? available : modelCount);
+    }
+}
+
+static void CheckTaskOp(unsigned task, const CheckOp_t *op)
+{
+    checkPendingOp[task] = *op;
+    checkPending[task] = 1;
+
+    checkInCall = 1;
+    checkCopied = 0;
+    if (setjmp(checkSwitched) == 0)
+    {
+        CheckTaskCall(task, &checkPendingOp[task]);
+    }
+    // Otherwise blocked, or switched out, before it copied anything
+}
+
+static void CheckInterrupt(void)
+{
+    CheckOp_t op;
+    uint8_t buffer[CHECK_COUNT_MAX * CHECK_SIZE_MAX] = { 0 };
+    const Queue_t *queue = checkQueue;
+    const Queue_t *set = checkSet;
+    BaseType_t woken = pdFALSE;
+    UBaseType_t moved = 0;
+    UBaseType_t available;
+    const int8_t *from;
+
+    checkInInterrupt = 1;
+    CheckNewOp(&op, 1);
+
+    if (queue->cTxLock != queueUNLOCKED || (set != NULL && set->cTxLock != queueUNLOCKED))
+    {
+        checkLocked++;
+    }
+
+    if (CheckIsSend(op.kind))
+    {
+        from = queue->pcWriteTo;
+        if (op.kind == OP_SEND)
+        {
+            moved = xQueueSendFromISR(checkQueue, op.items, &woken) == pdPASS;
+        }
+        else
+        {
+            moved = (UBaseType_t)xQueueSendMultipleFromISR(checkQueue, op.items, op.count, &woken);
+        }
+
+        CheckCountWrap(moved, from);
+        CheckSent(&op, moved);
+    }
+    else
+    {
+        available = modelCount;
+        if (checkSet != NULL)
+        {
+            available = CheckTakeFromSet(op.count, 0, 1);
+        }
+        from = CheckNextRead();
+
+        if (checkSet != NULL && available == 0)
+        {
+            // Nothing to take
+        }
+        else if (op.kind == OP_RECEIVE)
+        {
+            moved = xQueueReceiveFromISR(checkQueue, buffer, &woken) == pdPASS;
+        }
+        else
+        {
+            moved = (UBaseType_t)xQueueReceiveMultipleFromISR(checkQueue, buffer, checkSet != NULL ? available : op.count, &woken);
+        }
+
+        if (checkSet != NULL && moved != available)
+        {
+            CheckFail("queue held fewer items than the set had handles");
+        }
+
+        CheckCountWrap(moved, from);
+        CheckReceived(&op, buffer, moved, modelCount);
+    }
+
+    // With the scheduler suspended the switch waits for xTaskResumeAll()
+    if (woken && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+    {
+        vTaskSwitchContext();
+    }
+
+    checkInInterrupt = 0;
+}
+
+static void CheckHookInterrupt(void)
+{
+    // The interrupt's own sends to the set pass traceQUEUE_SET_SEND, which is
+    // traceQUEUE_SEND, and must not count as a copy by the interrupted task
+    int copied = checkCopied;
+
+    // Interrupts don't nest here, and come at a hook only some of the time
+    if (!checkInInterrupt && (rand() & 1))
+    {
+        CheckInterrupt();
+    }
+
+    checkCopied = copied;
+}
+
+static void CheckInvariants(void)
+{
+    const Queue_t *queue = checkQueue;
+    const Queue_t *set = checkSet;
+    unsigned blockedReaders = 0;
+    unsigned blockedWriters = 0;
+    unsigned wokenReaders = 0;
+    unsigned wokenWriters = 0;
+    UBaseType_t available;
+    unsigned i;
+
+    if (queue->uxMessagesWaiting != modelCount)
+    {
+        CheckFail("queue holds a different number of items than the model");
+    }
+    if (queue->cRxLock != queueUNLOCKED || queue->cTxLock != queueUNLOCKED)
+    {
+        CheckFail("queue left locked");
+    }
+
+    available = modelCount;
+    if (set != NULL)
+    {
+        if (set->uxMessagesWaiting != modelCount)
+        {
+            CheckFail("set holds a different number of handles than the queue has items");
+        }
+        if (set->cRxLock != queueUNLOCKED || set->cTxLock != queueUNLOCKED)
+        {
+            CheckFail("set left locked");
+        }
+    }
+
+    for (i = 1; i <= CHECK_TASKS; i++)
+    {
+        if (!checkPending[i])
+        {
+            continue;
+        }
+
+        if (eTaskGetState(checkTasks[i]) == eBlocked)
+        {
+            CheckIsSend(checkPendingOp[i].kind) ? blockedWriters++ : blockedReaders++;
+        }
+        else
+        {
+            CheckIsSend(checkPendingOp[i].kind) ? wokenWriters++ : wokenReaders++;
+        }
+    }
+
+    if (blockedReaders > 0 && available > wokenReaders)
+    {
+        CheckFail("a task is still blocked on items that are there");
+    }
+    if (blockedWriters > 0 && checkLength - modelCount > wokenWriters)
+    {
+        CheckFail("a task is still blocked on spaces that are there");
+    }
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    CheckOp_t op;
+    TaskHandle_t task;
+    unsigned i;
+
+    for (checkStep = 0; checkStep < CHECK_STEPS; checkStep++)
+    {
+        task = xTaskGetCurrentTaskHandle();
+        i = (task == xTaskGetIdleTaskHandle()) ? 0 : (unsigned)uxTaskGetTaskNumber(task);
+
+        if (i == 0 || rand() % 4 == 0)
+        {
+            CheckInterrupt();
+        }
+        else if (checkPending[i])
+        {
+            op = checkPendingOp[i];
+            CheckTaskOp(i, &op);
+        }
+        else
+        {
+            CheckNewOp(&op, 0);
+            CheckTaskOp(i, &op);
+        }
+
+        CheckInvariants();
+    }
+
+    printf("size %u, length %u%s: %lu batches, %lu wrapped, %lu interrupts on a locked queue, %lu blocks\n",
+           (unsigned)checkSize, (unsigned)checkLength, checkSet != NULL ? " in a set" : "",
+           checkBatches, checkWrapped, checkLocked, checkBlocks);
+
+    exit(0);
+}
+
+static void CheckRun(unsigned seed, UBaseType_t size, UBaseType_t length, int inSet)
+{
+    unsigned i;
+
+    srand(seed);
+    checkSize = size;
+    checkLength = length;
+
+    checkQueue = xQueueCreateStatic(length, size, checkQueueStorage, &checkQueueBuffer);
+    if (inSet)
+    {
+        checkSet = xQueueCreateSetStatic(length, checkSetStorage, &checkSetBuffer);
+        (void)xQueueAddToSet(checkQueue, checkSet);
+    }
+
+    for (i = 1; i <= CHECK_TASKS; i++)
+    {
+        checkTasks[i] = xTaskCreateStatic(CheckTask, "Check", CHECK_STACK, NULL, 1 + i % 2, checkStack[i], &checkTCB[i]);
+        vTaskSetTaskNumber(checkTasks[i], i);
+    }
+
+    vTaskStartScheduler();
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 1U;
+    UBaseType_t size;
+    UBaseType_t length;
+    int inSet;
+    int status;
+    int failed = 0;
+    pid_t child;
+
+    for (inSet = 0; inSet <= 1; inSet++)
+    {
+        for (size = 1; size <= CHECK_SIZE_MAX; size++)
+        {
+            for (length = 1; length <= CHECK_LENGTH_MAX; length++)
+            {
+                fflush(stdout);
+                child = fork();
+                if (child == 0)
+                {
+                    CheckRun(seed, size, length, inSet);
+                    return 2;
+                }
+
+                if (child < 0 || waitpid(child, &status, 0) != child ||
+                    !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                {
+                    failed = 1;
+                }
+            }
+        }
+    }
+
+    printf(failed ? "FAILED\n" : "passed\n");
+
+    return failed;
+}
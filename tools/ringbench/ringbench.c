@@ -0,0 +1,342 @@
+/*
+ * File:   ringbench.c
+ *
+ * Host benchmark of the byte paths from an interrupt to a task: the lock-free
+ * ring in ring.c against a queue of one byte items and a stream buffer. It
+ * builds the real queue.c, stream_buffer.c, tasks.c and list.c against the
+ * host port of tools/delaybench, which has no scheduler, so one thread plays
+ * both sides: it writes a chunk, reads it back, and checks every byte.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -pthread -DconfigUSE_QUEUE_BATCH=1 -DconfigUSE_STREAM_BUFFER_ZERO_COPY=1 \
+ *       -I tools/delaybench -I FreeRTOS/include -I . -o ringbench \
+ *       tools/ringbench/ringbench.c ring.c FreeRTOS/queue.c \
+ *       FreeRTOS/stream_buffer.c FreeRTOS/tasks.c FreeRTOS/list.c
+ *   ./ringbench
+ *
+ * Each path moves BENCH_BYTES through 64 bytes of storage in chunks of 1, 8
+ * and 32 bytes and prints the nanoseconds per byte. The batch queue calls and
+ * the zero copy stream buffer calls are only run when built with them. The
+ * kernel's critical sections compile to nothing on the host, so the kernel
+ * numbers are what the calls cost with no interrupt masking at all.
+ *
+ * Last, the ring runs with a producer and a consumer thread, to check it
+ * holds up with the two sides really running at once. That relies on the
+ * host keeping stores in order as the PIC24 does, true of x86. A side that
+ * finds the ring full or empty yields, for hosts with a single CPU.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "ring.h"
+
+#define BENCH_BYTES     4000000UL
+#define BENCH_STORAGE   64
+#define BENCH_CHUNK_MAX 32
+
+static StaticTask_t idleTCB;
+static StackType_t  idleStack[configMINIMAL_STACK_SIZE];
+
+RING_DEFINE(benchRing, BENCH_STORAGE);
+
+static StaticQueue_t benchQueueBuffer;
+static uint8_t benchQueueStorage[BENCH_STORAGE];
+static QueueHandle_t benchQueue;
+
+static StaticStreamBuffer_t benchStreamBuffer;
+// A stream buffer keeps one byte free, so one more for the same capacity
+static uint8_t benchStreamStorage[BENCH_STORAGE + 1];
+static StreamBufferHandle_t benchStream;
+
+static uint8_t txChunk[BENCH_CHUNK_MAX];
+static uint8_t rxChunk[BENCH_CHUNK_MAX];
+static uint8_t txNext;
+static uint8_t rxNext;
+static unsigned long benchErrors;
+
+// Host port, see tools/delaybench/portmacro.h. Nothing here blocks, so the
+// scheduler is never started
+void vPortYield(void)
+{
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void)pxCode;
+    (void)pvParameters;
+
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    return pdFAIL;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &idleTCB;
+    *ppxIdleTaskStackBuffer = idleStack;
+    *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+static uint64_t BenchNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// The producer's next chunk, a running count so a lost or repeated byte shows
+static void BenchFill(uint8_t *data, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        data[i] = txNext++;
+    }
+}
+
+static void BenchCheck(const uint8_t *data, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (data[i] != rxNext++)
+        {
+            benchErrors++;
+        }
+    }
+}
+
+typedef void (*BenchPath_t)(size_t chunk);
+
+static void PathRingByte(size_t chunk)
+{
+    size_t i;
+
+    BenchFill(txChunk, chunk);
+    for (i = 0; i < chunk; i++)
+    {
+        (void)RingPut(&benchRing, txChunk[i]);
+    }
+    for (i = 0; i < chunk; i++)
+    {
+        (void)RingGet(&benchRing, &rxChunk[i]);
+    }
+    BenchCheck(rxChunk, chunk);
+}
+
+static void PathRingBulk(size_t chunk)
+{
+    BenchFill(txChunk, chunk);
+    (void)RingWrite(&benchRing, txChunk, (uint16_t)chunk);
+    (void)RingRead(&benchRing, rxChunk, (uint16_t)chunk);
+    BenchCheck(rxChunk, chunk);
+}
+
+static void PathQueueItem(size_t chunk)
+{
+    size_t i;
+
+    BenchFill(txChunk, chunk);
+    for (i = 0; i < chunk; i++)
+    {
+        (void)xQueueSend(benchQueue, &txChunk[i], 0);
+    }
+    for (i = 0; i < chunk; i++)
+    {
+        (void)xQueueReceive(benchQueue, &rxChunk[i], 0);
+    }
+    BenchCheck(rxChunk, chunk);
+}
+
+#if (configUSE_QUEUE_BATCH == 1)
+static void PathQueueBatch(size_t chunk)
+{
+    BenchFill(txChunk, chunk);
+    (void)xQueueSendMultiple(benchQueue, txChunk, (UBaseType_t)chunk, 0);
+    (void)xQueueReceiveMultiple(benchQueue, rxChunk, (UBaseType_t)chunk, 0);
+    BenchCheck(rxChunk, chunk);
+}
+#endif
+
+static void PathStream(size_t chunk)
+{
+    BenchFill(txChunk, chunk);
+    (void)xStreamBufferSend(benchStream, txChunk, chunk, 0);
+    (void)xStreamBufferReceive(benchStream, rxChunk, chunk, 0);
+    BenchCheck(rxChunk, chunk);
+}
+
+#if (configUSE_STREAM_BUFFER_ZERO_COPY == 1)
+// Produced and checked in the stream buffer's storage, one or two spans
+static void PathStreamZeroCopy(size_t chunk)
+{
+    uint8_t *span;
+    size_t count;
+    size_t left;
+
+    for (left = chunk; left > 0; left -= count)
+    {
+        count = xStreamBufferSendAcquire(benchStream, &span, 0);
+        if (count > left)
+        {
+            count = left;
+        }
+        BenchFill(span, count);
+        vStreamBufferSendCommit(benchStream, count);
+    }
+    while ((count = xStreamBufferReceiveAcquire(benchStream, &span, 0)) > 0)
+    {
+        BenchCheck(span, count);
+        vStreamBufferReceiveCommit(benchStream, count);
+    }
+}
+#endif
+
+static void BenchRun(const char *name, BenchPath_t path)
+{
+    static const size_t chunks[] = { 1, 8, BENCH_CHUNK_MAX };
+    unsigned long passes;
+    unsigned long n;
+    uint64_t start;
+    size_t i;
+
+    printf("%-26s", name);
+    for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+        passes = BENCH_BYTES / chunks[i];
+        start = BenchNowNs();
+        for (n = 0; n < passes; n++)
+        {
+            path(chunks[i]);
+        }
+        printf(" %8.2f", (double)(BenchNowNs() - start) / (double)(passes * chunks[i]));
+    }
+    printf("\n");
+}
+
+// The interrupt's side of the two thread run, bulk writes of varying size
+static void *BenchProducer(void *arg)
+{
+    uint8_t data[BENCH_CHUNK_MAX];
+    uint8_t next = 0;
+    unsigned long sent = 0;
+    uint16_t count;
+    uint16_t i;
+
+    (void)arg;
+
+    while (sent < BENCH_BYTES)
+    {
+        count = (uint16_t)(1 + sent % BENCH_CHUNK_MAX);
+        for (i = 0; i < count; i++)
+        {
+            data[i] = (uint8_t)(next + i);
+        }
+        count = RingWrite(&benchRing, data, count);
+        next = (uint8_t)(next + count);
+        sent += count;
+
+        // Full, let the consumer have the CPU if it shares one
+        if (count == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void BenchThreads(void)
+{
+    pthread_t producer;
+    uint8_t data[BENCH_CHUNK_MAX];
+    uint8_t next = 0;
+    unsigned long received = 0;
+    unsigned long errors = 0;
+    uint64_t start;
+    uint16_t count;
+    uint16_t i;
+
+    RingInit(&benchRing, benchRingStorage, BENCH_STORAGE);
+
+    start = BenchNowNs();
+    if (pthread_create(&producer, NULL, BenchProducer, NULL) != 0)
+    {
+        perror("pthread_create");
+        exit(2);
+    }
+
+    while (received < BENCH_BYTES)
+    {
+        count = RingRead(&benchRing, data, sizeof(data));
+        for (i = 0; i < count; i++)
+        {
+            if (data[i] != next++)
+            {
+                errors++;
+            }
+        }
+        received += count;
+
+        if (count == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    pthread_join(producer, NULL);
+
+    printf("ring, two threads: %.2f ns/byte, %lu bad bytes\n",
+           (double)(BenchNowNs() - start) / (double)BENCH_BYTES, errors);
+    benchErrors += errors;
+}
+
+int main(void)
+{
+    benchQueue = xQueueCreateStatic(BENCH_STORAGE, sizeof(uint8_t), benchQueueStorage, &benchQueueBuffer);
+    benchStream = xStreamBufferCreateStatic(sizeof(benchStreamStorage), 1, benchStreamStorage, &benchStreamBuffer);
+
+    printf("%lu bytes through %u bytes of storage, ns per byte\n", BENCH_BYTES, BENCH_STORAGE);
+    printf("%-26s %8s %8s %8s\n", "chunk bytes", "1", "8", "32");
+
+    BenchRun("ring, per byte", PathRingByte);
+    BenchRun("ring, bulk", PathRingBulk);
+    BenchRun("queue, per item", PathQueueItem);
+#if (configUSE_QUEUE_BATCH == 1)
+    BenchRun("queue, batch", PathQueueBatch);
+#endif
+    BenchRun("stream buffer, copy", PathStream);
+#if (configUSE_STREAM_BUFFER_ZERO_COPY == 1)
+    BenchRun("stream buffer, zero copy", PathStreamZeroCopy);
+#endif
+
+    BenchThreads();
+
+    if (benchErrors != 0)
+    {
+        printf("%lu bytes lost or out of order\n", benchErrors);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,565 @@
+/*
+ * File:   streamcheck.c
+ *
+ * Host check of the stream buffer zero-copy calls
+ * (configUSE_STREAM_BUFFER_ZERO_COPY) against a model FIFO:
+ * xStreamBufferSendAcquire() and xStreamBufferReceiveAcquire(), and the
+ * commits that follow them, mixed with the copying xStreamBufferSend() and
+ * xStreamBufferReceive(). It includes the real tasks.c and stream_buffer.c,
+ * built against the host port of tools/delaybench, and plays the writer
+ * task, the reader task and the interrupt. The interrupt comes from the main
+ * loop, with the scheduler running, and from the trace hooks a task passes
+ * just before it blocks and just after it moves the head or the tail, and
+ * takes whichever side no task is using at the time.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -fno-strict-aliasing -DconfigUSE_STREAM_BUFFER_ZERO_COPY=1 \
+ *       -DINCLUDE_eTaskGetState=1 -I tools/delaybench -I FreeRTOS/include \
+ *       -I FreeRTOS -o streamcheck tools/streamcheck/streamcheck.c FreeRTOS/list.c
+ *   ./streamcheck [seed]
+ *
+ * -fno-strict-aliasing is needed with tasks.c in the same file, as for
+ * tools/queuecheck.
+ *
+ * Each storage length from 2 to CHECK_LENGTH_MAX gets CHECK_STEPS random
+ * calls, with a random trigger level, in a child process of its own. A task holds
+ * the region it acquired over later steps and commits all, part or none of
+ * it, so the other side runs while it is held. Every acquire must start at
+ * the head (or tail) the model has reached, and return the free space (or
+ * data) up to the end of the storage area; the rest must come from the next
+ * acquire, at the start of the storage. Every byte read, in place or copied,
+ * must be the one the model has at the front, and a region held by the
+ * reader must not change under it. After every step the buffer must hold as
+ * many bytes as the model, and no task may still be blocked while there is
+ * space for the writer, or data at the trigger level for the reader.
+ */
+
+#include <setjmp.h>
+
+// The interrupt can come at each of these, in the middle of a task's call
+static void CheckInterrupt(int fromHook);
+
+#define traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer )          CheckInterrupt( 1 )
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer )       CheckInterrupt( 1 )
+#define traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesSent )          CheckInterrupt( 1 )
+#define traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength )  CheckInterrupt( 1 )
+
+#include "tasks.c"
+#include "stream_buffer.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY != 1 )
+#error Build with -DconfigUSE_STREAM_BUFFER_ZERO_COPY=1, see the top of the file
+#endif
+
+#define CHECK_LENGTH_MAX 17
+#define CHECK_STEPS     20000UL
+#define CHECK_STACK     64
+
+// The two sides, also the task numbers, 0 being idle
+#define CHECK_WRITER    1
+#define CHECK_READER    2
+
+static StaticTask_t checkTCB[3];
+static StackType_t  checkStack[3][CHECK_STACK];
+static TaskHandle_t checkTasks[3];
+static StaticTask_t idleTCB;
+static StackType_t  idleStack[configMINIMAL_STACK_SIZE];
+
+// The buffer holds one byte less than its storage, so the head never
+// catches up with the tail
+static uint8_t checkStorage[CHECK_LENGTH_MAX];
+static StaticStreamBuffer_t checkBufferStatic;
+static StreamBufferHandle_t checkBuffer;
+static size_t checkLength;
+static size_t checkSpace;
+static size_t checkTrigger;
+
+// The model: the bytes in the buffer, oldest first, and where the head and
+// tail should be in the storage
+static uint8_t modelData[CHECK_LENGTH_MAX];
+static size_t modelFront;
+static size_t modelCount;
+static size_t modelHead;
+static size_t modelTail;
+// The next byte the writer writes, counting up
+static uint8_t modelNext;
+
+// Per side: in a call, blocked in an acquire, or holding an acquired region
+static uint8_t checkBusy[3];
+static uint8_t checkPending[3];
+static uint8_t *checkRegion[3];
+static size_t checkHeld[3];
+
+// A task blocking in an acquire comes back here from its yield, and calls
+// the acquire again once it runs
+static jmp_buf checkBlocked;
+static int checkInAcquire;
+static TaskHandle_t checkCaller;
+static int checkInInterrupt;
+
+static unsigned long checkStep;
+static unsigned long checkBytes;
+static unsigned long checkSplit;
+static unsigned long checkBlocks;
+static unsigned long checkAtHook;
+
+static void CheckFail(const char *what)
+{
+    printf("length %u, trigger %u, step %lu: %s\n", (unsigned)checkLength, (unsigned)checkTrigger,
+           checkStep, what);
+    exit(1);
+}
+
+// Host port, see tools/delaybench/portmacro.h
+void vPortYield(void)
+{
+    vTaskSwitchContext();
+
+    if (checkInAcquire && xTaskGetCurrentTaskHandle() != checkCaller)
+    {
+        checkInAcquire = 0;
+        longjmp(checkBlocked, 1);
+    }
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void)pxCode;
+    (void)pvParameters;
+
+    return pxTopOfStack;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &idleTCB;
+    *ppxIdleTaskStackBuffer = idleStack;
+    *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+// Never called, the check plays every task
+static void CheckTask(void *pvParameters)
+{
+    (void)pvParameters;
+}
+
+static size_t CheckMin(size_t a, size_t b)
+{
+    return a < b ? a : b;
+}
+
+static void ModelPush(uint8_t value)
+{
+    modelData[(modelFront + modelCount) % checkLength] = value;
+    modelCount++;
+    modelHead = (modelHead + 1) % checkLength;
+}
+
+static uint8_t ModelPop(void)
+{
+    uint8_t value = modelData[modelFront];
+
+    modelFront = (modelFront + 1) % checkLength;
+    modelCount--;
+    modelTail = (modelTail + 1) % checkLength;
+
+    return value;
+}
+
+static uint8_t ModelPeek(size_t offset)
+{
+    return modelData[(modelFront + offset) % checkLength];
+}
+
+// What an acquire returned, checked against the model, and held for the commit
+static void CheckAcquired(int side, uint8_t *region, size_t length)
+{
+    size_t toEnd;
+    size_t j;
+
+    if (side == CHECK_WRITER)
+    {
+        if (region != &checkStorage[modelHead])
+        {
+            CheckFail("acquired space does not start at the head");
+        }
+        toEnd = checkLength - modelHead;
+        if (length != CheckMin(checkSpace - modelCount, toEnd))
+        {
+            CheckFail("acquired the wrong amount of space");
+        }
+        if (length == toEnd && length < checkSpace - modelCount)
+        {
+            checkSplit++;
+        }
+
+        // Written in place now, only published by the commit
+        for (j = 0; j < length; j++)
+        {
+            region[j] = (uint8_t)(modelNext + j);
+        }
+    }
+    else
+    {
+        if (region != &checkStorage[modelTail])
+        {
+            CheckFail("acquired data does not start at the tail");
+        }
+        toEnd = checkLength - modelTail;
+        if (length != CheckMin(modelCount, toEnd))
+        {
+            CheckFail("acquired the wrong amount of data");
+        }
+        if (length == toEnd && length < modelCount)
+        {
+            checkSplit++;
+        }
+
+        for (j = 0; j < length; j++)
+        {
+            if (region[j] != ModelPeek(j))
+            {
+                CheckFail("acquired data differs from the model");
+            }
+        }
+    }
+
+    checkRegion[side] = region;
+    checkHeld[side] = length;
+}
+
+// The model moves before each call, as the buffer has by the hooks in it
+static void CheckCommit(int side, size_t length, int fromISR, BaseType_t *woken)
+{
+    uint8_t *region = checkRegion[side];
+    size_t j;
+
+    if (side == CHECK_WRITER)
+    {
+        for (j = 0; j < length; j++)
+        {
+            if (region[j] != (uint8_t)(modelNext + j))
+            {
+                CheckFail("space held by the writer changed");
+            }
+            ModelPush(region[j]);
+        }
+        modelNext = (uint8_t)(modelNext + length);
+        checkBytes += length;
+
+        if (fromISR)
+        {
+            vStreamBufferSendCommitFromISR(checkBuffer, length, woken);
+        }
+        else
+        {
+            vStreamBufferSendCommit(checkBuffer, length);
+        }
+    }
+    else
+    {
+        for (j = 0; j < length; j++)
+        {
+            if (region[j] != ModelPeek(0))
+            {
+                CheckFail("data held by the reader changed");
+            }
+            (void)ModelPop();
+        }
+
+        if (fromISR)
+        {
+            vStreamBufferReceiveCommitFromISR(checkBuffer, length, woken);
+        }
+        else
+        {
+            vStreamBufferReceiveCommit(checkBuffer, length);
+        }
+    }
+
+    checkHeld[side] = 0;
+}
+
+// xStreamBufferSend() or xStreamBufferReceive(), asking for up to one byte
+// more than the buffer holds
+static void CheckCopy(int side, int fromISR, BaseType_t *woken)
+{
+    uint8_t data[CHECK_LENGTH_MAX];
+    uint8_t expected[CHECK_LENGTH_MAX];
+    size_t count = 1 + (size_t)rand() % checkLength;
+    size_t length;
+    size_t result;
+    size_t j;
+
+    if (side == CHECK_WRITER)
+    {
+        length = CheckMin(count, checkSpace - modelCount);
+        for (j = 0; j < count; j++)
+        {
+            data[j] = (uint8_t)(modelNext + j);
+        }
+        for (j = 0; j < length; j++)
+        {
+            ModelPush(data[j]);
+        }
+        modelNext = (uint8_t)(modelNext + length);
+        checkBytes += length;
+
+        result = fromISR ? xStreamBufferSendFromISR(checkBuffer, data, count, woken)
+                         : xStreamBufferSend(checkBuffer, data, count, 0);
+        if (result != length)
+        {
+            CheckFail("send wrote the wrong number of bytes");
+        }
+    }
+    else
+    {
+        length = CheckMin(count, modelCount);
+        for (j = 0; j < length; j++)
+        {
+            expected[j] = ModelPop();
+        }
+
+        result = fromISR ? xStreamBufferReceiveFromISR(checkBuffer, data, count, woken)
+                         : xStreamBufferReceive(checkBuffer, data, count, 0);
+        if (result != length)
+        {
+            CheckFail("receive read the wrong number of bytes");
+        }
+        if (memcmp(data, expected, length) != 0)
+        {
+            CheckFail("received data differs from the model");
+        }
+    }
+}
+
+static void CheckInterrupt(int fromHook)
+{
+    BaseType_t woken = pdFALSE;
+    uint8_t *region;
+    size_t length;
+    int side;
+
+    // Interrupts don't nest here, and come at a hook only some of the time
+    if (checkInInterrupt || (fromHook && (rand() & 1)))
+    {
+        return;
+    }
+
+    // Only one writer and one reader at a time, so the interrupt takes a
+    // side its task is not using
+    side = (rand() & 1) ? CHECK_WRITER : CHECK_READER;
+    if (checkBusy[side] || checkPending[side] || checkHeld[side] != 0)
+    {
+        side = CHECK_WRITER + CHECK_READER - side;
+        if (checkBusy[side] || checkPending[side] || checkHeld[side] != 0)
+        {
+            return;
+        }
+    }
+    checkInInterrupt = 1;
+
+    if (rand() & 1)
+    {
+        CheckCopy(side, 1, &woken);
+    }
+    else
+    {
+        length = side == CHECK_WRITER ? xStreamBufferSendAcquire(checkBuffer, &region, 0)
+                                      : xStreamBufferReceiveAcquire(checkBuffer, &region, 0);
+        CheckAcquired(side, region, length);
+        CheckCommit(side, (size_t)rand() % (length + 1), 1, &woken);
+    }
+
+    if (fromHook)
+    {
+        // The task at the hook is the only one that could wait, and it is
+        // not waiting yet, so there is nothing to wake
+        if (woken)
+        {
+            CheckFail("interrupt at a hook woke a task");
+        }
+        checkAtHook++;
+    }
+    else if (woken)
+    {
+        vTaskSwitchContext();
+    }
+
+    checkInInterrupt = 0;
+}
+
+static void CheckAcquire(int side, TickType_t wait)
+{
+    uint8_t *region;
+    size_t length;
+
+    length = side == CHECK_WRITER ? xStreamBufferSendAcquire(checkBuffer, &region, wait)
+                                  : xStreamBufferReceiveAcquire(checkBuffer, &region, wait);
+    checkInAcquire = 0;
+    checkPending[side] = 0;
+
+    CheckAcquired(side, region, length);
+}
+
+static void CheckTaskAcquire(int side, TickType_t wait)
+{
+    checkCaller = xTaskGetCurrentTaskHandle();
+    checkInAcquire = 1;
+
+    if (setjmp(checkBlocked) == 0)
+    {
+        CheckAcquire(side, wait);
+    }
+    else
+    {
+        checkPending[side] = 1;
+        checkBlocks++;
+    }
+}
+
+static void CheckTaskStep(int side)
+{
+    checkBusy[side] = 1;
+
+    if (checkPending[side])
+    {
+        // Woken, the acquire finds what it waited for this time
+        CheckTaskAcquire(side, portMAX_DELAY);
+    }
+    else if (checkHeld[side] != 0)
+    {
+        CheckCommit(side, (size_t)rand() % (checkHeld[side] + 1), 0, NULL);
+    }
+    else if (rand() & 1)
+    {
+        CheckCopy(side, 0, NULL);
+    }
+    else
+    {
+        CheckTaskAcquire(side, (rand() & 1) ? portMAX_DELAY : 0);
+    }
+
+    checkBusy[side] = 0;
+}
+
+static void CheckInvariants(void)
+{
+    const StreamBuffer_t *buffer = checkBuffer;
+
+    if (xStreamBufferBytesAvailable(checkBuffer) != modelCount)
+    {
+        CheckFail("buffer holds a different number of bytes from the model");
+    }
+    if (xStreamBufferSpacesAvailable(checkBuffer) != checkSpace - modelCount)
+    {
+        CheckFail("buffer has a different amount of space from the model");
+    }
+
+    if (checkPending[CHECK_WRITER] && eTaskGetState(checkTasks[CHECK_WRITER]) == eBlocked &&
+        modelCount < checkSpace)
+    {
+        CheckFail("writer still blocked with space free");
+    }
+    if (checkPending[CHECK_READER] && eTaskGetState(checkTasks[CHECK_READER]) == eBlocked &&
+        modelCount >= checkTrigger)
+    {
+        CheckFail("reader still blocked with data at the trigger level");
+    }
+
+    if ((buffer->xTaskWaitingToSend != NULL && !checkPending[CHECK_WRITER]) ||
+        (buffer->xTaskWaitingToReceive != NULL && !checkPending[CHECK_READER]))
+    {
+        CheckFail("a task left waiting that is not blocked");
+    }
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    TaskHandle_t task;
+    unsigned i;
+
+    for (checkStep = 0; checkStep < CHECK_STEPS; checkStep++)
+    {
+        task = xTaskGetCurrentTaskHandle();
+        i = (task == xTaskGetIdleTaskHandle()) ? 0 : (unsigned)uxTaskGetTaskNumber(task);
+
+        if (i == 0 || rand() % 4 == 0)
+        {
+            CheckInterrupt(0);
+        }
+        else
+        {
+            CheckTaskStep((int)i);
+        }
+
+        CheckInvariants();
+    }
+
+    printf("length %u, trigger %u: %lu bytes, %lu split acquires, %lu blocks, %lu interrupts at a hook\n",
+           (unsigned)checkLength, (unsigned)checkTrigger, checkBytes, checkSplit, checkBlocks, checkAtHook);
+
+    exit(0);
+}
+
+static void CheckRun(unsigned seed, size_t length)
+{
+    int side;
+
+    srand(seed + (unsigned)length);
+    checkLength = length;
+    checkSpace = length - 1;
+    // A trigger level above the space would never be reached
+    checkTrigger = 1 + (size_t)rand() % checkSpace;
+
+    checkBuffer = xStreamBufferCreateStatic(length, checkTrigger, checkStorage, &checkBufferStatic);
+
+    for (side = CHECK_WRITER; side <= CHECK_READER; side++)
+    {
+        checkTasks[side] = xTaskCreateStatic(CheckTask, "Check", CHECK_STACK, NULL, 1 + rand() % 2,
+                                             checkStack[side], &checkTCB[side]);
+        vTaskSetTaskNumber(checkTasks[side], (UBaseType_t)side);
+    }
+
+    vTaskStartScheduler();
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 1U;
+    size_t length;
+    int status;
+    int failed = 0;
+    pid_t child;
+
+    for (length = 2; length <= CHECK_LENGTH_MAX; length++)
+    {
+        fflush(stdout);
+        child = fork();
+        if (child == 0)
+        {
+            CheckRun(seed, length);
+            return 2;
+        }
+
+        if (child < 0 || waitpid(child, &status, 0) != child ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            failed = 1;
+        }
+    }
+
+    printf(failed ? "FAILED\n" : "passed\n");
+
+    return failed;
+}
@@ -0,0 +1,429 @@
+/*
+ * File:   timerbench.c
+ *
+ * Host check and benchmark of the software timer lists, the two sorted
+ * lists against the timing wheel (configUSE_TIMER_WHEEL). It includes the
+ * real timers.c, to reach the timer service task's static functions, and
+ * stands in for the queue and task calls it makes. The harness plays the
+ * timer service task: whenever a command is waiting or the task's block
+ * time is up, it runs the task's loop body until the task would block again.
+ *
+ * Build and run on Linux, once per backend:
+ *   gcc -O2 -DconfigUSE_TIMERS=1 -I tools/delaybench -I FreeRTOS/include -I FreeRTOS \
+ *       -o timerbench-list tools/timerbench/timerbench.c FreeRTOS/list.c
+ *   gcc -O2 -DconfigUSE_TIMERS=1 -DconfigUSE_TIMER_WHEEL=1 -I tools/delaybench \
+ *       -I FreeRTOS/include -I FreeRTOS -o timerbench-wheel \
+ *       tools/timerbench/timerbench.c FreeRTOS/list.c
+ *   ./timerbench-list -c list.log
+ *   ./timerbench-wheel -c wheel.log
+ *   sort list.log > list.txt; sort wheel.log > wheel.txt; cmp list.txt wheel.txt
+ *   ./timerbench-list
+ *   ./timerbench-wheel
+ *
+ * With -c <file>, 60 timers get a random stream of start, reset, stop and
+ * change period commands over BENCH_CHECK_TICKS, enough for the 16-bit tick
+ * count to wrap several times, and every callback is logged with the tick
+ * it ran on. Both backends must run the same callbacks on the same ticks;
+ * only timers due on the same tick may run in another order, so the logs are
+ * compared sorted. -s starves the timer task now and then, so it runs late
+ * and finds timers already expired, and -r <seed> picks another stream. Add
+ * -DconfigTIMER_WHEEL_BITS=<n> to check the wheel with other slot counts.
+ *
+ * Without -c, 10 to 1000 running timers are reset at random and the time the
+ * timer task takes to handle each reset is printed.
+ */
+
+#include "timers.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#define BENCH_CHECK_TIMERS  60
+#define BENCH_CHECK_TICKS   300000UL
+#define BENCH_TIMERS_MAX    1000
+#define BENCH_RESETS        20000
+#define BENCH_QUEUE         4096
+
+// Current tick, kept wide so the harness can tell when a block time is up
+static uint64_t benchTick;
+
+// Commands sent and not yet seen by the timer task, then the ones it can
+// receive. A command only reaches the task on its next pass, as with a
+// real queue the task had already found empty
+static DaemonTaskMessage_t sentMessages[BENCH_QUEUE];
+static unsigned sentCount;
+static DaemonTaskMessage_t queueMessages[BENCH_QUEUE];
+static unsigned queueHead;
+static unsigned queueTail;
+static StaticQueue_t queueBuffer;
+
+// How the timer task last blocked
+static int taskBlocked;
+static int taskBlockForever;
+static TickType_t taskBlockTicks;
+
+static StaticTimer_t benchTimerBuffers[BENCH_TIMERS_MAX];
+static TimerHandle_t benchTimers[BENCH_TIMERS_MAX];
+static FILE *checkLog;
+static unsigned long checkCallbacks;
+
+// Kernel calls timers.c makes. The scheduler is taken to be running and
+// nothing ever waits but the timer task
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)benchTick;
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return taskSCHEDULER_RUNNING;
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdTRUE;
+}
+
+void vPortYield(void)
+{
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char * const pcName,
+                               const configSTACK_DEPTH_TYPE uxStackDepth, void * const pvParameters,
+                               UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                               StaticTask_t * const pxTaskBuffer)
+{
+    (void)pxTaskCode;
+    (void)pcName;
+    (void)uxStackDepth;
+    (void)pvParameters;
+    (void)uxPriority;
+    (void)puxStackBuffer;
+
+    return (TaskHandle_t)pxTaskBuffer;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE *puxTimerTaskStackSize)
+{
+    static StaticTask_t timerTCB;
+    static StackType_t timerStack[configTIMER_TASK_STACK_DEPTH];
+
+    *ppxTimerTaskTCBBuffer = &timerTCB;
+    *ppxTimerTaskStackBuffer = timerStack;
+    *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+QueueHandle_t xQueueGenericCreateStatic(const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize,
+                                        uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue,
+                                        const uint8_t ucQueueType)
+{
+    (void)uxQueueLength;
+    (void)uxItemSize;
+    (void)pucQueueStorage;
+    (void)pxStaticQueue;
+    (void)ucQueueType;
+
+    return (QueueHandle_t)&queueBuffer;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void * const pvItemToQueue,
+                             TickType_t xTicksToWait, const BaseType_t xCopyPosition)
+{
+    (void)xQueue;
+    (void)xTicksToWait;
+    (void)xCopyPosition;
+
+    if (sentCount >= BENCH_QUEUE)
+    {
+        printf("command queue full\n");
+        exit(3);
+    }
+    memcpy(&sentMessages[sentCount++], pvItemToQueue, sizeof(DaemonTaskMessage_t));
+
+    return pdPASS;
+}
+
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void * const pvItemToQueue,
+                                    BaseType_t * const pxHigherPriorityTaskWoken,
+                                    const BaseType_t xCopyPosition)
+{
+    (void)pxHigherPriorityTaskWoken;
+
+    return xQueueGenericSend(xQueue, pvItemToQueue, 0, xCopyPosition);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait)
+{
+    (void)xQueue;
+    (void)xTicksToWait;
+
+    if (queueHead == queueTail)
+    {
+        return pdFAIL;
+    }
+    memcpy(pvBuffer, &queueMessages[queueHead++ % BENCH_QUEUE], sizeof(DaemonTaskMessage_t));
+
+    return pdPASS;
+}
+
+void vQueueWaitForMessageRestricted(QueueHandle_t xQueue, TickType_t xTicksToWait,
+                                    const BaseType_t xWaitIndefinitely)
+{
+    (void)xQueue;
+
+    taskBlocked = 1;
+    taskBlockTicks = xTicksToWait;
+    taskBlockForever = xWaitIndefinitely;
+}
+
+static void BenchDeliver(void)
+{
+    unsigned i;
+
+    for (i = 0; i < sentCount; i++)
+    {
+        memcpy(&queueMessages[queueTail++ % BENCH_QUEUE], &sentMessages[i], sizeof(DaemonTaskMessage_t));
+    }
+    sentCount = 0;
+}
+
+// One pass of the timer task's loop, see prvTimerTask(). Returns non-zero
+// once the task has blocked with nothing left to receive
+static int BenchTimerTaskPass(void)
+{
+    BaseType_t listWasEmpty;
+    TickType_t nextExpireTime;
+    unsigned waiting;
+
+    taskBlocked = 0;
+    nextExpireTime = prvGetNextExpireTime(&listWasEmpty);
+    waiting = queueTail - queueHead;
+    prvProcessTimerOrBlockTask(nextExpireTime, listWasEmpty);
+    prvProcessReceivedCommands();
+
+    return taskBlocked && waiting == 0;
+}
+
+// Runs the timer task until it blocks, first on the commands it already
+// has, then on those sent since. Returns the tick it next has to run on
+static uint64_t BenchTimerTaskRun(void)
+{
+    unsigned long passes;
+    int phase;
+
+    for (phase = 0; phase < 2; phase++)
+    {
+        if (phase == 1)
+        {
+            BenchDeliver();
+        }
+
+        for (passes = 0; !BenchTimerTaskPass(); passes++)
+        {
+            if (passes > 100000)
+            {
+                printf("timer task spins at tick %llu\n", (unsigned long long)benchTick);
+                exit(4);
+            }
+        }
+    }
+
+    return taskBlockForever ? UINT64_MAX : benchTick + taskBlockTicks;
+}
+
+static void CheckCallback(TimerHandle_t timer)
+{
+    fprintf(checkLog, "%llu %ld\n", (unsigned long long)benchTick, (long)(intptr_t)pvTimerGetTimerID(timer));
+    checkCallbacks++;
+}
+
+// Mostly short periods, some up to a few seconds and a few near the longest
+static TickType_t CheckPeriod(void)
+{
+    int r = rand() % 100;
+
+    if (r < 60)
+    {
+        return (TickType_t)(1 + rand() % 40);
+    }
+    if (r < 90)
+    {
+        return (TickType_t)(1 + rand() % 3000);
+    }
+    return (TickType_t)(1 + rand() % 65000);
+}
+
+static void CheckRun(unsigned seed, int starve)
+{
+    uint64_t wake = 0;
+    uint64_t starvedUntil = 0;
+    unsigned long ticks;
+    int commands;
+    int id;
+    int i;
+
+    srand(seed);
+    benchTick = (uint64_t)(rand() % 70000);
+    for (i = 0; i < BENCH_CHECK_TIMERS; i++)
+    {
+        benchTimers[i] = xTimerCreateStatic("check", CheckPeriod(), (UBaseType_t)(rand() & 1),
+                                            (void *)(intptr_t)i, CheckCallback, &benchTimerBuffers[i]);
+    }
+    (void)xTimerCreateTimerTask();
+
+    for (ticks = 0; ticks < BENCH_CHECK_TICKS; ticks++)
+    {
+        // A burst of commands from the application now and then
+        if (rand() % 8 == 0)
+        {
+            for (commands = 1 + rand() % 4; commands > 0; commands--)
+            {
+                id = rand() % BENCH_CHECK_TIMERS;
+                switch (rand() % 5)
+                {
+                    case 0:
+                    case 1:
+                        (void)xTimerStart(benchTimers[id], 0);
+                        break;
+                    case 2:
+                        (void)xTimerReset(benchTimers[id], 0);
+                        break;
+                    case 3:
+                        (void)xTimerStop(benchTimers[id], 0);
+                        break;
+                    default:
+                        (void)xTimerChangePeriod(benchTimers[id], CheckPeriod(), 0);
+                        break;
+                }
+            }
+        }
+
+        // Higher priority work keeps the timer task from running for a while
+        if (starve && rand() % 3000 == 0)
+        {
+            starvedUntil = benchTick + (uint64_t)(rand() % 500);
+        }
+
+        if (benchTick >= starvedUntil && (sentCount != 0 || benchTick >= wake))
+        {
+            wake = BenchTimerTaskRun();
+        }
+
+        benchTick++;
+    }
+
+    printf("seed %u: %lu callbacks\n", seed, checkCallbacks);
+}
+
+static uint64_t BenchNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void BenchCallback(TimerHandle_t timer)
+{
+    (void)timer;
+}
+
+// Time the timer task takes to handle one reset with count timers running
+static void BenchRun(unsigned count)
+{
+    uint64_t total = 0;
+    uint64_t start;
+    unsigned i;
+    unsigned k;
+
+    srand(1);
+    benchTick = 100;
+    for (i = 0; i < count; i++)
+    {
+        benchTimers[i] = xTimerCreateStatic("bench", (TickType_t)(1000 + rand() % 30000), pdTRUE,
+                                            NULL, BenchCallback, &benchTimerBuffers[i]);
+        (void)xTimerStart(benchTimers[i], 0);
+    }
+    (void)BenchTimerTaskRun();
+
+    for (i = 0; i < BENCH_RESETS; i++)
+    {
+        k = (unsigned)rand() % count;
+        (void)xTimerReset(benchTimers[k], 0);
+        start = BenchNowNs();
+        (void)BenchTimerTaskRun();
+        total += BenchNowNs() - start;
+
+        if (i % 10 == 0)
+        {
+            benchTick++;
+        }
+    }
+
+    // Off the lists again before the next run makes them afresh
+    for (i = 0; i < count; i++)
+    {
+        (void)xTimerStop(benchTimers[i], 0);
+    }
+    (void)BenchTimerTaskRun();
+
+    printf("%4u timers: %6.0f ns per reset\n", count, (double)total / BENCH_RESETS);
+}
+
+int main(int argc, char **argv)
+{
+    static const unsigned counts[] = { 10, 100, 500, BENCH_TIMERS_MAX };
+    const char *logName = NULL;
+    unsigned seed = 1;
+    int starve = 0;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            logName = argv[++i];
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            starve = 1;
+        }
+        else
+        {
+            printf("usage: %s [-c log [-r seed] [-s]]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (logName != NULL)
+    {
+        checkLog = fopen(logName, "w");
+        if (checkLog == NULL)
+        {
+            perror(logName);
+            return 2;
+        }
+        CheckRun(seed, starve);
+        fclose(checkLog);
+        return 0;
+    }
+
+    for (i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+    {
+        BenchRun(counts[i]);
+    }
+
+    return 0;
+}
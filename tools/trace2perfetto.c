@@ -0,0 +1,345 @@
+/*
+ * File:   trace2perfetto.c
+ *
+ * Host tool, converts trace recorder dumps captured from UART2 (see trace.h
+ * and trace.c) into Chrome trace event JSON, which opens in Perfetto
+ * (ui.perfetto.dev) and chrome://tracing.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -o trace2perfetto tools/trace2perfetto.c
+ *   ./trace2perfetto uart.log > trace.json
+ *
+ * The log may hold other console output and several dumps, each dump
+ * becomes its own process in the trace. Task run slices go on a "CPU"
+ * track, interrupt handlers on an "ISR" track, and delays, wake ups and
+ * queue operations are instant events on the track of the task that was
+ * running (or the ISR track when inside a handler).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+// Must match trace.h
+#define TRACE_EVT_SWITCH_IN         1
+#define TRACE_EVT_READY             2
+#define TRACE_EVT_DELAY             3
+#define TRACE_EVT_DELAY_UNTIL       4
+#define TRACE_EVT_QUEUE_SEND        5
+#define TRACE_EVT_QUEUE_SEND_FAILED 6
+#define TRACE_EVT_QUEUE_RECEIVE     7
+#define TRACE_EVT_QUEUE_RECEIVE_FAILED 8
+#define TRACE_EVT_QUEUE_BLOCK_SEND  9
+#define TRACE_EVT_QUEUE_BLOCK_RECEIVE 10
+#define TRACE_EVT_QUEUE_SEND_ISR    11
+#define TRACE_EVT_QUEUE_RECEIVE_ISR 12
+#define TRACE_EVT_ISR_ENTER         13
+#define TRACE_EVT_ISR_EXIT          14
+#define TRACE_EVT_MUTEX_TAKE        15
+#define TRACE_EVT_MUTEX_TAKE_FAILED 16
+#define TRACE_EVT_MUTEX_BLOCK       17
+#define TRACE_EVT_MUTEX_GIVE        18
+#define TRACE_EVT_PRIORITY_INHERIT  19
+#define TRACE_EVT_PRIORITY_DISINHERIT 20
+
+#define MAX_NAMES   256
+#define NAME_LEN    32
+
+#define TID_CPU     1
+#define TID_ISR     2
+// Task n is on track TID_TASK + n
+#define TID_TASK    10
+
+typedef struct
+{
+    char tasks[MAX_NAMES][NAME_LEN];
+    char queues[MAX_NAMES][NAME_LEN];
+    char isrs[MAX_NAMES][NAME_LEN];
+    unsigned long countsPerSecond;
+    int pid;
+
+    // Track names are written before the first event
+    int haveMetadata;
+
+    // Unwrapped time of the previous event
+    int haveTime;
+    uint16_t lastRaw;
+    uint64_t now;
+
+    // Task on the CPU and when it was switched in
+    int running;
+    uint64_t runningSince;
+    // Depth of nested interrupt handlers
+    int isrDepth;
+} Dump_t;
+
+static int firstEvent = 1;
+
+static void Emit(const char *fmt, ...)
+{
+    va_list ap;
+
+    printf(firstEvent ? "\n  " : ",\n  ");
+    firstEvent = 0;
+
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+static double Micros(const Dump_t *d, uint64_t counts)
+{
+    return (double) counts * 1e6 / (double) d->countsPerSecond;
+}
+
+static const char *Name(char names[][NAME_LEN], unsigned n, const char *kind, char *buf)
+{
+    if (n < MAX_NAMES && names[n][0] != '\0')
+    {
+        return names[n];
+    }
+    snprintf(buf, NAME_LEN, "%s %u", kind, n);
+    return buf;
+}
+
+static void EndRunSlice(Dump_t *d)
+{
+    char buf[NAME_LEN];
+
+    if (d->running < 0)
+    {
+        return;
+    }
+
+    Emit("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+         Name(d->tasks, d->running, "task", buf), d->pid, TID_CPU,
+         Micros(d, d->runningSince), Micros(d, d->now - d->runningSince));
+}
+
+static void Instant(Dump_t *d, const char *what, unsigned queue)
+{
+    char buf[NAME_LEN];
+    int tid = (d->isrDepth > 0 || d->running < 0) ? TID_ISR : TID_TASK + d->running;
+
+    Emit("{\"name\":\"%s %s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+         what, Name(d->queues, queue, "queue", buf), d->pid, tid, Micros(d, d->now));
+}
+
+static void Event(Dump_t *d, unsigned raw, unsigned type, unsigned arg)
+{
+    char buf[NAME_LEN];
+
+    // Timestamps are 16 bits, every gap is taken to be shorter than one wrap
+    if (d->haveTime)
+    {
+        d->now += (uint16_t) (raw - d->lastRaw);
+    }
+    d->haveTime = 1;
+    d->lastRaw = (uint16_t) raw;
+
+    switch (type)
+    {
+        case TRACE_EVT_SWITCH_IN:
+            EndRunSlice(d);
+            d->running = (int) arg;
+            d->runningSince = d->now;
+            break;
+
+        case TRACE_EVT_READY:
+            Emit("{\"name\":\"ready\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+                 d->pid, TID_TASK + arg, Micros(d, d->now));
+            break;
+
+        case TRACE_EVT_DELAY:
+        case TRACE_EVT_DELAY_UNTIL:
+            Emit("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+                 type == TRACE_EVT_DELAY ? "vTaskDelay" : "xTaskDelayUntil",
+                 d->pid, TID_TASK + arg, Micros(d, d->now));
+            break;
+
+        case TRACE_EVT_QUEUE_SEND:          Instant(d, "send", arg); break;
+        case TRACE_EVT_QUEUE_SEND_FAILED:   Instant(d, "send failed", arg); break;
+        case TRACE_EVT_QUEUE_RECEIVE:       Instant(d, "receive", arg); break;
+        case TRACE_EVT_QUEUE_RECEIVE_FAILED: Instant(d, "receive failed", arg); break;
+        case TRACE_EVT_QUEUE_BLOCK_SEND:    Instant(d, "block on send", arg); break;
+        case TRACE_EVT_QUEUE_BLOCK_RECEIVE: Instant(d, "block on receive", arg); break;
+        case TRACE_EVT_QUEUE_SEND_ISR:      Instant(d, "send from ISR", arg); break;
+        case TRACE_EVT_QUEUE_RECEIVE_ISR:   Instant(d, "receive from ISR", arg); break;
+        case TRACE_EVT_MUTEX_TAKE:          Instant(d, "take", arg); break;
+        case TRACE_EVT_MUTEX_TAKE_FAILED:   Instant(d, "take failed", arg); break;
+        case TRACE_EVT_MUTEX_BLOCK:         Instant(d, "block on take", arg); break;
+        case TRACE_EVT_MUTEX_GIVE:          Instant(d, "give", arg); break;
+
+        // On the holder's track
+        case TRACE_EVT_PRIORITY_INHERIT:
+        case TRACE_EVT_PRIORITY_DISINHERIT:
+            Emit("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+                 type == TRACE_EVT_PRIORITY_INHERIT ? "inherit priority" : "disinherit priority",
+                 d->pid, TID_TASK + arg, Micros(d, d->now));
+            break;
+
+        case TRACE_EVT_ISR_ENTER:
+            d->isrDepth++;
+            Emit("{\"name\":\"%s\",\"ph\":\"B\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+                 Name(d->isrs, arg, "isr", buf), d->pid, TID_ISR, Micros(d, d->now));
+            break;
+
+        case TRACE_EVT_ISR_EXIT:
+            // The buffer may start inside a handler, drop unmatched exits
+            if (d->isrDepth > 0)
+            {
+                d->isrDepth--;
+                Emit("{\"ph\":\"E\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+                     d->pid, TID_ISR, Micros(d, d->now));
+            }
+            break;
+
+        default:
+            fprintf(stderr, "unknown event type %u\n", type);
+            break;
+    }
+}
+
+static void Metadata(const Dump_t *d)
+{
+    unsigned i;
+
+    Emit("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"dump %d\"}}",
+         d->pid, d->pid);
+    Emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"CPU\"}}",
+         d->pid, TID_CPU);
+    Emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"ISR\"}}",
+         d->pid, TID_ISR);
+
+    for (i = 0; i < MAX_NAMES; i++)
+    {
+        if (d->tasks[i][0] != '\0')
+        {
+            Emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                 d->pid, TID_TASK + i, d->tasks[i]);
+        }
+    }
+}
+
+static void SetName(char names[][NAME_LEN], const char *line)
+{
+    unsigned n;
+    char name[NAME_LEN];
+
+    if (line[1] != ' ')
+    {
+        return;
+    }
+
+    if (sscanf(line + 2, "%u %31s", &n, name) == 2 && n < MAX_NAMES)
+    {
+        strcpy(names[n], name);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    char line[256];
+    static Dump_t dump;
+    int inDump = 0;
+    int dumps = 0;
+    unsigned long events;
+    unsigned raw, type, arg;
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: %s [uart log]\n", argv[0]);
+        return 2;
+    }
+
+    if (argc == 2 && (in = fopen(argv[1], "r")) == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        // The console ends lines with \n\r, so the \r starts the next line
+        char *p = line;
+        while (*p == '\r' || *p == '\n')
+        {
+            p++;
+        }
+        p[strcspn(p, "\r\n")] = '\0';
+
+        if (!inDump)
+        {
+            if (sscanf(p, "[TRACE] begin %lu %lu", &events, &dump.countsPerSecond) == 2)
+            {
+                memset(dump.tasks, 0, sizeof(dump.tasks));
+                memset(dump.queues, 0, sizeof(dump.queues));
+                memset(dump.isrs, 0, sizeof(dump.isrs));
+                dump.pid = ++dumps;
+                dump.haveMetadata = 0;
+                dump.haveTime = 0;
+                dump.now = 0;
+                dump.running = -1;
+                dump.isrDepth = 0;
+                if (dump.countsPerSecond == 0)
+                {
+                    dump.countsPerSecond = 1;
+                }
+                inDump = 1;
+            }
+            continue;
+        }
+
+        switch (p[0])
+        {
+            case 'T': SetName(dump.tasks, p); break;
+            case 'Q': SetName(dump.queues, p); break;
+            case 'I': SetName(dump.isrs, p); break;
+
+            case 'E':
+                if (!dump.haveMetadata)
+                {
+                    // All names come before the first event
+                    Metadata(&dump);
+                    dump.haveMetadata = 1;
+                }
+                if (sscanf(p, "E %x %x %x", &raw, &type, &arg) == 3)
+                {
+                    Event(&dump, raw, type, arg);
+                }
+                break;
+
+            case '[':
+                if (strncmp(p, "[TRACE] end", 11) == 0)
+                {
+                    EndRunSlice(&dump);
+                    inDump = 0;
+                }
+                break;
+
+            default:
+                // FSM output printed in between lines of the dump
+                break;
+        }
+    }
+
+    printf("\n]}\n");
+
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+
+    if (dumps == 0)
+    {
+        fprintf(stderr, "no [TRACE] dump found\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * File:   wheelcheck.c
+ *
+ * Host check of the multitimer's timing wheel (wheel.c) against a brute
+ * force model: a flat array of timers with their deadlines, searched in full
+ * on every call.
+ *
+ * Build and run on Linux:
+ *   gcc -O2 -I . -o wheelcheck tools/wheelcheck/wheelcheck.c wheel.c
+ *   ./wheelcheck [seed]
+ *
+ * CHECK_TIMERS timers are inserted, removed and left to expire at random,
+ * with deadlines from a few turns in the past to far ahead. Time moves on as
+ * the multitimer task moves it, to the deadline WheelNextDeadline() gives,
+ * or by a random jump, now and then a long one, so the 32-bit tick count
+ * wraps many times over the run. After every move the wheel is drained with
+ * WheelExpire(), which must return only timers that are running and due,
+ * and must leave none that are due. WheelNextDeadline() must give the
+ * earliest deadline when it falls within the turn from the cursor, and the
+ * end of that turn otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "wheel.h"
+
+#define CHECK_TIMERS    64
+#define CHECK_STEPS     2000000UL
+
+static Wheel_t wheel;
+static WheelTimer_t timers[CHECK_TIMERS];
+
+// The model: which timers are on the wheel, and when they are due
+static uint8_t modelRunning[CHECK_TIMERS];
+static uint32_t modelDeadline[CHECK_TIMERS];
+static unsigned modelCount;
+
+static uint32_t now;
+static unsigned long checkStep;
+static unsigned long checkExpired;
+static unsigned long checkLate;
+static unsigned long checkWraps;
+
+static void CheckFail(const char *what)
+{
+    printf("step %lu, now 0x%08lx: %s\n", checkStep, (unsigned long)now, what);
+    exit(1);
+}
+
+static uint32_t CheckRandom(uint32_t range)
+{
+    uint32_t value = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+
+    return range != 0 ? value % range : value;
+}
+
+static uint32_t CheckDeadline(void)
+{
+    switch (rand() % 8)
+    {
+        case 0:
+            // Already due, up to a few turns ago
+            return now - CheckRandom(3 * WHEEL_TURN_TICKS);
+
+        case 1:
+            // Far ahead, many turns away
+            return now + CheckRandom(1UL << 24);
+
+        case 2:
+            return now;
+
+        default:
+            return now + CheckRandom(2 * WHEEL_TURN_TICKS);
+    }
+}
+
+static void CheckInsert(void)
+{
+    unsigned i = (unsigned)rand() % CHECK_TIMERS;
+
+    if (modelRunning[i])
+    {
+        return;
+    }
+
+    modelDeadline[i] = CheckDeadline();
+    modelRunning[i] = 1;
+    modelCount++;
+    WheelInsert(&wheel, &timers[i], modelDeadline[i]);
+}
+
+static void CheckRemove(void)
+{
+    unsigned i = (unsigned)rand() % CHECK_TIMERS;
+
+    if (!modelRunning[i])
+    {
+        return;
+    }
+
+    modelRunning[i] = 0;
+    modelCount--;
+    WheelRemove(&wheel, &timers[i]);
+}
+
+static void CheckExpire(void)
+{
+    WheelTimer_t *timer;
+    unsigned i;
+
+    while ((timer = WheelExpire(&wheel, now)) != NULL)
+    {
+        i = (unsigned)(timer - timers);
+        if (i >= CHECK_TIMERS || !modelRunning[i])
+        {
+            CheckFail("expired a timer that is not running");
+        }
+        if ((int32_t)(modelDeadline[i] - now) > 0)
+        {
+            CheckFail("expired a timer before its deadline");
+        }
+        if (timer->deadline != modelDeadline[i])
+        {
+            CheckFail("expired timer has the wrong deadline");
+        }
+
+        if (modelDeadline[i] != now)
+        {
+            checkLate++;
+        }
+        modelRunning[i] = 0;
+        modelCount--;
+        checkExpired++;
+    }
+
+    for (i = 0; i < CHECK_TIMERS; i++)
+    {
+        if (modelRunning[i] && (int32_t)(modelDeadline[i] - now) <= 0)
+        {
+            CheckFail("a due timer was left on the wheel");
+        }
+    }
+}
+
+static void CheckNextDeadline(void)
+{
+    uint32_t deadline;
+    uint32_t earliest = 0;
+    uint32_t turnEnd = (wheel.cursor + WHEEL_SLOTS) << WHEEL_SHIFT;
+    uint8_t found = 0;
+    unsigned i;
+
+    if (wheel.count != modelCount)
+    {
+        CheckFail("wheel count differs from the timers running");
+    }
+
+    if (!WheelNextDeadline(&wheel, &deadline))
+    {
+        if (modelCount != 0)
+        {
+            CheckFail("no deadline with timers running");
+        }
+        return;
+    }
+    if (modelCount == 0)
+    {
+        CheckFail("a deadline with no timers running");
+    }
+
+    for (i = 0; i < CHECK_TIMERS; i++)
+    {
+        if (modelRunning[i] && (!found || (int32_t)(modelDeadline[i] - earliest) < 0))
+        {
+            earliest = modelDeadline[i];
+            found = 1;
+        }
+    }
+
+    if ((int32_t)(earliest - turnEnd) < 0 ? deadline != earliest : deadline != turnEnd)
+    {
+        CheckFail("wrong next deadline");
+    }
+}
+
+static void CheckAdvance(void)
+{
+    uint32_t deadline;
+    uint32_t before = now;
+
+    switch (rand() % 8)
+    {
+        case 0:
+            // A long sleep, or a task held off for a while
+            now += CheckRandom(1UL << 24);
+            break;
+
+        case 1:
+        case 2:
+            // Woken on time, as the multitimer task is
+            if (WheelNextDeadline(&wheel, &deadline) && (int32_t)(deadline - now) > 0)
+            {
+                now = deadline;
+            }
+            break;
+
+        default:
+            now += CheckRandom(WHEEL_TURN_TICKS / 4);
+            break;
+    }
+
+    if (now < before)
+    {
+        checkWraps++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    srand(argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 1U);
+
+    // Start just short of the wrap
+    now = 0xFFFFFFFFUL - CheckRandom(4 * WHEEL_TURN_TICKS);
+    WheelInit(&wheel, now);
+
+    for (checkStep = 0; checkStep < CHECK_STEPS; checkStep++)
+    {
+        switch (rand() % 4)
+        {
+            case 0:
+            case 1:
+                CheckInsert();
+                break;
+
+            case 2:
+                CheckRemove();
+                break;
+
+            default:
+                CheckAdvance();
+                CheckExpire();
+                break;
+        }
+
+        CheckNextDeadline();
+    }
+
+    printf("%lu steps: %lu timers expired, %lu of them late, %lu wraps\n",
+           checkStep, checkExpired, checkLate, checkWraps);
+
+    return 0;
+}
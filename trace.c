@@ -0,0 +1,195 @@
+/*
+ * File:   trace.c
+ *
+ * Snapshot trace recorder. TraceRecord() takes the next slot of the ring
+ * buffer with the API interrupts masked, so events from tasks and from the
+ * interrupts at or below configMAX_SYSCALL_INTERRUPT_PRIORITY are kept in
+ * time order. Older events are overwritten once the buffer is full.
+ *
+ * Dump format, one line each:
+ *   [TRACE] begin <events> <counts per second>
+ *   T <number> <name>          task names
+ *   Q <number> <name>          queue and fast mutex names
+ *   I <id> <name>              interrupt names
+ *   E <time> <type> <arg>      events oldest first, in hex
+ *   [TRACE] end
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "fast_mutex.h"
+#include "uart.h"
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+#if (TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS - 1)) != 0
+#error TRACE_BUFFER_EVENTS must be a power of 2
+#endif
+
+// Uart mutex from main.c
+extern FastMutexHandle_t uart_sem;
+
+static TraceEvent_t traceBuffer[TRACE_BUFFER_EVENTS];
+// Next slot to write and how many slots hold an event
+static uint16_t traceHead = 0;
+static uint16_t traceCount = 0;
+// Cleared while a dump is printing
+static volatile uint8_t traceRunning = 1;
+
+static const char *taskNames[TRACE_MAX_NAMES];
+static const char *queueNames[TRACE_MAX_NAMES];
+static uint8_t queueNumber = 0;
+
+// Indexed by the TRACE_ISR_ ids
+static const char * const isrNames[] = { "", "tick", "T2", "U2RX", "U2TX", "RTCC", "IOC" };
+
+void TraceRecord(uint8_t type, uint8_t arg)
+{
+    TraceEvent_t *event;
+    UBaseType_t savedIPL;
+
+    savedIPL = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    // Checked with the interrupts masked so a dump never sees a task that
+    // was preempted half way through recording
+    if (!traceRunning)
+    {
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(savedIPL);
+        return;
+    }
+
+    event = &traceBuffer[traceHead];
+    event->time = TRACE_NOW();
+    event->type = type;
+    event->arg = arg;
+
+    traceHead = (traceHead + 1) & (TRACE_BUFFER_EVENTS - 1);
+    if (traceCount < TRACE_BUFFER_EVENTS)
+    {
+        traceCount++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(savedIPL);
+}
+
+void TraceNameTask(uint8_t number, const char *name)
+{
+    if (number < TRACE_MAX_NAMES)
+    {
+        taskNames[number] = name;
+    }
+}
+
+void TraceNameQueue(void *queue, const char *name)
+{
+    // Queue number 0 is left for queues without a name
+    if (queueNumber + 1 < TRACE_MAX_NAMES)
+    {
+        queueNumber++;
+        vQueueSetQueueNumber((QueueHandle_t) queue, queueNumber);
+        queueNames[queueNumber] = name;
+    }
+}
+
+void TraceNameFastMutex(void *mutex, const char *name)
+{
+    if (queueNumber + 1 < TRACE_MAX_NAMES)
+    {
+        queueNumber++;
+        vFastMutexSetMutexNumber((FastMutexHandle_t) mutex, queueNumber);
+        queueNames[queueNumber] = name;
+    }
+}
+
+static void TracePrintHex(uint16_t val, uint8_t digits)
+{
+    while (digits != 0)
+    {
+        digits--;
+        XmitUART2("0123456789abcdef"[(val >> (digits * 4)) & 0xF], 1);
+    }
+}
+
+static void TraceLineStart(void)
+{
+    xFastMutexTake(uart_sem, portMAX_DELAY);
+}
+
+static void TraceLineEnd(void)
+{
+    Disp2String("\n\r");
+    xFastMutexGive(uart_sem);
+}
+
+static void TracePrintNames(char kind, const char * const *names, uint8_t count)
+{
+    uint8_t i;
+
+    for (i = 1; i < count; i++)
+    {
+        if (names[i] != NULL)
+        {
+            TraceLineStart();
+            XmitUART2(kind, 1);
+            XmitUART2(' ', 1);
+            Disp2Dec(i);
+            XmitUART2(' ', 1);
+            Disp2String((char *) names[i]);
+            TraceLineEnd();
+        }
+    }
+}
+
+void TraceDump(void)
+{
+    uint16_t count;
+    uint16_t index;
+    const TraceEvent_t *event;
+
+    // Nothing records while the buffer prints
+    traceRunning = 0;
+
+    count = traceCount;
+    index = (traceHead - count) & (TRACE_BUFFER_EVENTS - 1);
+
+    TraceLineStart();
+    Disp2String("\n\r[TRACE] begin ");
+    Disp2Dec(count);
+    XmitUART2(' ', 1);
+    Disp2Dec(TRACE_COUNTS_PER_SECOND);
+    TraceLineEnd();
+
+    TracePrintNames('T', taskNames, TRACE_MAX_NAMES);
+    TracePrintNames('Q', queueNames, TRACE_MAX_NAMES);
+    TracePrintNames('I', isrNames, sizeof(isrNames) / sizeof(isrNames[0]));
+
+    while (count != 0)
+    {
+        event = &traceBuffer[index];
+
+        TraceLineStart();
+        Disp2String("E ");
+        TracePrintHex(event->time, 4);
+        XmitUART2(' ', 1);
+        TracePrintHex(event->type, 2);
+        XmitUART2(' ', 1);
+        TracePrintHex(event->arg, 2);
+        TraceLineEnd();
+
+        index = (index + 1) & (TRACE_BUFFER_EVENTS - 1);
+        count--;
+    }
+
+    TraceLineStart();
+    Disp2String("[TRACE] end");
+    TraceLineEnd();
+
+    // Start a new snapshot
+    traceHead = 0;
+    traceCount = 0;
+    traceRunning = 1;
+}
+
+#endif
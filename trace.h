@@ -0,0 +1,108 @@
+/*
+ * File:   trace.h
+ *
+ * Snapshot trace recorder. The kernel trace macros and the interrupt
+ * handlers record small timestamped events into a RAM ring buffer, which
+ * keeps the most recent TRACE_BUFFER_EVENTS events. The console 't' command
+ * stops recording, dumps the buffer over UART2 as text and starts again.
+ * tools/trace2perfetto.c turns a dump into Chrome/Perfetto trace JSON.
+ *
+ * This header is also included by FreeRTOSConfig.h for the trace macros,
+ * so it must not include any FreeRTOS headers.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <xc.h>
+
+// Set to 0 to leave the recorder out of the build
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+// Set to 1 to record the Timer 2 PWM interrupt as well. At 1 kHz it adds 2000
+// events a second, which would leave a dump only a quarter of a second long
+// and hardly any of it scheduling
+#ifndef TRACE_T2_ENABLE
+#define TRACE_T2_ENABLE 0
+#endif
+
+// Events kept, a power of 2. Each event is 4 bytes
+#define TRACE_BUFFER_EVENTS 512
+
+// Timestamps are the low half of the run time counter, Fcy/64. A dump is
+// unwrapped on the host, which needs an event at least every 1.05 s; the
+// tick interrupt makes sure of that, tickless idle never skips more than a
+// few tens of ticks
+#define TRACE_NOW() (CCP4TMRL)
+#define TRACE_COUNTS_PER_SECOND 62500UL
+
+// Longest task, queue or interrupt name table
+#define TRACE_MAX_NAMES 12
+
+// Event types, arg is a task number, queue number or interrupt id
+#define TRACE_EVT_SWITCH_IN         1
+#define TRACE_EVT_READY             2
+#define TRACE_EVT_DELAY             3
+#define TRACE_EVT_DELAY_UNTIL       4
+#define TRACE_EVT_QUEUE_SEND        5
+#define TRACE_EVT_QUEUE_SEND_FAILED 6
+#define TRACE_EVT_QUEUE_RECEIVE     7
+#define TRACE_EVT_QUEUE_RECEIVE_FAILED 8
+#define TRACE_EVT_QUEUE_BLOCK_SEND  9
+#define TRACE_EVT_QUEUE_BLOCK_RECEIVE 10
+#define TRACE_EVT_QUEUE_SEND_ISR    11
+#define TRACE_EVT_QUEUE_RECEIVE_ISR 12
+#define TRACE_EVT_ISR_ENTER         13
+#define TRACE_EVT_ISR_EXIT          14
+// Fast mutexes, arg is a queue number, see TraceNameFastMutex()
+#define TRACE_EVT_MUTEX_TAKE        15
+#define TRACE_EVT_MUTEX_TAKE_FAILED 16
+#define TRACE_EVT_MUTEX_BLOCK       17
+#define TRACE_EVT_MUTEX_GIVE        18
+// Any mutex, arg is the task number of the holder
+#define TRACE_EVT_PRIORITY_INHERIT  19
+#define TRACE_EVT_PRIORITY_DISINHERIT 20
+
+// Interrupt ids for TRACE_ISR_ENTER() and TRACE_ISR_EXIT()
+#define TRACE_ISR_TICK  1
+#define TRACE_ISR_T2    2
+#define TRACE_ISR_U2RX  3
+#define TRACE_ISR_U2TX  4
+#define TRACE_ISR_RTCC  5
+#define TRACE_ISR_IOC   6
+
+typedef struct
+{
+    uint16_t time;
+    uint8_t type;
+    uint8_t arg;
+} TraceEvent_t;
+
+#if TRACE_ENABLE
+
+void TraceRecord(uint8_t type, uint8_t arg);
+
+// Remembers the name of a task or queue for the dump. Task names point into
+// the TCB, so tasks must not be deleted while the recorder is in use
+void TraceNameTask(uint8_t number, const char *name);
+void TraceNameQueue(void *queue, const char *name);
+// Fast mutexes are numbered and named along with the queues
+void TraceNameFastMutex(void *mutex, const char *name);
+
+// Stops recording, prints the buffer oldest first and starts again
+void TraceDump(void);
+
+#define TRACE_ISR_ENTER(id) TraceRecord(TRACE_EVT_ISR_ENTER, (id))
+#define TRACE_ISR_EXIT(id)  TraceRecord(TRACE_EVT_ISR_EXIT, (id))
+
+#else
+
+#define TRACE_ISR_ENTER(id)
+#define TRACE_ISR_EXIT(id)
+
+#endif
+
+#endif
@@ -6,10 +6,13 @@
  */
 
 
+#include "FreeRTOS.h"
 #include "uart.h"
+#include "console.h"
+#include "trace.h"
 
-uint8_t received_char = 0;
-uint8_t RXFlag = 0;
+// Received characters the console did not take, for the FSM
+RING_DEFINE(uartRxRing, UART_RX_RING_SIZE);
 
 void InitUART2(void) 
 {
@@ -55,6 +58,22 @@ void Disp2String(char *str) //Displays String of characters
     return;
 }
 
+void Disp2Dec(uint32_t val) //Displays an unsigned value in decimal
+{
+    // 4294967295 is the longest value, 10 digits plus the null
+    char buf[11];
+    uint8_t i = sizeof(buf) - 1;
+
+    buf[i] = '\0';
+    do
+    {
+        buf[--i] = (val % 10) + '0';
+        val /= 10;
+    } while (val != 0);
+
+    Disp2String(&buf[i]);
+}
+
 void XmitUART2(char CharNum, unsigned int repeatNo)
 {	
 	U2STAbits.UTXEN = 1;
@@ -87,14 +106,14 @@ void RecvUart(char* input, uint8_t buf_size)
 {	
     uint16_t i = 0;
     char last_char;
+    uint8_t received_char;
     // wait for enter key
     while (last_char != 0x0D) {
-        if (RXFlag == 1) {
+        if (RingGet(&uartRxRing, &received_char)) {
             // only store alphanumeric characters
             if (received_char >= 32 && received_char <= 126) {
                 if (i > buf_size-2) {
                     Disp2String("\ntoo long\n\r");
-                    RXFlag = 0;
                     return;
                 }
                 input[i] = received_char;
@@ -103,7 +122,6 @@ void RecvUart(char* input, uint8_t buf_size)
                 U2STAbits.OERR = 0;
             }
             last_char = received_char;
-            RXFlag = 0;
         }
         // wait for next character
         
@@ -127,14 +145,14 @@ void RecvUart(char* input, uint8_t buf_size)
 char RecvUartChar()
 {	
     char last_char;
+    uint8_t received_char;
     XmitUART2(' ',1);
     // wait for enter key
     while (last_char != 0x0D) {
-        if (RXFlag == 1) {
+        if (RingGet(&uartRxRing, &received_char)) {
             
             // return the last character received if you see ENTER
             if (received_char == 0x0D) {
-                RXFlag = 0;
                 return last_char;
             }
             
@@ -146,7 +164,6 @@ char RecvUartChar()
             }
            
             U2STAbits.OERR = 0;
-            RXFlag = 0;
         }
         
         // if (CNflag == 1) { // this allows breaking out of the busy wait if CN interrupts are enabled...
@@ -155,18 +172,35 @@ char RecvUartChar()
     }
 }
 
-void __attribute__ ((interrupt, no_auto_psv)) _U2RXInterrupt(void) {
+// The UART handlers run on the port's interrupt stack
+void U2RXInterruptHandler(void);
+void U2TXInterruptHandler(void);
+portDEFINE_ISR(_U2RXInterrupt, U2RXInterruptHandler);
+portDEFINE_ISR(_U2TXInterrupt, U2TXInterruptHandler);
+
+void U2RXInterruptHandler(void) {
+
+    TRACE_ISR_ENTER(TRACE_ISR_U2RX);
 
 	IFS1bits.U2RXIF = 0;
     
-    received_char = U2RXREG;
+    uint8_t received_char = U2RXREG;
     
-    RXFlag = 1;
+    // Console commands go to the console task, everything else to the FSM.
+    // A character that finds the ring full is dropped
+    if (!ConsoleRxChar(received_char))
+    {
+        (void) RingPut(&uartRxRing, received_char);
+    }
+
+    TRACE_ISR_EXIT(TRACE_ISR_U2RX);
     
 //    _LATB5 ^= 1;
 }
 
-void __attribute__ ((interrupt, no_auto_psv)) _U2TXInterrupt(void) {
+void U2TXInterruptHandler(void) {
+    TRACE_ISR_ENTER(TRACE_ISR_U2TX);
 	IFS1bits.U2TXIF = 0;
+    TRACE_ISR_EXIT(TRACE_ISR_U2TX);
 
 }
\ No newline at end of file
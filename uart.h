@@ -33,6 +33,7 @@
 
 #include <xc.h> // include processor files - each processor file is guarded.  
 #include "string.h"
+#include "ring.h"
 // TODO Insert appropriate #include <>
 
 // TODO Insert C++ class definitions if appropriate
@@ -65,10 +66,16 @@
 
 void InitUART2(void);
 void Disp2String(char *str);
+void Disp2Dec(uint32_t val);
 void XmitUART2(char CharNum, unsigned int repeatNo);
 void RecvUart(char* input, uint8_t buf_size);
 char RecvUartChar(void);
 
+// Characters from the receive interrupt that are not console commands. The
+// interrupt is the only producer, and only one task reads at a time
+#define UART_RX_RING_SIZE 16
+extern Ring_t uartRxRing;
+
 #ifdef	__cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -0,0 +1,131 @@
+/*
+ * File:   wheel.c
+ *
+ * Hashed timing wheel, see wheel.h. Each slot is a doubly linked list so a
+ * timer can be taken off from anywhere in it.
+ */
+
+#include <stddef.h>
+#include "wheel.h"
+
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+
+#define WHEEL_SLOT_OF(ticks) ((ticks) >> WHEEL_SHIFT)
+// Slot numbers only have 32 - WHEEL_SHIFT bits, shifted back up so the
+// difference wraps with the tick count
+#define WHEEL_SLOT_DIFF(a, b) ((int32_t)(((a) - (b)) << WHEEL_SHIFT))
+
+void WheelInit(Wheel_t *wheel, uint32_t now)
+{
+    uint8_t i;
+
+    for (i = 0; i < WHEEL_SLOTS; i++)
+    {
+        wheel->slots[i] = NULL;
+    }
+    wheel->cursor = WHEEL_SLOT_OF(now);
+    wheel->count = 0;
+}
+
+void WheelInsert(Wheel_t *wheel, WheelTimer_t *timer, uint32_t deadline)
+{
+    uint32_t slot = WHEEL_SLOT_OF(deadline);
+
+    // A deadline already behind the cursor goes in the cursor's slot, the
+    // next expiry picks it up
+    if (WHEEL_SLOT_DIFF(slot, wheel->cursor) < 0)
+    {
+        slot = wheel->cursor;
+    }
+
+    timer->deadline = deadline;
+    timer->slot = (uint8_t)(slot & WHEEL_MASK);
+    timer->prev = NULL;
+    timer->next = wheel->slots[timer->slot];
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer;
+    }
+    wheel->slots[timer->slot] = timer;
+    wheel->count++;
+}
+
+void WheelRemove(Wheel_t *wheel, WheelTimer_t *timer)
+{
+    if (timer->prev != NULL)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        wheel->slots[timer->slot] = timer->next;
+    }
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer->prev;
+    }
+    wheel->count--;
+}
+
+WheelTimer_t *WheelExpire(Wheel_t *wheel, uint32_t now)
+{
+    uint32_t nowSlot = WHEEL_SLOT_OF(now);
+    WheelTimer_t *timer;
+
+    for (;;)
+    {
+        for (timer = wheel->slots[wheel->cursor & WHEEL_MASK]; timer != NULL; timer = timer->next)
+        {
+            if ((int32_t)(timer->deadline - now) <= 0)
+            {
+                WheelRemove(wheel, timer);
+                return timer;
+            }
+        }
+
+        // The slot is done with once time has moved past it, timers still
+        // in it are for a later turn
+        if (WHEEL_SLOT_DIFF(nowSlot, wheel->cursor) <= 0)
+        {
+            return NULL;
+        }
+        wheel->cursor++;
+    }
+}
+
+uint8_t WheelNextDeadline(const Wheel_t *wheel, uint32_t *deadline)
+{
+    uint32_t slot;
+    uint8_t i;
+    uint8_t found = 0;
+    const WheelTimer_t *timer;
+
+    if (wheel->count == 0)
+    {
+        return 0;
+    }
+
+    // The first slot with a timer due on this turn holds the earliest
+    // deadline, any timer behind the cursor counts as due in its slot
+    for (i = 0; i < WHEEL_SLOTS; i++)
+    {
+        slot = wheel->cursor + i;
+        for (timer = wheel->slots[slot & WHEEL_MASK]; timer != NULL; timer = timer->next)
+        {
+            if (WHEEL_SLOT_DIFF(WHEEL_SLOT_OF(timer->deadline), slot) <= 0 &&
+                (!found || (int32_t)(timer->deadline - *deadline) < 0))
+            {
+                *deadline = timer->deadline;
+                found = 1;
+            }
+        }
+
+        if (found)
+        {
+            return 1;
+        }
+    }
+
+    *deadline = (wheel->cursor + WHEEL_SLOTS) << WHEEL_SHIFT;
+    return 1;
+}
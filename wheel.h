@@ -0,0 +1,55 @@
+/*
+ * File:   wheel.h
+ *
+ * Hashed timing wheel. Timers hang off one of WHEEL_SLOTS slots picked by
+ * their deadline, each slot covering 2^WHEEL_SHIFT ticks, so adding and
+ * removing a timer is O(1) however many are running. A slot holds every
+ * timer whose deadline falls in it on any turn of the wheel, the ones due
+ * on a later turn are passed over until then.
+ *
+ * Times are 32-bit tick counts, compared modulo 2^32. The wheel is not
+ * locked, only the task that owns it may touch it.
+ */
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+#include <stdint.h>
+
+#define WHEEL_SLOTS     64
+#define WHEEL_SHIFT     9
+
+// One turn of the wheel in ticks, under the 16-bit tick wrap so a task that
+// sleeps at most one turn can still widen the tick count
+#define WHEEL_TURN_TICKS ((uint32_t) WHEEL_SLOTS << WHEEL_SHIFT)
+
+typedef struct WheelTimer
+{
+    struct WheelTimer *next;
+    struct WheelTimer *prev;
+    uint32_t deadline;
+    uint8_t slot;
+} WheelTimer_t;
+
+typedef struct
+{
+    WheelTimer_t *slots[WHEEL_SLOTS];
+    // Slot number (tick >> WHEEL_SHIFT) expiry has got up to, everything due
+    // in earlier slots has been taken off
+    uint32_t cursor;
+    uint16_t count;
+} Wheel_t;
+
+void WheelInit(Wheel_t *wheel, uint32_t now);
+void WheelInsert(Wheel_t *wheel, WheelTimer_t *timer, uint32_t deadline);
+void WheelRemove(Wheel_t *wheel, WheelTimer_t *timer);
+
+// Takes one timer that is due by now off the wheel and returns it, NULL once
+// there are none left
+WheelTimer_t *WheelExpire(Wheel_t *wheel, uint32_t now);
+
+// Earliest deadline due within one turn from the cursor, or the end of that
+// turn if every timer is further away. Returns 0 if the wheel is empty
+uint8_t WheelNextDeadline(const Wheel_t *wheel, uint32_t *deadline);
+
+#endif